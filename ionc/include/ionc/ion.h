@@ -35,5 +35,6 @@
 #include "ion_catalog.h"
 #include "ion_debug.h"
 #include "ion_version.h"
+#include "ion_allocation.h"
 
 #endif
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2009-2016 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#ifndef ION_ALLOCATION_H_
+#define ION_ALLOCATION_H_
+
+#include "ion_types.h"
+#include "ion_platform_config.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A memory allocator. Every allocation made by the library goes through one of these: the default allocator (see
+ * `ion_allocator_set_default`), or the allocator given in a reader's or writer's options, which then serves all of
+ * that reader's or writer's memory, including the stream it opens for its input or output. The allocator must remain
+ * valid until every object that uses it is closed.
+ */
+typedef struct _ion_allocator
+{
+    /** Allocates `size` bytes aligned for any type, or returns NULL on failure.
+     *
+     */
+    void *(*alloc)(void *context, size_t size);
+
+    /** Releases memory returned by `alloc` or `realloc`.
+     *
+     */
+    void  (*free)(void *context, void *ptr);
+
+    /** Optional. Resizes memory returned by `alloc`, preserving its contents, or returns NULL on failure. When NULL,
+     *  the library allocates, copies, and frees instead.
+     *
+     */
+    void *(*realloc)(void *context, void *ptr, size_t size);
+
+    /** Passed to each of the functions above.
+     *
+     */
+    void  *context;
+
+} ION_ALLOCATOR;
+
+/**
+ * Replaces the default allocator, which is used by objects opened without an allocator of their own. NULL restores
+ * the system allocator (malloc and free). Objects capture their allocator when they are opened, but values allocated
+ * outside of any owner (e.g. an ION_INT or ION_DECIMAL initialized without one) are freed through whatever is the
+ * default at the time, so change the default only while no such values are live.
+ */
+ION_API_EXPORT iERR ion_allocator_set_default(ION_ALLOCATOR *allocator);
+ION_API_EXPORT iERR ion_allocator_get_default(ION_ALLOCATOR **p_allocator);
+
+/**
+ * Every reader, writer, catalog, and symbol table allocates its memory from a chain of blocks. Standard-size blocks
+ * from the system allocator are recycled through a pool instead of being returned to the system: each thread may keep
+ * a small cache of them, and blocks released beyond that cache go to a lock-free list shared by all threads, up to a
+ * high-water mark.
+ */
+typedef struct _ion_block_pool_options
+{
+    /** The most standard-size blocks each thread keeps cached for reuse. Zero, the default, disables the per-thread
+     *  caches. A thread's cache is not released when the thread exits, so programs that enable the caches should
+     *  call `ion_block_pool_trim` from each thread before it exits.
+     *
+     */
+    SIZE thread_cache_max_blocks;
+
+    /** The high-water mark for the list shared by all threads. Blocks released while the list is at this size are
+     *  returned to the system. Zero disables the shared list.
+     *
+     */
+    SIZE shared_max_blocks;
+
+} ION_BLOCK_POOL_OPTIONS;
+
+/**
+ * Replaces the block pool's limits. Intended to be called during startup, before readers or writers are in use on
+ * other threads. Lowering a limit does not release blocks that are already pooled; use `ion_block_pool_trim`.
+ */
+ION_API_EXPORT iERR ion_block_pool_set_options(ION_BLOCK_POOL_OPTIONS *p_options);
+ION_API_EXPORT iERR ion_block_pool_get_options(ION_BLOCK_POOL_OPTIONS *p_options);
+
+/**
+ * Returns the calling thread's cached blocks and all blocks on the shared list to the system. When the per-thread
+ * caches are enabled, threads that use Ion should call this before exiting, since their caches are not otherwise
+ * released.
+ */
+ION_API_EXPORT iERR ion_block_pool_trim(void);
+
+/**
+ * A position in an owner's memory, see `ion_alloc_mark`. The fields are private to the library.
+ */
+typedef struct _ion_alloc_mark
+{
+    hOWNER  _owner;
+    BYTE   *_owner_position;
+    void   *_head;
+    BYTE   *_head_position;
+    void   *_head_next;
+
+} ION_ALLOC_MARK;
+
+/**
+ * Records the current end of the owner's allocations. A later `ion_alloc_rewind` to the mark releases everything
+ * allocated from the owner since, in time proportional to the number of blocks added, without freeing the owner.
+ * This suits temporary memory that lives for one top-level value: e.g. a symbol table's owner can be marked before
+ * values are read and rewound after each one.
+ */
+ION_API_EXPORT iERR ion_alloc_mark(hOWNER owner, ION_ALLOC_MARK *p_mark);
+
+/**
+ * Releases everything allocated from the owner since the mark was taken. Memory allocated before the mark is
+ * untouched. Marks taken after this one are invalidated; the mark itself may be rewound to again.
+ */
+ION_API_EXPORT iERR ion_alloc_rewind(hOWNER owner, ION_ALLOC_MARK *p_mark);
+
+/**
+ * Memory held by one owner: a reader, writer, catalog, or symbol table, or an owner returned by `ion_alloc_owner`.
+ */
+typedef struct _ion_memory_stats
+{
+    /** Bytes in all of the owner's blocks, including their headers.
+     *
+     */
+    int64_t bytes_reserved;
+
+    /** Bytes handed out from those blocks, including alignment padding.
+     *
+     */
+    int64_t bytes_used;
+
+    /** The number of blocks in the owner's chain.
+     *
+     */
+    int64_t block_count;
+
+    /** The number of those blocks that are larger than the standard block size, i.e. were allocated for a single
+     *  large request and will not be recycled through the block pool.
+     *
+     */
+    int64_t oversized_block_count;
+
+    /** The most bytes the owner has reserved at once.
+     *
+     */
+    int64_t high_water;
+
+} ION_MEMORY_STATS;
+
+/**
+ * Memory held by all live owners in the process. Blocks waiting in the block pool are not included in the byte and
+ * block counts.
+ */
+typedef struct _ion_memory_totals
+{
+    int64_t bytes_reserved;
+    int64_t block_count;
+    int64_t oversized_block_count;
+
+    /** The most bytes reserved at once since the process started.
+     *
+     */
+    int64_t high_water;
+
+    /** The approximate number of blocks on the block pool's shared list. Blocks in per-thread caches are not counted.
+     *
+     */
+    int64_t pooled_block_count;
+
+} ION_MEMORY_TOTALS;
+
+/**
+ * Retrieves the memory held by the given owner. A catalog or symbol table opened without an owner is its own owner.
+ * See also `ion_reader_get_memory_stats` and `ion_writer_get_memory_stats`, which include the other pools a reader
+ * or writer allocates from.
+ */
+ION_API_EXPORT iERR ion_owner_get_memory_stats(hOWNER owner, ION_MEMORY_STATS *p_stats);
+
+/**
+ * Retrieves the memory held by all live owners in the process. The counts are maintained atomically, but are read
+ * individually, so they may be mutually inconsistent while other threads are allocating.
+ */
+ION_API_EXPORT iERR ion_memory_get_totals(ION_MEMORY_TOTALS *p_totals);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -46,6 +46,26 @@ ION_API_EXPORT iERR ion_catalog_find_symbol_table         (hCATALOG hcatalog, iS
 ION_API_EXPORT iERR ion_catalog_find_best_match           (hCATALOG hcatalog, iSTRING name, long version, hSYMTAB *p_symtab); // or newest version of a symtab pass in version == 0
 ION_API_EXPORT iERR ion_catalog_release_symbol_table      (hCATALOG hcatalog, hSYMTAB symtab);
 
+/**
+ * Freezes the catalog: locks every symbol table it holds and makes the catalog itself immutable. Adding or releasing
+ * symbol tables afterward fails with IERR_IS_IMMUTABLE. A frozen catalog may be used by any number of readers and
+ * writers at once, on any number of threads, without synchronization. Readers and writers that import its symbol
+ * tables reference them instead of copying them, so the catalog must stay open until they are closed.
+ * @param hcatalog - The catalog to freeze. Freezing a frozen catalog does nothing.
+ */
+ION_API_EXPORT iERR ion_catalog_freeze                    (hCATALOG hcatalog);
+ION_API_EXPORT iERR ion_catalog_is_frozen                 (hCATALOG hcatalog, BOOL *p_is_frozen);
+
+/**
+ * Allocates a new, unfrozen catalog with itself as its memory owner, holding the same symbol tables as the given
+ * frozen catalog. The tables are shared, not copied. This is the way to extend a frozen catalog: add to the new one,
+ * freeze it, and publish it to the threads using the old one (e.g. with an atomic pointer swap). The old catalog must
+ * stay open until both the new one and every reader and writer still using the old one are closed.
+ * @param p_hcatalog - Pointer to a handle to the newly-allocated catalog. Must be freed using `ion_catalog_close`.
+ * @param hfrozen - The frozen catalog to start from.
+ */
+ION_API_EXPORT iERR ion_catalog_open_from_frozen          (hCATALOG *p_hcatalog, hCATALOG hfrozen);
+
 /**
  * If the given catalog is its own memory owner, its memory and everything it owns is freed. If the given catalog has an
  * external owner and that owner has not been freed, this does nothing; this catalog will be freed when its memory owner
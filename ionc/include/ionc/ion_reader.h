@@ -21,6 +21,7 @@
 #define ION_READER_H_
 #include "ion_types.h"
 #include "ion_stream.h"
+#include "ion_allocation.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -59,6 +60,7 @@ typedef struct _ion_reader_context_change_notifier {
  * #define DEFAULT_WRITER_STACK_DEPTH       10
  * #define DEFAULT_CHUNK_THRESHOLD     DEFAULT_BLOCK_SIZE
  * #define DEFAULT_SYMBOL_THRESHOLD        512
+ * #define DEFAULT_SYMBOL_TABLE_CACHE_SIZE   8
  *
  * Some field also has a range limit:
  * #define MIN_ANNOTATION_LIMIT              1
@@ -149,6 +151,18 @@ typedef struct _ion_reader_options
      */
     ION_READER_CONTEXT_CHANGE_NOTIFIER context_change_notifier;
 
+    /** The number of distinct local symbol tables the reader keeps after building them, so that a repeat of one later
+     *  in the stream (e.g. at the head of each chunk of concatenated data) is reused instead of rebuilt. Only tables
+     *  whose imports are all found, at their exact versions, in the catalog are kept. A symbol table handle from
+     *  `ion_reader_get_symbol_table` remains valid until its table is evicted. Defaults to 8; negative disables the cache.
+     */
+    SIZE symbol_table_cache_size;
+
+    /** The allocator for all of the reader's memory, including the stream it opens over a buffer or input handler.
+     *  If NULL, the default allocator is used (see `ion_allocator_set_default`).
+     */
+    ION_ALLOCATOR *allocator;
+
 } ION_READER_OPTIONS;
 
 //
@@ -267,11 +281,33 @@ ION_API_EXPORT iERR ion_reader_reset_stream_with_length(hREADER *p_hreader
                                                        ,ION_STREAM_HANDLER fn_input_handler
                                                        ,POSITION length);
 
+/** Rebinds the reader to a new input buffer, as if it had been closed and reopened on it with the same options.
+ *
+ * The reader starts over at the top level in the system symbol table context. Its allocations are kept: the
+ * field name, annotation and value buffers, the container stacks, the catalog, and the cache of previously seen
+ * local symbol tables (see symbol_table_cache_size in ION_READER_OPTIONS), so a reader reset onto a stream of
+ * similar messages allocates nothing after the first few. The input may be text or binary regardless of what the
+ * previous input was. Values, symbol tables and strings obtained from the previous input are no longer valid.
+ *
+ * @param   hreader     Reader to reset.
+ * @param   buffer      The new input, which must remain valid until the reader is reset again or closed.
+ * @param   buf_length  The number of bytes of input in buffer.
+ * @return  IERR_OK if succeeded
+ */
+ION_API_EXPORT iERR ion_reader_reset_buffer            (hREADER hreader, BYTE *buffer, SIZE buf_length);
+
 ION_API_EXPORT iERR ion_reader_open                    (hREADER *p_hreader
                                                        ,ION_STREAM *p_stream
                                                        ,ION_READER_OPTIONS *p_options);
 ION_API_EXPORT iERR ion_reader_get_catalog             (hREADER hreader, hCATALOG *p_hcatalog);
 
+/**
+ * Retrieves the memory held by the reader, summed over all of its pools: the reader itself, its current and cached
+ * local symbol tables, the value currently being read, and its input stream if the reader opened it. The
+ * high_water is the sum of each pool's own high-water mark.
+ */
+ION_API_EXPORT iERR ion_reader_get_memory_stats        (hREADER hreader, ION_MEMORY_STATS *p_stats);
+
 /** moves the stream position to the specified offset. Resets the 
  *  the state of the reader to be at the top level. As long as the
  *  specified position is at the first byte of a top-level value
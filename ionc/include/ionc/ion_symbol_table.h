@@ -37,6 +37,8 @@ struct _ion_symbol
     ION_SYMBOL_IMPORT_LOCATION  import_location;
     // TODO this is only needed for symbol usage metrics. Consider removal.
     int32_t           add_count;
+    // hash of value, cached by the symbol table that indexes this symbol. 0 until computed.
+    uint32_t          hash;
 };
 
 typedef enum _ION_SYMBOL_TABLE_TYPE {
@@ -248,14 +250,17 @@ ION_API_EXPORT iERR ion_symbol_table_open_with_type     (hSYMTAB *p_hsymtab, hOW
 
 /**
  * Clones the given symbol table, using that symbol table's memory owner as the owner of the newly allocated symbol
- * table.
+ * table. If the given table is locked, the clone shares its symbols and indices, and only copies them if the clone
+ * itself is modified.
  * @param hsymtab - They symbol table to clone.
  * @param p_hclone - Pointer to a handle to the newly-allocated symbol table clone.
  */
 ION_API_EXPORT iERR ion_symbol_table_clone              (hSYMTAB hsymtab, hSYMTAB *p_hclone);
 
 /**
- * Clones the given symbol table, using the given owner as the newly-allocated symbol table's memory owner.
+ * Clones the given symbol table, using the given owner as the newly-allocated symbol table's memory owner. If the given
+ * table is frozen (see `ion_catalog_freeze`), or is locked and has the same owner, the clone shares its symbols and
+ * indices, and only copies them if the clone itself is modified.
  * @param hsymtab - They symbol table to clone.
  * @param p_hclone - Pointer to a handle to the newly-allocated symbol table clone.
  * @param owner - Handle to the new symbol table's memory owner. If NULL, the resulting symbol table is its own memory
@@ -286,6 +291,29 @@ ION_API_EXPORT iERR ion_symbol_table_load               (hREADER hreader, hOWNER
  */
 ION_API_EXPORT iERR ion_symbol_table_unload             (hSYMTAB hsymtab, hWRITER hwriter);
 
+/**
+ * Writes a precompiled image of a locked shared symbol table: a compact, position independent form that
+ * `ion_symbol_table_open_image` can use in place (e.g. from a memory-mapped file) much faster than `ion_symbol_table_load`
+ * can parse the equivalent Ion. Images are only readable on machines with the same byte order.
+ * @param hsymtab - The locked shared symbol table.
+ * @param buffer - The destination, which must be 4 byte aligned. If NULL, only the image length is returned.
+ * @param buffer_length - The length of buffer, in bytes.
+ * @param p_image_length - Pointer to the image length, in bytes.
+ */
+ION_API_EXPORT iERR ion_symbol_table_write_image        (hSYMTAB hsymtab, BYTE *buffer, SIZE buffer_length, SIZE *p_image_length);
+
+/**
+ * Opens a shared symbol table from an image written by `ion_symbol_table_write_image`. The symbol text is not copied,
+ * so the image must not change and must outlive the table and every reader, writer, and catalog that uses it. The
+ * table is frozen (see `ion_catalog_freeze`), so it can be shared between threads and imported without being copied.
+ * @param image - The image, which must be 4 byte aligned (memory-mapped files always are).
+ * @param image_length - The length of the image, in bytes.
+ * @param owner - Handle to the new symbol table's memory owner. If NULL, the resulting symbol table is its own memory
+ *  owner and must be freed using `ion_symbol_table_close`.
+ * @param p_hsymtab - Pointer to a handle to the newly-allocated symbol table.
+ */
+ION_API_EXPORT iERR ion_symbol_table_open_image         (BYTE *image, SIZE image_length, hOWNER owner, hSYMTAB *p_hsymtab);
+
 ION_API_EXPORT iERR ion_symbol_table_lock               (hSYMTAB hsymtab);
 ION_API_EXPORT iERR ion_symbol_table_is_locked          (hSYMTAB hsymtab, BOOL *p_is_locked);
 ION_API_EXPORT iERR ion_symbol_table_get_type           (hSYMTAB hsymtab, ION_SYMBOL_TABLE_TYPE *p_type);
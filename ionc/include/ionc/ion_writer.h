@@ -19,6 +19,8 @@
 
 #include "ion_types.h"
 #include "ion_platform_config.h"
+#include "ion_allocation.h"
+#include "ion_string.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -120,8 +122,59 @@ typedef struct _ion_writer_options
      */
     BOOL json_downconvert;
 
+    /** The maximum number of local symbols a binary writer will accumulate in one local symbol table context. When
+     *  a value that exceeds this limit is completed at the top level, the writer flushes and begins a fresh local
+     *  symbol table (without an Ion Version Marker) before the next top-level value. Zero means unlimited.
+     *
+     */
+    SIZE max_local_symbol_count;
+
+    /** The maximum number of bytes of local symbol text a binary writer will accumulate in one local symbol table
+     *  context before beginning a fresh one, as with `max_local_symbol_count`. Zero means unlimited.
+     *
+     */
+    SIZE max_local_symbol_bytes;
+
+    /** The allocator for all of the writer's memory, including the stream it opens over a buffer or output handler.
+     *  If NULL, the default allocator is used (see `ion_allocator_set_default`).
+     */
+    ION_ALLOCATOR *allocator;
+
+    /** When non-zero, the binary writer writes the header of each container, annotation wrapper, and lob in place
+     *  with a length field of this many bytes (at most 4), then fills in the length when the value ends. Values are
+     *  then written once into the writer's buffer and copied to the output as-is, rather than being reassembled around
+     *  separately-kept headers on flush. A length too large for the field is widened by moving the value's contents;
+     *  a smaller one is padded, which is valid Ion but slightly larger than the minimal lengths written by default.
+     *
+     */
+    SIZE binary_reserved_length_size;
+
+    /** When non-zero, once the binary writer holds at least this many bytes of unflushed values it moves them to a
+     *  temporary file (see tmpfile) and writes the rest there until the next flush, so a very large top-level value
+     *  needs no more memory than a few stream pages for its contents. The bookkeeping for each container, annotation
+     *  wrapper, and lob still stays in memory until the flush; with `binary_reserved_length_size` it is released as
+     *  each one ends, leaving memory bounded by the nesting depth. A value too long for its reserved length (at
+     *  most 2^28 - 1 bytes with 4 bytes reserved) is widened by moving its contents up within the file a few
+     *  kilobytes at a time, which costs I/O proportional to its size but no more memory.
+     *
+     */
+    SIZE binary_spill_threshold;
+
 } ION_WRITER_OPTIONS;
 
+/**
+ * A field name or annotation prepared for repeated use with one writer, see `ion_writer_prepare_symbol`. The fields
+ * are private to the library.
+ */
+typedef struct _ion_prepared_symbol
+{
+    ION_STRING  _text;
+    SID         _sid;
+    void       *_writer;
+    int64_t     _context;
+
+} ION_PREPARED_SYMBOL;
+
 
 /**
  * Initializes the options' imports list. This must be done before calling `ion_writer_options_add_*`.
@@ -198,6 +251,21 @@ ION_API_EXPORT iERR ion_writer_get_catalog          (hWRITER hwriter, hCATALOG *
 ION_API_EXPORT iERR ion_writer_set_symbol_table     (hWRITER hwriter, hSYMTAB     hsymtab);
 ION_API_EXPORT iERR ion_writer_get_symbol_table     (hWRITER hwriter, hSYMTAB  *p_hsymtab);
 
+/**
+ * Retrieves the number of local symbols the writer has added over its lifetime and the number of times it has
+ * started a fresh local symbol table because `max_local_symbol_count` or `max_local_symbol_bytes` was exceeded.
+ * Either output may be NULL. A rotation frees the previous local symbol table, so handles to it obtained from
+ * `ion_writer_get_symbol_table` are no longer valid afterward.
+ */
+ION_API_EXPORT iERR ion_writer_get_local_symbol_stats(hWRITER hwriter, int64_t *p_symbols_added, int64_t *p_rotations);
+
+/**
+ * Retrieves the memory held by the writer, summed over all of its pools: the writer itself, the symbol tables and
+ * values buffered since the last flush, and its output stream if the writer opened it. The high_water is the sum of
+ * each pool's own high-water mark.
+ */
+ION_API_EXPORT iERR ion_writer_get_memory_stats(hWRITER hwriter, ION_MEMORY_STATS *p_stats);
+
 /**
  * Adds the given list of imports to the writer's list of imports. These imports will only be used in the writer's
  * current symbol table context. To configure the writer to use the same list of imports for each new symbol table
@@ -236,6 +304,18 @@ ION_API_EXPORT iERR ion_writer_clear_field_name     (hWRITER hwriter);
 ION_API_EXPORT iERR ion_writer_add_annotation       (hWRITER hwriter, iSTRING annotation);
 
 ION_API_EXPORT iERR ion_writer_add_annotation_symbol(hWRITER hwriter, ION_SYMBOL *annotation);
+
+/**
+ * Prepares `name` to be written repeatedly as a field name or annotation by this writer. A binary writer resolves
+ * the name's symbol ID once per symbol table context: while the context is unchanged, writing the prepared symbol
+ * sets the symbol ID directly, with no lookup of the text. After the context changes (e.g. on `ion_writer_finish`
+ * or when `max_local_symbol_count` starts a fresh one) the next use resolves it again. A text writer writes the text.
+ * The text is not copied; it is the caller's responsibility to keep it in scope as long as the prepared symbol is
+ * used. A prepared symbol may only be used with the writer that prepared it.
+ */
+ION_API_EXPORT iERR ion_writer_prepare_symbol       (hWRITER hwriter, iSTRING name, ION_PREPARED_SYMBOL *p_symbol);
+ION_API_EXPORT iERR ion_writer_write_field_name_prepared(hWRITER hwriter, ION_PREPARED_SYMBOL *field_name);
+ION_API_EXPORT iERR ion_writer_add_annotation_prepared(hWRITER hwriter, ION_PREPARED_SYMBOL *annotation);
 ION_API_EXPORT iERR ion_writer_write_annotations    (hWRITER hwriter, iSTRING p_annotations, SIZE count);
 ION_API_EXPORT iERR ion_writer_write_annotation_symbols(hWRITER hwriter, ION_SYMBOL *annotations, SIZE count);
 ION_API_EXPORT iERR ion_writer_clear_annotations    (hWRITER hwriter);
@@ -288,6 +368,21 @@ ION_API_EXPORT iERR ion_writer_flush                (hWRITER hwriter, SIZE *p_by
  */
 ION_API_EXPORT iERR ion_writer_finish               (hWRITER hwriter, SIZE *p_bytes_flushed);
 
+/**
+ * Flushes pending bytes to the current output, then directs the writer to new output, which is cheaper than closing
+ * the writer and opening another: the writer's temp buffer, container stacks, and buffered value pages are reused.
+ * If the writer opened its current output itself, that stream is closed (or, for ion_writer_reset_buffer, pointed
+ * at the new buffer). Raises an error if any value is in progress or any annotations are pending.
+ *
+ * Unless keep_symbol_table is TRUE, the new output starts a new symbol table context, as after `ion_writer_finish`.
+ * If it is TRUE, the new output continues the current context: no Ion Version Marker is written, and a binary writer
+ * writes only an append of the local symbols added since the context was last written. That output can then only be
+ * read by a reader that has already read the previous output, as when each output is a message in a session whose
+ * receiver keeps its symbol table context.
+ */
+ION_API_EXPORT iERR ion_writer_reset                (hWRITER hwriter, ION_STREAM *stream, BOOL keep_symbol_table);
+ION_API_EXPORT iERR ion_writer_reset_buffer         (hWRITER hwriter, BYTE *buffer, SIZE buf_length, BOOL keep_symbol_table);
+
 /**
  * Finishes the writer, frees the writer's associated resources, and finally frees the writer itself. The writer may
  * not continue writing to the stream after this function is called. If any value is in-progress, closing any writer
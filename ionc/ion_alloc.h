@@ -17,6 +17,7 @@
 
 #include <ionc/ion_types.h>
 #include <ionc/ion_platform_config.h>
+#include <ionc/ion_allocation.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -62,18 +63,26 @@ ION_API_EXPORT void        ion_alloc_free      (void *ptr);
     void *debug_malloc(size_t size, const char *file, int line);
     void  debug_free(const void *ptr, const char *file, int line);
 
-    #define ion_xalloc(x) debug_malloc((x), __FILE__, __LINE__)
-    #define ion_xfree(x)  debug_free((x), __FILE__, __LINE__)
-
 #else
 
     #include <stdlib.h>
 
-    #define ion_xalloc(sz)  malloc(sz)
-    #define ion_xfree(ptr)  free(ptr)
-
 #endif
 
+// every raw allocation goes through an ION_ALLOCATOR, a NULL allocator
+// selects the current default. the system allocator wraps malloc and
+// free (or their MEM_DEBUG replacements).
+extern ION_ALLOCATOR _ion_allocator_system;
+
+ION_ALLOCATOR *_ion_allocator_resolve(ION_ALLOCATOR *allocator);
+void          *_ion_xalloc           (ION_ALLOCATOR *allocator, size_t size);
+void           _ion_xfree            (ION_ALLOCATOR *allocator, void *ptr);
+void          *_ion_xrealloc         (ION_ALLOCATOR *allocator, void *ptr, size_t old_size, size_t new_size);
+
+#define ion_xalloc(sz)                      _ion_xalloc(NULL, (sz))
+#define ion_xfree(ptr)                      _ion_xfree(NULL, (ptr))
+#define ion_xrealloc(ptr, old_sz, new_sz)   _ion_xrealloc(NULL, (ptr), (old_sz), (new_sz))
+
 //#ifndef ION_ALLOCATION_BLOCK_SIZE
 //#define ION_ALLOCATION_BLOCK_SIZE DEFAULT_BLOCK_SIZE
 //#endif
@@ -99,6 +108,36 @@ ION_API_EXPORT void        ion_alloc_free      (void *ptr);
 #define ALIGN_SIZE(size) ((((size_t)(size)) + ALIGN_MASK) & ~ALIGN_MASK)
 #define ALIGN_PTR(ptr) ALIGN_SIZE(ptr)
 
+// the block pool's defaults, see ION_BLOCK_POOL_OPTIONS. the thread caches are
+// opt-in, since nothing releases a thread's cache when the thread exits
+#ifndef ION_BLOCK_POOL_THREAD_CACHE_DEFAULT
+#define ION_BLOCK_POOL_THREAD_CACHE_DEFAULT 0
+#endif
+#ifndef ION_BLOCK_POOL_SHARED_DEFAULT
+#define ION_BLOCK_POOL_SHARED_DEFAULT 16
+#endif
+
+// atomic primitives for the block pool's shared list and the process-wide
+// memory totals, these are full barriers
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define ION_ATOMIC_CAS_PTR(dst, expected, desired) \
+    (_InterlockedCompareExchangePointer((void * volatile *)(dst), (void *)(desired), (void *)(expected)) == (void *)(expected))
+#define ION_ATOMIC_EXCHANGE_PTR(dst, value)  _InterlockedExchangePointer((void * volatile *)(dst), (void *)(value))
+#define ION_ATOMIC_ADD(dst, value)           _InterlockedExchangeAdd((volatile long *)(dst), (long)(value))
+#define ION_ATOMIC_ADD64(dst, value)         _InterlockedExchangeAdd64((volatile __int64 *)(dst), (__int64)(value))
+#define ION_ATOMIC_CAS64(dst, expected, desired) \
+    (_InterlockedCompareExchange64((volatile __int64 *)(dst), (__int64)(desired), (__int64)(expected)) == (__int64)(expected))
+#elif defined(__GNUC__)
+#define ION_ATOMIC_CAS_PTR(dst, expected, desired) __sync_bool_compare_and_swap((dst), (expected), (desired))
+#define ION_ATOMIC_EXCHANGE_PTR(dst, value)  __atomic_exchange_n((dst), (value), __ATOMIC_SEQ_CST)
+#define ION_ATOMIC_ADD(dst, value)           __sync_fetch_and_add((dst), (value))
+#define ION_ATOMIC_ADD64(dst, value)         __sync_fetch_and_add((dst), (int64_t)(value))
+#define ION_ATOMIC_CAS64(dst, expected, desired) __sync_bool_compare_and_swap((dst), (expected), (desired))
+#else
+#error "Compiler does not support atomic operations"
+#endif
+
 typedef struct _ion_allocation_chain ION_ALLOCATION_CHAIN;
 
 struct _ion_allocation_chain 
@@ -106,6 +145,9 @@ struct _ion_allocation_chain
     SIZE                  size;
     ION_ALLOCATION_CHAIN *next;
     ION_ALLOCATION_CHAIN *head;
+    ION_ALLOCATOR        *allocator;    // where this block came from and goes back to
+    int64_t               reserved;     // owner block only: bytes in all of the owner's blocks
+    int64_t               high_water;   // owner block only: the most reserved has been
 
     BYTE                 *position;
     BYTE                 *limit;
@@ -120,11 +162,15 @@ struct _ion_allocation_chain
 typedef struct _ion_allocation_chain DBG_ION_ALLOCATION_CHAIN;
 
 #define ion_alloc_owner(len)                _dbg_ion_alloc_owner(len, __FILE__, __LINE__)
+#define ion_alloc_owner_with_allocator(len, allocator) \
+                                            _dbg_ion_alloc_owner_with_allocator(len, allocator, __FILE__, __LINE__)
 #define ion_alloc_with_owner(owner, length) _dbg_ion_alloc_with_owner(owner, length, __FILE__, __LINE__)
 #define ion_free_owner(owner)               _dbg_ion_free_owner(owner, __FILE__, __LINE__)
 #define ion_strdup(owner, dst, src)         _dbg_ion_strdup(owner, dst, src, __FILE__, __LINE__)
 #else
 #define ion_alloc_owner(len)                _ion_alloc_owner(len) 
+#define ion_alloc_owner_with_allocator(len, allocator) \
+                                            _ion_alloc_owner_with_allocator(len, allocator)
 #define ion_alloc_with_owner(owner, length) _ion_alloc_with_owner(owner, length)
 #define ion_free_owner(owner)               _ion_free_owner(owner)
 #define ion_strdup(owner, dst, src)         _ion_strdup(owner, dst, src)
@@ -133,6 +179,10 @@ typedef struct _ion_allocation_chain DBG_ION_ALLOCATION_CHAIN;
 
 
 void *_ion_alloc_owner     (SIZE len);
+void *_ion_alloc_owner_with_allocator(SIZE len, ION_ALLOCATOR *allocator);
+void  _ion_alloc_owner_add_stats(hOWNER owner, ION_MEMORY_STATS *p_stats);
+void  _ion_alloc_mark(hOWNER owner, ION_ALLOC_MARK *p_mark);
+void  _ion_alloc_rewind(hOWNER owner, ION_ALLOC_MARK *p_mark);
 void *_ion_alloc_with_owner(hOWNER owner, SIZE length);
 void  _ion_free_owner      (hOWNER owner);
 iERR  _ion_strdup          (hOWNER owner, iSTRING dst, iSTRING src);
@@ -141,6 +191,7 @@ iERR  _ion_strdup          (hOWNER owner, iSTRING dst, iSTRING src);
 
 #ifdef MEM_DEBUG 
 void *_dbg_ion_alloc_owner     (SIZE len, const char *file, int line);
+void *_dbg_ion_alloc_owner_with_allocator(SIZE len, ION_ALLOCATOR *allocator, const char *file, int line);
 void *_dbg_ion_alloc_with_owner(hOWNER owner, SIZE length, const char *file, int line);
 void  _dbg_ion_free_owner      (hOWNER owner, const char *file, int line);
 iERR  _dbg_ion_strdup          (hOWNER owner, iSTRING dst, iSTRING src, const char *file, int line);
@@ -28,8 +28,42 @@ void _dbg_ion_message_validate(const char *fn_name, void *addr, SIZE len, int va
 
 void                 *_ion_alloc_with_owner_helper  (ION_ALLOCATION_CHAIN *phead, SIZE length, BOOL force_new_block);
 void                 *_ion_alloc_on_chain           (ION_ALLOCATION_CHAIN *phead, SIZE length);
-ION_ALLOCATION_CHAIN *_ion_alloc_block              (SIZE min_needed);
+ION_ALLOCATION_CHAIN *_ion_alloc_block              (SIZE min_needed, ION_ALLOCATOR *allocator);
 void                  _ion_free_block               (ION_ALLOCATION_CHAIN *pblock);
+ION_ALLOCATION_CHAIN *_ion_block_pool_take          (void);
+BOOL                  _ion_block_pool_give          (ION_ALLOCATION_CHAIN *pblock);
+long                  _ion_block_pool_push_shared   (ION_ALLOCATION_CHAIN *pfirst);
+void                 *_ion_allocator_system_alloc   (void *context, size_t size);
+void                  _ion_allocator_system_free    (void *context, void *ptr);
+void                  _ion_memory_totals_acquire    (ION_ALLOCATION_CHAIN *pblock);
+void                  _ion_memory_totals_release    (ION_ALLOCATION_CHAIN *pblock);
+
+ION_ALLOCATOR  _ion_allocator_system = { _ion_allocator_system_alloc, _ion_allocator_system_free, NULL, NULL };
+static ION_ALLOCATOR *_ion_allocator_default = &_ion_allocator_system;
+
+//
+// the block pool, standard size system allocator blocks are recycled here rather than
+// being returned to the system. each thread caches a few blocks without
+// any synchronization, past that they go to a list shared by all threads.
+// blocks on either list are linked through their next field.
+//
+static SIZE _ion_block_pool_thread_max = ION_BLOCK_POOL_THREAD_CACHE_DEFAULT;
+static SIZE _ion_block_pool_shared_max = ION_BLOCK_POOL_SHARED_DEFAULT;
+
+static THREAD_LOCAL_STORAGE ION_ALLOCATION_CHAIN *_ion_block_pool_cache;
+static THREAD_LOCAL_STORAGE SIZE                  _ion_block_pool_cache_count;
+
+static ION_ALLOCATION_CHAIN * volatile _ion_block_pool_shared;
+static volatile long                   _ion_block_pool_shared_count; // approximate, it's only a high-water check
+
+//
+// process-wide totals over the blocks held by live owners (pooled blocks
+// aren't counted), these are only touched when a block changes hands
+//
+static volatile int64_t _ion_memory_bytes_reserved;
+static volatile int64_t _ion_memory_block_count;
+static volatile int64_t _ion_memory_oversized_block_count;
+static volatile int64_t _ion_memory_high_water;
 
 
 //
@@ -37,12 +71,19 @@ void                  _ion_free_block               (ION_ALLOCATION_CHAIN *pbloc
 //
 
 void *_ion_alloc_owner(SIZE len)
+{
+    return _ion_alloc_owner_with_allocator(len, NULL);
+}
+
+void *_ion_alloc_owner_with_allocator(SIZE len, ION_ALLOCATOR *allocator)
 {
     void                 *owner;
     ION_ALLOCATION_CHAIN *new_chain;
 
-    new_chain = _ion_alloc_block(len);
+    new_chain = _ion_alloc_block(len, _ion_allocator_resolve(allocator));
     if (!new_chain) return NULL;
+    new_chain->reserved   = new_chain->size;
+    new_chain->high_water = new_chain->size;
 
     owner = _ion_alloc_with_owner_helper(new_chain, len, FALSE);
 
@@ -68,7 +109,7 @@ void _ion_free_owner(hOWNER owner)
     ION_ALLOCATION_CHAIN *pblk, *pnext;
 
     // free all the blocks in the owners allocation chain
-    // (release them back to the shared block pool)
+    // (release them back to the block pool)
     for (pblk = powner->head; pblk; pblk = pnext) {
         pnext = pblk->next;
         _ion_free_block(pblk);
@@ -80,6 +121,280 @@ void _ion_free_owner(hOWNER owner)
     return;
 }
 
+iERR ion_allocator_set_default(ION_ALLOCATOR *allocator)
+{
+    iENTER;
+
+    if (allocator && (!allocator->alloc || !allocator->free)) FAILWITH(IERR_INVALID_ARG);
+
+    _ion_allocator_default = (allocator) ? allocator : &_ion_allocator_system;
+
+    iRETURN;
+}
+
+iERR ion_allocator_get_default(ION_ALLOCATOR **p_allocator)
+{
+    iENTER;
+
+    if (!p_allocator) FAILWITH(IERR_INVALID_ARG);
+
+    *p_allocator = _ion_allocator_default;
+
+    iRETURN;
+}
+
+ION_ALLOCATOR *_ion_allocator_resolve(ION_ALLOCATOR *allocator)
+{
+    return (allocator) ? allocator : _ion_allocator_default;
+}
+
+void *_ion_xalloc(ION_ALLOCATOR *allocator, size_t size)
+{
+    allocator = _ion_allocator_resolve(allocator);
+    return allocator->alloc(allocator->context, size);
+}
+
+void _ion_xfree(ION_ALLOCATOR *allocator, void *ptr)
+{
+    if (!ptr) return;
+    allocator = _ion_allocator_resolve(allocator);
+    allocator->free(allocator->context, ptr);
+}
+
+void *_ion_xrealloc(ION_ALLOCATOR *allocator, void *ptr, size_t old_size, size_t new_size)
+{
+    void *new_ptr;
+
+    allocator = _ion_allocator_resolve(allocator);
+    if (!ptr) {
+        return allocator->alloc(allocator->context, new_size);
+    }
+    if (allocator->realloc) {
+        return allocator->realloc(allocator->context, ptr, new_size);
+    }
+
+    new_ptr = allocator->alloc(allocator->context, new_size);
+    if (new_ptr) {
+        memcpy(new_ptr, ptr, (old_size < new_size) ? old_size : new_size);
+        allocator->free(allocator->context, ptr);
+    }
+    return new_ptr;
+}
+
+void *_ion_allocator_system_alloc(void *context, size_t size)
+{
+#ifdef MEM_DEBUG
+    return debug_malloc(size, __FILE__, __LINE__);
+#else
+    return malloc(size);
+#endif
+}
+
+void _ion_allocator_system_free(void *context, void *ptr)
+{
+#ifdef MEM_DEBUG
+    debug_free(ptr, __FILE__, __LINE__);
+#else
+    free(ptr);
+#endif
+}
+
+iERR ion_alloc_mark(hOWNER owner, ION_ALLOC_MARK *p_mark)
+{
+    iENTER;
+
+    if (!owner || !p_mark) FAILWITH(IERR_INVALID_ARG);
+
+    _ion_alloc_mark(owner, p_mark);
+
+    iRETURN;
+}
+
+void _ion_alloc_mark(hOWNER owner, ION_ALLOC_MARK *p_mark)
+{
+    ION_ALLOCATION_CHAIN *powner;
+
+    ASSERT(owner);
+    ASSERT(p_mark);
+
+    // only the owner block and the head of its list are ever allocated from, so
+    // their positions plus the shape of the list at the head are the whole state
+    powner = ION_ALLOC_USER_PTR_TO_BLOCK(owner);
+    p_mark->_owner          = owner;
+    p_mark->_owner_position = powner->position;
+    p_mark->_head           = powner->head;
+    p_mark->_head_position  = powner->head ? powner->head->position : NULL;
+    p_mark->_head_next      = powner->head ? powner->head->next : NULL;
+}
+
+iERR ion_alloc_rewind(hOWNER owner, ION_ALLOC_MARK *p_mark)
+{
+    iENTER;
+
+    if (!owner || !p_mark) FAILWITH(IERR_INVALID_ARG);
+    if (p_mark->_owner != owner) FAILWITH(IERR_INVALID_ARG);
+
+    _ion_alloc_rewind(owner, p_mark);
+
+    iRETURN;
+}
+
+void _ion_alloc_rewind(hOWNER owner, ION_ALLOC_MARK *p_mark)
+{
+    ION_ALLOCATION_CHAIN *powner, *mark_head, *pblock, *pnext;
+
+    ASSERT(owner);
+    ASSERT(p_mark && p_mark->_owner == owner);
+
+    powner    = ION_ALLOC_USER_PTR_TO_BLOCK(owner);
+    mark_head = (ION_ALLOCATION_CHAIN *)p_mark->_head;
+
+    // new blocks are pushed in front of the head, except oversized ones, which are
+    // linked in just after it; so everything added since the mark is either ahead
+    // of the marked head or between it and its marked successor
+    for (pblock = powner->head; pblock != mark_head; pblock = pnext) {
+        ASSERT(pblock);
+        pnext = pblock->next;
+        powner->reserved -= pblock->size;
+        _ion_free_block(pblock);
+    }
+    if (mark_head) {
+        for (pblock = mark_head->next; pblock != p_mark->_head_next; pblock = pnext) {
+            ASSERT(pblock);
+            pnext = pblock->next;
+            powner->reserved -= pblock->size;
+            _ion_free_block(pblock);
+        }
+        mark_head->next     = (ION_ALLOCATION_CHAIN *)p_mark->_head_next;
+        mark_head->position = p_mark->_head_position;
+    }
+    powner->head     = mark_head;
+    powner->position = p_mark->_owner_position;
+}
+
+iERR ion_owner_get_memory_stats(hOWNER owner, ION_MEMORY_STATS *p_stats)
+{
+    iENTER;
+
+    if (!owner || !p_stats) FAILWITH(IERR_INVALID_ARG);
+
+    memset(p_stats, 0, sizeof(ION_MEMORY_STATS));
+    _ion_alloc_owner_add_stats(owner, p_stats);
+
+    iRETURN;
+}
+
+void _ion_alloc_owner_add_stats(hOWNER owner, ION_MEMORY_STATS *p_stats)
+{
+    ION_ALLOCATION_CHAIN *powner, *pblock;
+
+    ASSERT(p_stats);
+    if (!owner) return;
+
+    powner = ION_ALLOC_USER_PTR_TO_BLOCK(owner);
+    p_stats->bytes_reserved += powner->reserved;
+    p_stats->high_water     += powner->high_water;
+
+    // the owner block is followed by the rest of its chain
+    for (pblock = powner; pblock; pblock = (pblock == powner) ? powner->head : pblock->next) {
+        p_stats->bytes_used += pblock->position - ION_ALLOC_BLOCK_TO_USER_PTR(pblock);
+        p_stats->block_count++;
+        if (pblock->size > DEFAULT_BLOCK_SIZE) {
+            p_stats->oversized_block_count++;
+        }
+    }
+}
+
+iERR ion_memory_get_totals(ION_MEMORY_TOTALS *p_totals)
+{
+    iENTER;
+
+    if (!p_totals) FAILWITH(IERR_INVALID_ARG);
+
+    p_totals->bytes_reserved        = _ion_memory_bytes_reserved;
+    p_totals->block_count           = _ion_memory_block_count;
+    p_totals->oversized_block_count = _ion_memory_oversized_block_count;
+    p_totals->high_water            = _ion_memory_high_water;
+    p_totals->pooled_block_count    = _ion_block_pool_shared_count;
+
+    iRETURN;
+}
+
+void _ion_memory_totals_acquire(ION_ALLOCATION_CHAIN *pblock)
+{
+    int64_t reserved, high_water;
+
+    reserved = ION_ATOMIC_ADD64(&_ion_memory_bytes_reserved, pblock->size) + pblock->size;
+    ION_ATOMIC_ADD64(&_ion_memory_block_count, 1);
+    if (pblock->size > DEFAULT_BLOCK_SIZE) {
+        ION_ATOMIC_ADD64(&_ion_memory_oversized_block_count, 1);
+    }
+
+    for (high_water = _ion_memory_high_water; reserved > high_water; high_water = _ion_memory_high_water) {
+        if (ION_ATOMIC_CAS64(&_ion_memory_high_water, high_water, reserved)) break;
+    }
+}
+
+void _ion_memory_totals_release(ION_ALLOCATION_CHAIN *pblock)
+{
+    ION_ATOMIC_ADD64(&_ion_memory_bytes_reserved, -pblock->size);
+    ION_ATOMIC_ADD64(&_ion_memory_block_count, -1);
+    if (pblock->size > DEFAULT_BLOCK_SIZE) {
+        ION_ATOMIC_ADD64(&_ion_memory_oversized_block_count, -1);
+    }
+}
+
+iERR ion_block_pool_set_options(ION_BLOCK_POOL_OPTIONS *p_options)
+{
+    iENTER;
+
+    if (!p_options) FAILWITH(IERR_INVALID_ARG);
+    if (p_options->thread_cache_max_blocks < 0 || p_options->shared_max_blocks < 0) FAILWITH(IERR_INVALID_ARG);
+
+    _ion_block_pool_thread_max = p_options->thread_cache_max_blocks;
+    _ion_block_pool_shared_max = p_options->shared_max_blocks;
+
+    iRETURN;
+}
+
+iERR ion_block_pool_get_options(ION_BLOCK_POOL_OPTIONS *p_options)
+{
+    iENTER;
+
+    if (!p_options) FAILWITH(IERR_INVALID_ARG);
+
+    p_options->thread_cache_max_blocks = _ion_block_pool_thread_max;
+    p_options->shared_max_blocks = _ion_block_pool_shared_max;
+
+    iRETURN;
+}
+
+iERR ion_block_pool_trim(void)
+{
+    iENTER;
+    ION_ALLOCATION_CHAIN *pblock, *pnext;
+    long                  count = 0;
+
+    for (pblock = _ion_block_pool_cache; pblock; pblock = pnext) {
+        pnext = pblock->next;
+        _ion_xfree(&_ion_allocator_system, pblock);
+    }
+    _ion_block_pool_cache = NULL;
+    _ion_block_pool_cache_count = 0;
+
+    pblock = (ION_ALLOCATION_CHAIN *)ION_ATOMIC_EXCHANGE_PTR(&_ion_block_pool_shared, NULL);
+    for (; pblock; pblock = pnext) {
+        pnext = pblock->next;
+        _ion_xfree(&_ion_allocator_system, pblock);
+        count++;
+    }
+    ION_ATOMIC_ADD(&_ion_block_pool_shared_count, -count);
+
+    SUCCEED();
+
+    iRETURN;
+}
+
 iERR _ion_strdup(hOWNER owner, iSTRING dst, iSTRING src)
 {
     iENTER;
@@ -138,9 +453,14 @@ void *_ion_alloc_with_owner_helper(ION_ALLOCATION_CHAIN *powner, SIZE request_le
     // create a new block we might need to just to make room
     if ( force_new_block ) {
         // otherwise we add a new block
-        pblock = _ion_alloc_block(length);
+        pblock = _ion_alloc_block(length, powner->allocator);
         if (!pblock) return NULL;
 
+        powner->reserved += pblock->size;
+        if (powner->reserved > powner->high_water) {
+            powner->high_water = powner->reserved;
+        }
+
         if (pblock->size > DEFAULT_BLOCK_SIZE && powner->head != NULL) {
             // this is an oversized block, so don't put it
             // at the front since it will be full and we'll
@@ -172,26 +492,41 @@ void *_ion_alloc_with_owner_helper(ION_ALLOCATION_CHAIN *powner, SIZE request_le
     return ptr;
 }
 
-ION_ALLOCATION_CHAIN *_ion_alloc_block(SIZE min_needed)
+ION_ALLOCATION_CHAIN *_ion_alloc_block(SIZE min_needed, ION_ALLOCATOR *allocator)
 {
-    ION_ALLOCATION_CHAIN *new_block;
+    ION_ALLOCATION_CHAIN *new_block = NULL;
     SIZE                  alloc_size = min_needed + ALIGN_SIZE(sizeof(ION_ALLOCATION_CHAIN)); // subtract out the block[1]
 
-    if (alloc_size < DEFAULT_BLOCK_SIZE) alloc_size = DEFAULT_BLOCK_SIZE;
+    ASSERT(allocator);
 
-    new_block = (ION_ALLOCATION_CHAIN *)ion_xalloc(alloc_size);    
+    if (alloc_size <= DEFAULT_BLOCK_SIZE) {
+        // standard size blocks are recycled, so look in the pool first
+        alloc_size = DEFAULT_BLOCK_SIZE;
+        if (allocator == &_ion_allocator_system) {
+            new_block = _ion_block_pool_take();
+        }
+    }
+    if (!new_block) {
+        new_block = (ION_ALLOCATION_CHAIN *)_ion_xalloc(allocator, alloc_size);
+    }
     
     // see if we suceeded
     if (!new_block) return NULL;
 
-    new_block->size     = alloc_size;
-    new_block->next     = NULL;
-    new_block->head     = NULL;
+    new_block->size       = alloc_size;
+    new_block->next       = NULL;
+    new_block->head       = NULL;
+    new_block->allocator  = allocator;
+    new_block->reserved   = 0;
+    new_block->high_water = 0;
 
     new_block->position = ION_ALLOC_BLOCK_TO_USER_PTR(new_block);
     new_block->limit    = ((BYTE*)new_block) + new_block->size;
 
-    assert(new_block->position == ((BYTE *)ALIGN_PTR((BYTE *)(&new_block->limit) + ALIGN_SIZE(sizeof(new_block->limit)))));
+    _ion_memory_totals_acquire(new_block);
+
+    // the user bytes start at the first aligned address past the whole header
+    assert(new_block->position == (BYTE *)ALIGN_PTR((BYTE *)new_block + sizeof(ION_ALLOCATION_CHAIN)));
 
     return new_block;
 }
@@ -199,10 +534,94 @@ ION_ALLOCATION_CHAIN *_ion_alloc_block(SIZE min_needed)
 void _ion_free_block(ION_ALLOCATION_CHAIN *pblock)
 {
     if (!pblock) return;
-    ion_xfree(pblock);
+    _ion_memory_totals_release(pblock);
+    if (pblock->allocator == &_ion_allocator_system
+     && pblock->size == DEFAULT_BLOCK_SIZE
+     && _ion_block_pool_give(pblock)
+    ) {
+        return;
+    }
+    _ion_xfree(pblock->allocator, pblock);
     return;
 }
 
+ION_ALLOCATION_CHAIN *_ion_block_pool_take(void)
+{
+    ION_ALLOCATION_CHAIN *pblock, *prest, *pnext;
+    long                  count;
+
+    pblock = _ion_block_pool_cache;
+    if (pblock) {
+        _ion_block_pool_cache = pblock->next;
+        _ion_block_pool_cache_count--;
+        return pblock;
+    }
+    if (!_ion_block_pool_shared) return NULL;
+
+    // popping a single block off a lock-free list is subject to ABA (another
+    // thread may pop our block and push it back between our read of its next
+    // pointer and our compare-and-swap), so instead we detach the whole list,
+    // keep one block, refill our cache, and push whatever is left back
+    pblock = (ION_ALLOCATION_CHAIN *)ION_ATOMIC_EXCHANGE_PTR(&_ion_block_pool_shared, NULL);
+    if (!pblock) return NULL;
+
+    count = 1;
+    prest = pblock->next;
+    while (prest && _ion_block_pool_cache_count < _ion_block_pool_thread_max) {
+        pnext = prest->next;
+        prest->next = _ion_block_pool_cache;
+        _ion_block_pool_cache = prest;
+        _ion_block_pool_cache_count++;
+        prest = pnext;
+        count++;
+    }
+
+    // the blocks we push back are counted again as they're pushed
+    if (prest) {
+        count += _ion_block_pool_push_shared(prest);
+    }
+    ION_ATOMIC_ADD(&_ion_block_pool_shared_count, -count);
+
+    return pblock;
+}
+
+BOOL _ion_block_pool_give(ION_ALLOCATION_CHAIN *pblock)
+{
+    if (_ion_block_pool_cache_count < _ion_block_pool_thread_max) {
+        pblock->next = _ion_block_pool_cache;
+        _ion_block_pool_cache = pblock;
+        _ion_block_pool_cache_count++;
+        return TRUE;
+    }
+    if (_ion_block_pool_shared_count < _ion_block_pool_shared_max) {
+        pblock->next = NULL;
+        _ion_block_pool_push_shared(pblock);
+        return TRUE;
+    }
+    return FALSE;
+}
+
+long _ion_block_pool_push_shared(ION_ALLOCATION_CHAIN *pfirst)
+{
+    ION_ALLOCATION_CHAIN *plast = pfirst, *phead;
+    long                  count = 1;
+
+    while (plast->next) {
+        plast = plast->next;
+        count++;
+    }
+
+    // pushes only ever swap in a new head, so they're safe against ABA
+    do {
+        phead = _ion_block_pool_shared;
+        plast->next = phead;
+    } while (!ION_ATOMIC_CAS_PTR(&_ion_block_pool_shared, phead, pfirst));
+
+    ION_ATOMIC_ADD(&_ion_block_pool_shared_count, count);
+
+    return count;
+}
+
 #ifdef MEM_DEBUG
 
 long malloc_inuse = 0;
@@ -320,13 +739,20 @@ void debug_free(const void *addr, const char *file, int line)
 }
 
 void *_dbg_ion_alloc_owner(SIZE len, const char *file, int line)
+{
+    return _dbg_ion_alloc_owner_with_allocator(len, NULL, file, line);
+}
+
+void *_dbg_ion_alloc_owner_with_allocator(SIZE len, ION_ALLOCATOR *allocator, const char *file, int line)
 {
     long                  cmd  = debug_cmd_counter();
     void                 *owner;
     ION_ALLOCATION_CHAIN *new_chain;
 
-    new_chain = _ion_alloc_block(len);
+    new_chain = _ion_alloc_block(len, _ion_allocator_resolve(allocator));
     if (!new_chain) return NULL;
+    new_chain->reserved   = new_chain->size;
+    new_chain->high_water = new_chain->size;
 
     owner = _ion_alloc_with_owner_helper(new_chain, len, FALSE);
 
@@ -359,12 +785,14 @@ void _dbg_ion_free_owner(hOWNER owner, const char *file, int line)
 
     _dbg_ion_message("___FREE_OWNER", pcurr, -1);
 
-    ion_xfree(pcurr);
+    _ion_memory_totals_release(pcurr);
+    _ion_xfree(pcurr->allocator, pcurr);
 
     while (pnext) {
         pcurr = pnext;
         pnext = pcurr->next;
-        ion_xfree(pcurr);
+        _ion_memory_totals_release(pcurr);
+        _ion_xfree(pcurr->allocator, pcurr);
     }
 }
 
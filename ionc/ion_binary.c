@@ -659,7 +659,7 @@ iERR ion_binary_write_string_with_td_byte( ION_STREAM *pstream, ION_STRING *str
     iRETURN;
 }
 
-iERR ion_binary_write_type_desc_with_length( ION_STREAM *pstream, int type, int32_t len )
+iERR ion_binary_write_type_desc_with_length( ION_STREAM *pstream, int type, int64_t len )
 {
     iENTER;
     ASSERT(pstream != NULL);
@@ -669,7 +669,7 @@ iERR ion_binary_write_type_desc_with_length( ION_STREAM *pstream, int type, int3
         IONCHECK( ion_binary_write_var_uint_64( pstream, len ));
     }
     else {
-        ION_PUT( pstream, makeTypeDescriptor( type, len ));
+        ION_PUT( pstream, makeTypeDescriptor( type, (int)len ));
     }
 
     iRETURN;
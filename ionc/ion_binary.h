@@ -121,7 +121,7 @@ ION_API_EXPORT iERR ion_binary_write_int64_with_field_sid  ( ION_STREAM *pstream
 ION_API_EXPORT iERR ion_binary_write_string_with_field_sid ( ION_STREAM *pstream, SID field_sid, ION_STRING *str );
 ION_API_EXPORT iERR ion_binary_write_string_with_td_byte   ( ION_STREAM *pstream, ION_STRING *str );
 
-ION_API_EXPORT iERR ion_binary_write_type_desc_with_length ( ION_STREAM *pstream, int tid, int32_t len );
+ION_API_EXPORT iERR ion_binary_write_type_desc_with_length ( ION_STREAM *pstream, int tid, int64_t len );
 
 /** Write out binary encoded uint.
  *
@@ -56,6 +56,7 @@ iERR _ion_catalog_open_with_owner_helper(ION_CATALOG **p_pcatalog, hOWNER owner)
     iENTER;
     ION_CATALOG *catalog;
     ION_SYMBOL_TABLE *system;
+    ION_INDEX_OPTIONS index_options;
 
     ASSERT(p_pcatalog);
 
@@ -77,6 +78,19 @@ iERR _ion_catalog_open_with_owner_helper(ION_CATALOG **p_pcatalog, hOWNER owner)
 
     _ion_collection_initialize(owner, &catalog->table_list, sizeof(ION_SYMBOL_TABLE *)); // collection of ION_SYMBOL_TABLE *
 
+    index_options._memory_owner           = owner;
+    index_options._fn_context             = NULL;
+    index_options._initial_size           = 0; /* let index pick a default number of actual keys */
+    index_options._density_target_percent = 0; /* let index pick a default for table size increases */
+
+    index_options._compare_fn = _ion_catalog_key_compare_fn;
+    index_options._hash_fn    = _ion_catalog_key_hash_fn;
+    IONCHECK(_ion_index_initialize(&catalog->by_name_version, &index_options));
+
+    index_options._compare_fn = _ion_catalog_name_compare_fn;
+    index_options._hash_fn    = _ion_catalog_name_hash_fn;
+    IONCHECK(_ion_index_initialize(&catalog->by_name, &index_options));
+
     *p_pcatalog = catalog;
 
     iRETURN;
@@ -131,14 +145,15 @@ iERR ion_catalog_add_symbol_table(hCATALOG hcatalog, hSYMTAB hsymtab)
 iERR _ion_catalog_add_symbol_table_helper(ION_CATALOG *pcatalog, ION_SYMBOL_TABLE *psymtab)
 {
     iENTER;
-    ION_SYMBOL_TABLE **ppsymtab, *psystem, *pclone, *ptest = NULL;
+    ION_SYMBOL_TABLE **ppsymtab, *ptest = NULL;
     ION_STRING         name;
     int32_t            version;
-    hOWNER             owner;
 
     ASSERT(pcatalog != NULL);
     ASSERT(psymtab != NULL);
 
+    if (pcatalog->is_frozen) FAILWITH(IERR_IS_IMMUTABLE);
+
     IONCHECK(ion_symbol_table_get_name(psymtab, &name));
     IONCHECK(ion_symbol_table_get_version(psymtab, &version));
 
@@ -150,20 +165,17 @@ iERR _ion_catalog_add_symbol_table_helper(ION_CATALOG *pcatalog, ION_SYMBOL_TABL
 
     // otherwise ...
 
-    IONCHECK(_ion_symbol_table_get_owner(psymtab, &owner));
-
-    // if this catalog doesn't own it - we have to clone it
-    if (pcatalog->owner != owner) {
-        IONCHECK(_ion_symbol_table_get_system_symbol_table(psymtab, &psystem));
-        IONCHECK(_ion_symbol_table_clone_with_owner_and_system_table(psymtab, &pclone, pcatalog->owner, psystem));
-        psymtab = pclone;
-    }
+    // if this catalog doesn't own it - we have to clone it (unless it's frozen)
+    IONCHECK(_ion_symbol_table_adopt_import_helper(&psymtab, psymtab, pcatalog->owner));
 
     // now we attach it
     ppsymtab = _ion_collection_append(&pcatalog->table_list);
     if (!ppsymtab) FAILWITH(IERR_NO_MEMORY);
     *ppsymtab = psymtab;
 
+    IONCHECK(_ion_symbol_table_get_name_helper(psymtab, &name));
+    IONCHECK(_ion_catalog_index_insert_helper(pcatalog, psymtab, &name, version));
+
     iRETURN;
 }
 
@@ -194,40 +206,31 @@ iERR ion_catalog_find_symbol_table(hCATALOG hcatalog, iSTRING name, long version
 iERR _ion_catalog_find_symbol_table_helper(ION_CATALOG *pcatalog, ION_STRING *name, int32_t version, hSYMTAB *p_symtab)
 {
     iENTER;
-    ION_SYMBOL_TABLE        **ppsymtab, *psymtab, *found = NULL;
-    ION_COLLECTION_CURSOR    symtab_cursor;
-    ION_STRING               symtab_name, system_symtab_name;
-    int32_t                  symtab_version, system_symtab_version;
+    ION_SYMBOL_TABLE        *found = NULL, *system;
+    ION_CATALOG_ENTRY       *entry;
+    ION_CATALOG_KEY          key;
+    ION_STRING               system_symtab_name;
+    int32_t                  system_symtab_version;
 
     ASSERT(pcatalog != NULL);
     ASSERT(!ION_STRING_IS_NULL(name));
     ASSERT(p_symtab != NULL);
 
-    IONCHECK(_ion_symbol_table_get_name_helper(pcatalog->system_symbol_table, &system_symtab_name));
-    IONCHECK(_ion_symbol_table_get_version_helper(pcatalog->system_symbol_table, &system_symtab_version));
+    // the constant system table, which every thread shares, rather than pcatalog->system_symbol_table
+    IONCHECK(_ion_symbol_table_get_system_symbol_helper(&system, ION_SYSTEM_VERSION));
+    IONCHECK(_ion_symbol_table_get_name_helper(system, &system_symtab_name));
+    IONCHECK(_ion_symbol_table_get_version_helper(system, &system_symtab_version));
 
     if (version == system_symtab_version
     && ION_STRING_EQUALS(name, &system_symtab_name)
     ) {
-        found = pcatalog->system_symbol_table;
+        found = system;
     }
     else {
-        ION_COLLECTION_OPEN(&pcatalog->table_list, symtab_cursor);
-        for (;;) {
-            ION_COLLECTION_NEXT(symtab_cursor, ppsymtab);
-            if (!ppsymtab) break;
-            psymtab = *ppsymtab;
-
-            IONCHECK(_ion_symbol_table_get_name_helper(psymtab, &symtab_name));
-            IONCHECK(_ion_symbol_table_get_version_helper(psymtab, &symtab_version));
-
-            if (symtab_version != version) continue;
-            if (ION_STRING_EQUALS(name, &symtab_name)) {
-                found = psymtab;
-                break;
-            }
-        }
-        ION_COLLECTION_CLOSE(symtab_cursor);
+        ION_STRING_ASSIGN(&key.name, name);
+        key.version = version;
+        entry = (ION_CATALOG_ENTRY *)_ion_index_find(&pcatalog->by_name_version, &key);
+        if (entry) found = entry->symtab;
     }
 
     *p_symtab = PTR_TO_HANDLE(found);
@@ -261,48 +264,36 @@ iERR ion_catalog_find_best_match(hCATALOG hcatalog, iSTRING name, long version,
 iERR _ion_catalog_find_best_match_helper(ION_CATALOG *pcatalog, ION_STRING *name, int32_t version, int32_t max_id, ION_SYMBOL_TABLE **p_psymtab)
 {
     iENTER;
-    ION_SYMBOL_TABLE       **ppsymtab, *psymtab, *best = NULL;
-    ION_STRING               symtab_name, system_name;
-    int32_t                  symtab_version, best_version, system_version;
-    ION_COLLECTION_CURSOR    symtab_cursor;
+    ION_SYMBOL_TABLE        *best = NULL, *system;
+    ION_CATALOG_VERSIONS    *versions;
+    ION_CATALOG_KEY          key;
+    ION_STRING               system_name;
+    int32_t                  best_version, system_version, ii;
 
     ASSERT(pcatalog != NULL);
     ASSERT(!ION_STRING_IS_NULL(name));
 
     // check for the system table first (mostly because it's not
-    // really in the list of symbol tables in the catalog)
-    IONCHECK(_ion_symbol_table_get_name_helper(pcatalog->system_symbol_table, &system_name));
-    IONCHECK(_ion_symbol_table_get_version_helper(pcatalog->system_symbol_table, &system_version));
+    // really in the list of symbol tables in the catalog).
+    IONCHECK(_ion_symbol_table_get_system_symbol_helper(&system, ION_SYSTEM_VERSION));
+    IONCHECK(_ion_symbol_table_get_name_helper(system, &system_name));
+    IONCHECK(_ion_symbol_table_get_version_helper(system, &system_version));
     if (version == system_version && ION_STRING_EQUALS(name, &system_name)) {
-        best = pcatalog->system_symbol_table;
+        best = system;
     }
     else {
-        ION_COLLECTION_OPEN(&pcatalog->table_list, symtab_cursor);
-        for (;;) {
-            ION_COLLECTION_NEXT(symtab_cursor, ppsymtab);
-            if (!ppsymtab) break;
-            psymtab = *ppsymtab;
-            IONCHECK(_ion_symbol_table_get_name_helper(psymtab, &symtab_name));
-            if (!ION_STRING_EQUALS(name, &symtab_name)) continue;
-            if (!best) {
-                best = psymtab;
+        ION_STRING_ASSIGN(&key.name, name);
+        key.version = version;
+        versions = (ION_CATALOG_VERSIONS *)_ion_index_find(&pcatalog->by_name, &key);
+        if (versions && versions->count > 0) {
+            // the exact version if we have it, otherwise the lowest version above the one
+            // requested, otherwise (or if no version was requested) the highest we have
+            ii = _ion_catalog_versions_search_helper(versions, version);
+            if (ii >= versions->count || (version <= 0 && versions->entries[ii]->key.version != version)) {
+                ii = versions->count - 1;
             }
-            else {
-                IONCHECK(_ion_symbol_table_get_version_helper(psymtab, &symtab_version));
-                IONCHECK(_ion_symbol_table_get_version_helper(best, &best_version));
-                if (version > 0 && symtab_version >= version) {
-                    if (symtab_version <= best_version) {
-                        best = psymtab;
-                    }
-                }
-                else if (symtab_version > best_version) {
-                    best = psymtab;
-                }
-            }
-            IONCHECK(_ion_symbol_table_get_version_helper(best, &best_version));
-            if (best_version == version) break;
+            best = versions->entries[ii]->symtab;
         }
-        ION_COLLECTION_CLOSE(symtab_cursor);
     }
 
     if (version > 0 && max_id <= ION_SYS_SYMBOL_MAX_ID_UNDEFINED) {
@@ -342,16 +333,28 @@ iERR _ion_catalog_release_symbol_table_helper(ION_CATALOG *pcatalog, ION_SYMBOL_
     iENTER;
     ION_SYMBOL_TABLE        **ppsymtab, **found = NULL;
     ION_COLLECTION_CURSOR   symtab_cursor;
-    ION_STRING              name, our_name;
-    int32_t                 version, our_version;
+    ION_CATALOG_ENTRY      *entry;
+    ION_CATALOG_KEY         key;
+    int32_t                 version;
 
     ASSERT(pcatalog != NULL);
     ASSERT(psymtab != NULL);
 
-    IONCHECK(ion_symbol_table_get_name(psymtab, &name));
+    if (pcatalog->is_frozen) FAILWITH(IERR_IS_IMMUTABLE);
+
+    IONCHECK(ion_symbol_table_get_name(psymtab, &key.name));
     IONCHECK(ion_symbol_table_get_version(psymtab, &version));
+    key.version = version;
 
-    ASSERT(pcatalog != NULL);
+    // the catalog holds at most one table with this name and version, which
+    // is either psymtab itself or the catalog's clone of it
+    entry = (ION_CATALOG_ENTRY *)_ion_index_find(&pcatalog->by_name_version, &key);
+    if (!entry) {
+		// TODO: again - is this just fine (the table's already released)
+		//       or is this a problem to report
+		// FAILWITH(IERR_SYMBOL_TABLE_NOT_FOUND);
+		SUCCEED();
+    }
 
     // the argument to _ion_collection_remove must be a pointer to
     // ION_COLLECTION_NODE._data; i.e. the second parameter of
@@ -360,30 +363,120 @@ iERR _ion_catalog_release_symbol_table_helper(ION_CATALOG *pcatalog, ION_SYMBOL_
     for (;;) {
         ION_COLLECTION_NEXT(symtab_cursor, ppsymtab);
         if (!ppsymtab) break;
-        if (*ppsymtab != psymtab) {
-            IONCHECK(ion_symbol_table_get_version(*ppsymtab, &our_version));
-            if (our_version != version) continue;
-
-            IONCHECK(ion_symbol_table_get_name(*ppsymtab, &our_name));
-            if (!ION_STRING_EQUALS(&our_name, &name)) continue;
+        if (*ppsymtab == entry->symtab) {
+            found = ppsymtab;
+            break;
         }
-        found = ppsymtab;
-        break;
     }
     ION_COLLECTION_CLOSE(symtab_cursor);
 
-    if (!found) {
-		// TODO: again - is this just fine (the table's already released)
-		//       or is this a problem to report
-		// FAILWITH(IERR_SYMBOL_TABLE_NOT_FOUND);
-		SUCCEED();
+    ASSERT(found);
+    _ion_collection_remove(&pcatalog->table_list, found);
+    _ion_catalog_index_remove_helper(pcatalog, entry);
+
+    iRETURN;
+}
+
+iERR ion_catalog_freeze(hCATALOG hcatalog)
+{
+    iENTER;
+    ION_CATALOG *catalog;
+
+    if (hcatalog == NULL) FAILWITH(IERR_INVALID_ARG);
+
+    catalog = HANDLE_TO_PTR(hcatalog, ION_CATALOG);
+
+    IONCHECK(_ion_catalog_freeze_helper(catalog));
+
+    iRETURN;
+}
+
+iERR _ion_catalog_freeze_helper(ION_CATALOG *pcatalog)
+{
+    iENTER;
+    ION_SYMBOL_TABLE        **ppsymtab;
+    ION_COLLECTION_CURSOR     symtab_cursor;
+
+    ASSERT(pcatalog != NULL);
+
+    if (pcatalog->is_frozen) SUCCEED();
+
+    ION_COLLECTION_OPEN(&pcatalog->table_list, symtab_cursor);
+    for (;;) {
+        ION_COLLECTION_NEXT(symtab_cursor, ppsymtab);
+        if (!ppsymtab) break;
+        IONCHECK(_ion_symbol_table_freeze_helper(*ppsymtab));
     }
+    ION_COLLECTION_CLOSE(symtab_cursor);
 
-    _ion_collection_remove(&pcatalog->table_list, found);
+    pcatalog->is_frozen = TRUE;
+
+    iRETURN;
+}
+
+iERR ion_catalog_is_frozen(hCATALOG hcatalog, BOOL *p_is_frozen)
+{
+    iENTER;
+    ION_CATALOG *catalog;
+
+    if (hcatalog == NULL) FAILWITH(IERR_INVALID_ARG);
+    if (p_is_frozen == NULL) FAILWITH(IERR_INVALID_ARG);
+
+    catalog = HANDLE_TO_PTR(hcatalog, ION_CATALOG);
+    *p_is_frozen = catalog->is_frozen;
+
+    iRETURN;
+}
+
+iERR ion_catalog_open_from_frozen(hCATALOG *p_hcatalog, hCATALOG hfrozen)
+{
+    iENTER;
+    ION_CATALOG *catalog, *frozen;
+
+    if (p_hcatalog == NULL) FAILWITH(IERR_INVALID_ARG);
+    if (hfrozen == NULL) FAILWITH(IERR_INVALID_ARG);
+
+    frozen = HANDLE_TO_PTR(hfrozen, ION_CATALOG);
+
+    IONCHECK(_ion_catalog_open_from_frozen_helper(&catalog, frozen));
+
+    *p_hcatalog = PTR_TO_HANDLE(catalog);
 
     iRETURN;
 }
 
+iERR _ion_catalog_open_from_frozen_helper(ION_CATALOG **p_pcatalog, ION_CATALOG *pfrozen)
+{
+    iENTER;
+    ION_CATALOG              *catalog = NULL;
+    ION_SYMBOL_TABLE        **ppsymtab;
+    ION_COLLECTION_CURSOR     symtab_cursor;
+
+    ASSERT(p_pcatalog != NULL);
+    ASSERT(pfrozen != NULL);
+
+    if (!pfrozen->is_frozen) FAILWITH(IERR_INVALID_STATE);
+
+    IONCHECK(_ion_catalog_open_with_owner_helper(&catalog, NULL));
+
+    // the tables are frozen too, so adding them shares rather than clones them
+    ION_COLLECTION_OPEN(&pfrozen->table_list, symtab_cursor);
+    for (;;) {
+        ION_COLLECTION_NEXT(symtab_cursor, ppsymtab);
+        if (!ppsymtab) break;
+        IONCHECK(_ion_catalog_add_symbol_table_helper(catalog, *ppsymtab));
+    }
+    ION_COLLECTION_CLOSE(symtab_cursor);
+
+    *p_pcatalog = catalog;
+    catalog = NULL;
+
+fail:
+    if (catalog) {
+        _ion_catalog_close_helper(catalog);
+    }
+    return err;
+}
 
 iERR ion_catalog_close(hCATALOG hcatalog)
 {
@@ -409,3 +502,128 @@ iERR _ion_catalog_close_helper(ION_CATALOG *pcatalog)
     return IERR_OK;
 }
 
+
+int_fast8_t _ion_catalog_key_compare_fn(void *key1, void *key2, void *context)
+{
+    ION_CATALOG_KEY *lhs = (ION_CATALOG_KEY *)key1;
+    ION_CATALOG_KEY *rhs = (ION_CATALOG_KEY *)key2;
+
+    ASSERT(lhs);
+    ASSERT(rhs);
+
+    // this compare is for the purposes of the hash table only !
+    if (lhs->version != rhs->version) return (lhs->version > rhs->version) ? 1 : -1;
+    return _ion_catalog_name_compare_fn(key1, key2, context);
+}
+
+int_fast32_t _ion_catalog_key_hash_fn(void *key, void *context)
+{
+    ION_CATALOG_KEY *catalog_key = (ION_CATALOG_KEY *)key;
+
+    ASSERT(catalog_key);
+    return (int_fast32_t)_ion_hash_bytes(catalog_key->name.value, catalog_key->name.length, (uint64_t)(uint32_t)catalog_key->version);
+}
+
+int_fast8_t _ion_catalog_name_compare_fn(void *key1, void *key2, void *context)
+{
+    ION_CATALOG_KEY *lhs = (ION_CATALOG_KEY *)key1;
+    ION_CATALOG_KEY *rhs = (ION_CATALOG_KEY *)key2;
+    int              cmp;
+
+    ASSERT(lhs);
+    ASSERT(rhs);
+
+    // this compare is for the purposes of the hash table only !
+    if (lhs->name.length != rhs->name.length) return (lhs->name.length > rhs->name.length) ? 1 : -1;
+    if (lhs->name.length == 0) return 0;
+    cmp = memcmp(lhs->name.value, rhs->name.value, lhs->name.length);
+    return (cmp > 0) ? 1 : ((cmp < 0) ? -1 : 0);
+}
+
+int_fast32_t _ion_catalog_name_hash_fn(void *key, void *context)
+{
+    ION_CATALOG_KEY *catalog_key = (ION_CATALOG_KEY *)key;
+
+    ASSERT(catalog_key);
+    return (int_fast32_t)_ion_hash_bytes(catalog_key->name.value, catalog_key->name.length, 0);
+}
+
+iERR _ion_catalog_index_insert_helper(ION_CATALOG *pcatalog, ION_SYMBOL_TABLE *psymtab, ION_STRING *name, int32_t version)
+{
+    iENTER;
+    ION_CATALOG_ENTRY     *entry;
+    ION_CATALOG_VERSIONS  *versions;
+    int32_t                ii, new_capacity;
+
+    ASSERT(pcatalog != NULL);
+    ASSERT(psymtab != NULL);
+
+    entry = (ION_CATALOG_ENTRY *)ion_alloc_with_owner(pcatalog->owner, sizeof(ION_CATALOG_ENTRY));
+    if (!entry) FAILWITH(IERR_NO_MEMORY);
+    // psymtab belongs to the catalog's owner by now, so its name can be shared
+    ION_STRING_ASSIGN(&entry->key.name, name);
+    entry->key.version = version;
+    entry->symtab = psymtab;
+    IONCHECK(_ion_index_insert(&pcatalog->by_name_version, &entry->key, entry));
+
+    versions = (ION_CATALOG_VERSIONS *)_ion_index_find(&pcatalog->by_name, &entry->key);
+    if (!versions) {
+        versions = (ION_CATALOG_VERSIONS *)ion_alloc_with_owner(pcatalog->owner, sizeof(ION_CATALOG_VERSIONS));
+        if (!versions) FAILWITH(IERR_NO_MEMORY);
+        memset(versions, 0, sizeof(ION_CATALOG_VERSIONS));
+        ION_STRING_ASSIGN(&versions->key.name, name);
+        IONCHECK(_ion_index_insert(&pcatalog->by_name, &versions->key, versions));
+    }
+    if (versions->count == versions->capacity) {
+        new_capacity = (versions->capacity) ? versions->capacity * 2 : 4;
+        IONCHECK(_ion_index_grow_array((void **)&versions->entries, versions->count, new_capacity,
+                                       sizeof(versions->entries[0]), TRUE, pcatalog->owner));
+        versions->capacity = new_capacity;
+    }
+
+    // keep the versions sorted
+    ii = _ion_catalog_versions_search_helper(versions, version);
+    memmove(&versions->entries[ii + 1], &versions->entries[ii], (versions->count - ii) * sizeof(versions->entries[0]));
+    versions->entries[ii] = entry;
+    versions->count++;
+
+    iRETURN;
+}
+
+void _ion_catalog_index_remove_helper(ION_CATALOG *pcatalog, ION_CATALOG_ENTRY *entry)
+{
+    ION_CATALOG_VERSIONS *versions;
+    void                 *removed;
+    int32_t               ii;
+
+    ASSERT(pcatalog != NULL);
+    ASSERT(entry != NULL);
+
+    _ion_index_delete(&pcatalog->by_name_version, &entry->key, &removed);
+    ASSERT(removed == entry);
+
+    versions = (ION_CATALOG_VERSIONS *)_ion_index_find(&pcatalog->by_name, &entry->key);
+    ASSERT(versions != NULL);
+    ii = _ion_catalog_versions_search_helper(versions, entry->key.version);
+    ASSERT(ii < versions->count && versions->entries[ii] == entry);
+    versions->count--;
+    memmove(&versions->entries[ii], &versions->entries[ii + 1], (versions->count - ii) * sizeof(versions->entries[0]));
+    // an empty version list stays in by_name, ready for the name to be added again
+}
+
+// returns the position of the first entry whose version is >= version (count if there is none)
+int32_t _ion_catalog_versions_search_helper(ION_CATALOG_VERSIONS *versions, int32_t version)
+{
+    int32_t low = 0, high = versions->count, mid;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (versions->entries[mid]->key.version < version) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    return low;
+}
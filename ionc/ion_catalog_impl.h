@@ -15,15 +15,45 @@
 #ifndef ION_CATALOG_IMPL_H_
 #define ION_CATALOG_IMPL_H_
 
+#include "ion_index.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// the (name, version) identity of a shared symbol table, used as the key of the catalog's indices
+typedef struct _ion_catalog_key
+{
+    ION_STRING          name;
+    int32_t             version;        // ignored by the by_name index
+
+} ION_CATALOG_KEY;
+
+typedef struct _ion_catalog_entry
+{
+    ION_CATALOG_KEY     key;            // the table's name and version
+    ION_SYMBOL_TABLE   *symtab;
+
+} ION_CATALOG_ENTRY;
+
+// every version of one shared symbol table name held by the catalog
+typedef struct _ion_catalog_versions
+{
+    ION_CATALOG_KEY     key;            // the shared name; the version is unused
+    int32_t             count;
+    int32_t             capacity;
+    ION_CATALOG_ENTRY **entries;        // sorted by ascending version
+
+} ION_CATALOG_VERSIONS;
+
 struct _ion_catalog
 {
     void                *owner;
+    BOOL                 is_frozen;     // if so, the catalog and its (frozen) tables are read-only and may be shared between threads
     ION_SYMBOL_TABLE    *system_symbol_table;
     ION_COLLECTION       table_list;    // collection of ION_SYMBOL_TABLE *
+    ION_INDEX            by_name_version; // ION_CATALOG_KEY -> ION_CATALOG_ENTRY, for exact matches
+    ION_INDEX            by_name;       // ION_CATALOG_KEY (name only) -> ION_CATALOG_VERSIONS, for best matches
 
 };
 
@@ -35,6 +65,16 @@ iERR _ion_catalog_find_symbol_table_helper(ION_CATALOG *pcatalog, ION_STRING *na
 iERR _ion_catalog_find_best_match_helper(ION_CATALOG *pcatalog, ION_STRING *name, int32_t version, int32_t max_id, ION_SYMBOL_TABLE **p_psymtab);
 iERR _ion_catalog_release_symbol_table_helper(ION_CATALOG *pcatalog, ION_SYMBOL_TABLE *psymtab);
 iERR _ion_catalog_close_helper(ION_CATALOG *pcatalog);
+iERR _ion_catalog_freeze_helper(ION_CATALOG *pcatalog);
+iERR _ion_catalog_open_from_frozen_helper(ION_CATALOG **p_pcatalog, ION_CATALOG *pfrozen);
+
+int_fast8_t  _ion_catalog_key_compare_fn        (void *key1, void *key2, void *context);
+int_fast32_t _ion_catalog_key_hash_fn           (void *key, void *context);
+int_fast8_t  _ion_catalog_name_compare_fn       (void *key1, void *key2, void *context);
+int_fast32_t _ion_catalog_name_hash_fn          (void *key, void *context);
+iERR         _ion_catalog_index_insert_helper   (ION_CATALOG *pcatalog, ION_SYMBOL_TABLE *psymtab, ION_STRING *name, int32_t version);
+void         _ion_catalog_index_remove_helper   (ION_CATALOG *pcatalog, ION_CATALOG_ENTRY *entry);
+int32_t      _ion_catalog_versions_search_helper(ION_CATALOG_VERSIONS *versions, int32_t version);
 
 #ifdef __cplusplus
 }
@@ -80,6 +80,40 @@ void *_ion_collection_append(ION_COLLECTION *collection)
     return data;
 }
 
+void *_ion_collection_append_block(ION_COLLECTION *collection, int32_t count)
+{
+    ION_COLLECTION_NODE *first, *node;
+    int32_t              node_size, ii;
+
+    ASSERT(collection != NULL);
+    ASSERT(count > 0);
+
+    // the nodes are carved from one allocation but are linked as usual, so
+    // nothing else in the collection (including the freelist) can tell
+    node_size = (int32_t)ALIGN_SIZE(collection->_node_size);
+    if (count > INT32_MAX / node_size) return NULL;
+
+    first = (ION_COLLECTION_NODE *)ion_alloc_with_owner(collection->_owner, node_size * count);
+    if (first == NULL) return NULL;
+    memset(first, 0, node_size * count);
+
+    node = first;
+    for (ii = 0; ii < count; ii++) {
+        node->_prev = collection->_tail;
+        if (collection->_tail) {
+            collection->_tail->_next = node;
+        }
+        else {
+            collection->_head = node;
+        }
+        collection->_tail = node;
+        node = (ION_COLLECTION_NODE *)(((uint8_t *)node) + node_size);
+    }
+    collection->_count += count;
+
+    return IPCN_pNODE_TO_pDATA(first);
+}
+
 #ifdef MEM_DEBUG
 void _ion_collection_clear_node(ION_COLLECTION *collection, ION_COLLECTION_NODE *node)
 {
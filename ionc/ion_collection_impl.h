@@ -25,6 +25,7 @@ typedef iERR (*ION_COMPARE_FN)(void *lhs, void *rhs, BOOL *is_equal);
 void  _ion_collection_initialize(void *allocation_parent, ION_COLLECTION *collection, int32_t data_length);
 void *_ion_collection_push      (ION_COLLECTION *collection);
 void *_ion_collection_append    (ION_COLLECTION *collection);
+void *_ion_collection_append_block(ION_COLLECTION *collection, int32_t count); // appends count zeroed entries from a single allocation, returns the first
 void  _ion_collection_pop_head  (ION_COLLECTION *collection);
 void  _ion_collection_pop_tail  (ION_COLLECTION *collection);
 void  _ion_collection_remove    (ION_COLLECTION *collection, void *p_entry);
@@ -44,6 +44,9 @@ extern "C" {
     // being cached while reading a single value, all the annotations
 #define DEFAULT_ANNOTATION_BUFFER_LIMIT (DEFAULT_USER_ALLOC_THRESHOLD)
 
+    // the number of distinct local symbol tables a reader keeps for reuse
+#define DEFAULT_SYMBOL_TABLE_CACHE_SIZE   8
+
 #define MIN_ANNOTATION_LIMIT              1
 #define MIN_WRITER_STACK_DEPTH            2
 #define MIN_SYMBOL_THRESHOLD             32
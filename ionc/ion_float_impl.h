@@ -0,0 +1,51 @@
+/*
+ * Copyright 2009-2016 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#ifndef IONC_ION_FLOAT_IMPL_H
+#define IONC_ION_FLOAT_IMPL_H
+
+#include <ionc/ion_types.h>
+
+// The most significant digits needed to round-trip a double; digit buffers are not NUL terminated.
+#define ION_FLOAT64_MAX_DIGITS  17
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Generates the shortest sequence of decimal digits that round-trips to the given finite, positive double,
+ * such that value == digits * 10^(*p_exponent). The digits are written to `digits` as ASCII characters and
+ * are not NUL terminated; their count is returned through p_length.
+ *
+ * This is the Grisu3 algorithm, which rejects the ~0.5% of inputs it cannot prove shortest. In that case
+ * FALSE is returned and the caller must fall back to a slower (but exact) conversion.
+ */
+BOOL _ion_float_to_shortest_digits(double value, char *digits, int *p_length, int *p_exponent);
+
+/**
+ * Converts the text of a decimal float, as collected by the text scanner (-?digits[.digits][eE][+-]?digits,
+ * with no underscores), to the nearest double. The text is read through `length` and need not be NUL
+ * terminated.
+ *
+ * Inputs with more than 19 significant digits, subnormal results, and the rare products too close to a
+ * rounding boundary are rejected with FALSE; the caller must then fall back to an exact conversion.
+ */
+BOOL _ion_float_from_text(const char *text, SIZE length, double *p_value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //IONC_ION_FLOAT_IMPL_H
@@ -309,111 +309,199 @@ const char *_ion_hack_bad_value_to_str(intptr_t val, char *msg)
     return hack_buffer_return;
 }
 
-char * _ion_itoa_10(int32_t val, char *dst_buf, SIZE buf_length) 
+static const char _ion_decimal_digit_pairs[200] = {
+    '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+    '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+    '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+    '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+    '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+    '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+    '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+    '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+    '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+    '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+};
+
+static int _ion_decimal_digit_count(uint64_t value)
 {
-    // sprintf(dest, "%d", val); - with sprintf we can't tell if we're running off the end of the buf
+    int      count = 1;
+    uint64_t limit = 10;
 
-    // we're only using this on error messages and unknown symbol name generation
-    // so we don't care at the moment.  later this may become more important and
-    // be worth optimizing
-    char    *cp, *start, *end;
-    int32_t  next;
-    int      digit, temp;
-
-    cp = dst_buf;
-    end = dst_buf + buf_length;
-    if (val < 0) {
-        if (cp >= end) goto overflow;
-        *cp++ = '-';
-        val = -val;
+    while (count < 20 && value >= limit) {
+        count++;
+        limit *= 10;
     }
+    return count;
+}
 
-    // record where the first digit goes
-    if (val == 0) {
-        if (cp >= end) goto overflow;
-        *cp++ = '0';
-        *cp = '\0';
+SIZE _ion_u64toa_10_unterminated(uint64_t value, char *dst)
+{
+    SIZE  count = _ion_decimal_digit_count(value);
+    char *cp = dst + count;
+    int   pair;
+
+    // two digits per division, written from the least significant end
+    while (value >= 100) {
+        pair = (int)(value % 100) * 2;
+        value /= 100;
+        *--cp = _ion_decimal_digit_pairs[pair + 1];
+        *--cp = _ion_decimal_digit_pairs[pair];
+    }
+    if (value >= 10) {
+        pair = (int)value * 2;
+        *--cp = _ion_decimal_digit_pairs[pair + 1];
+        *--cp = _ion_decimal_digit_pairs[pair];
     }
     else {
-        start = cp;
-        while (val > 0) {
-            next = val / 10;
-            digit = (int)(val - 10*next);
-            if (cp >= end) goto overflow;
-            *cp++ = digit + '0';
-            val = next;
-        }
-        if (cp >= end) goto overflow;
-        *cp = '\0';
-
-        // reverse the digits
-        while (start < --cp) {
-            temp = *start;
-            *start = *cp;
-            *cp = temp;
-            start++;
-        }
+        *--cp = (char)('0' + value);
     }
+    ASSERT(cp == dst);
+    return count;
+}
+
+static char *_ion_signed_toa_10(BOOL is_negative, uint64_t magnitude, char *dst_buf, SIZE buf_length)
+{
+    char *cp = dst_buf;
+
+    // sign, digits and the null terminator
+    if (buf_length < (is_negative ? 1 : 0) + _ion_decimal_digit_count(magnitude) + 1) {
+        assert(FALSE && "buffer overflow in local itoa!");
+        return NULL; // this should force a null pointer exception in the caller
+    }
+    if (is_negative) {
+        *cp++ = '-';
+    }
+    cp += _ion_u64toa_10_unterminated(magnitude, cp);
+    *cp = '\0';
     return dst_buf;
+}
 
-overflow:
-    assert(cp < end && "buffer overflow in local itoa!");
-    return NULL; // this should force a null pointer exception in the caller
+char * _ion_itoa_10(int32_t val, char *dst_buf, SIZE buf_length) 
+{
+    // sprintf(dest, "%d", val); - with sprintf we can't tell if we're running off the end of the buf
+    // the magnitude is negated as unsigned so that INT32_MIN doesn't overflow
+    return _ion_signed_toa_10(val < 0, val < 0 ? 0 - (uint64_t)(uint32_t)val : (uint64_t)val, dst_buf, buf_length);
 }
 
 char *_ion_i64toa_10(int64_t val, char *dst_buf, SIZE buf_length) 
 {
     // sprintf(dest, "%dI64", val); - with sprintf we can't tell if we're running off the end of the buf
+    return _ion_signed_toa_10(val < 0, val < 0 ? 0 - (uint64_t)val : (uint64_t)val, dst_buf, buf_length);
+}
 
-    // we're only using this on error messages and unknown symbol name generation
-    // so we don't care at the moment.  later this may become more important and
-    // be worth optimizing
+// Loads 8 bytes in memory order, so the first character lands in the low byte regardless of endianness.
+static uint64_t _ion_load_8_chars(const char *cp)
+{
+    const BYTE *bp = (const BYTE *)cp;
+    return  (uint64_t)bp[0]        | ((uint64_t)bp[1] << 8)  | ((uint64_t)bp[2] << 16) | ((uint64_t)bp[3] << 24)
+         | ((uint64_t)bp[4] << 32) | ((uint64_t)bp[5] << 40) | ((uint64_t)bp[6] << 48) | ((uint64_t)bp[7] << 56);
+}
 
-    char    *cp, *start, *end;
-    int64_t  next;
-    int      digit, temp;
+static BOOL _ion_is_8_digits(uint64_t chars)
+{
+    // adding 0x46 carries into the high bit for bytes above '9'; subtracting 0x30 borrows for bytes below '0'
+    return (((chars + 0x4646464646464646ULL) | (chars - 0x3030303030303030ULL)) & 0x8080808080808080ULL) == 0;
+}
 
-    cp = dst_buf;
-    end = dst_buf + buf_length;
-    if (val < 0) {
-        if (cp >= end) goto overflow;
-        *cp++ = '-';
-        val = -val;
+static uint32_t _ion_parse_8_digits(uint64_t chars)
+{
+    const uint64_t mask = 0x000000FF000000FFULL;
+    const uint64_t mul1 = 0x000F424000000064ULL; // 100 + (1000000 << 32)
+    const uint64_t mul2 = 0x0000271000000001ULL; // 1 + (10000 << 32)
+
+    chars -= 0x3030303030303030ULL;
+    chars = (chars * 10) + (chars >> 8); // adjacent digits combined into 2-digit values
+    chars = (((chars & mask) * mul1) + (((chars >> 16) & mask) * mul2)) >> 32;
+    return (uint32_t)chars;
+}
+
+BOOL _ion_decimal_digits_to_uint64(const char *cp, SIZE length, uint64_t *p_value)
+{
+    const char *limit = cp + length;
+    uint64_t    value = 0, chars;
+    int         digit, consumed = 0;
+
+    if (length <= 0) return FALSE;
+
+    // leading zeros never overflow, skip them so they don't count against the 20 digit limit below
+    while (limit - cp > 1 && *cp == '0') cp++;
+    if (limit - cp > 20) return FALSE;
+
+    // the first 19 digits can't overflow, so they're consumed 8 at a time without checks
+    while (limit - cp >= 8 && consumed + 8 <= 19) {
+        chars = _ion_load_8_chars(cp);
+        if (!_ion_is_8_digits(chars)) return FALSE;
+        value = value * 100000000 + _ion_parse_8_digits(chars);
+        cp += 8;
+        consumed += 8;
+    }
+    for (; cp < limit; cp++) {
+        digit = *cp - '0';
+        if (digit < 0 || digit > 9) return FALSE;
+        if (value > (UINT64_MAX - (uint64_t)digit) / 10) return FALSE;
+        value = value * 10 + (uint64_t)digit;
     }
+    *p_value = value;
+    return TRUE;
+}
+
+#define ION_HASH_P0 0xa0761d6478bd642fULL
+#define ION_HASH_P1 0xe7037ed1a0b428dbULL
 
-    // record where the first digit goes
-    if (val == 0) {
-        if (cp >= end) goto overflow;
-        *cp++ = '0';
-        *cp = '\0';
+static uint64_t _ion_load_4_chars(const char *cp)
+{
+    const BYTE *bp = (const BYTE *)cp;
+    return (uint64_t)bp[0] | ((uint64_t)bp[1] << 8) | ((uint64_t)bp[2] << 16) | ((uint64_t)bp[3] << 24);
+}
+
+// multiplies into 128 bits and folds the halves together
+static uint64_t _ion_hash_mix(uint64_t a, uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+#else
+    uint64_t ha = a >> 32, la = (uint32_t)a, hb = b >> 32, lb = (uint32_t)b;
+    uint64_t hh = ha * hb, hl = ha * lb, lh = la * hb, ll = la * lb;
+    uint64_t mid = (ll >> 32) + (uint32_t)hl + (uint32_t)lh;
+    uint64_t lo = (mid << 32) | (uint32_t)ll;
+    uint64_t hi = hh + (hl >> 32) + (lh >> 32) + (mid >> 32);
+    return lo ^ hi;
+#endif
+}
+
+uint64_t _ion_hash_bytes(const BYTE *bytes, SIZE length, uint64_t seed)
+{
+    const char *cp = (const char *)bytes;
+    SIZE        remaining = length;
+    uint64_t    a, b;
+
+    seed ^= _ion_hash_mix(seed ^ ION_HASH_P0, ION_HASH_P1);
+    if (length <= 16) {
+        if (length >= 4) {
+            // two (possibly overlapping) pairs of 4-byte loads cover every byte
+            a = (_ion_load_4_chars(cp) << 32) | _ion_load_4_chars(cp + ((length >> 3) << 2));
+            b = (_ion_load_4_chars(cp + length - 4) << 32) | _ion_load_4_chars(cp + length - 4 - ((length >> 3) << 2));
+        }
+        else if (length > 0) {
+            a = ((uint64_t)bytes[0] << 16) | ((uint64_t)bytes[length >> 1] << 8) | bytes[length - 1];
+            b = 0;
+        }
+        else {
+            a = b = 0;
+        }
     }
     else {
-        start = cp;
-        while (val > 0) {
-            next = val / 10;
-            digit = (int)(val - next);
-            if (cp >= end) goto overflow;
-            *cp++ = digit + '0';
-            val = next;
-        }
-        if (cp >= end) goto overflow;
-        *cp = '\0';
-
-        // reverse the digits
-        while (start < cp) {
-            temp = *start;
-            *start = *cp;
-            *cp = temp;
-            cp--;
-            start++;
+        while (remaining > 16) {
+            seed = _ion_hash_mix(_ion_load_8_chars(cp) ^ ION_HASH_P1, _ion_load_8_chars(cp + 8) ^ seed);
+            cp += 16;
+            remaining -= 16;
         }
+        // the last 16 bytes, which may overlap bytes already consumed
+        a = _ion_load_8_chars(cp + remaining - 16);
+        b = _ion_load_8_chars(cp + remaining - 8);
     }
-
-    return dst_buf;
-
-overflow:
-    assert(cp < end && "buffer overflow in local itoa!");
-    return NULL; // this should force a null pointer exception in the caller
+    return _ion_hash_mix(ION_HASH_P1 ^ (uint64_t)length, _ion_hash_mix(a ^ ION_HASH_P1, b ^ seed));
 }
 
 SIZE _ion_strnlen(const char *str, const SIZE maxlen) {
@@ -526,3 +614,43 @@ iERR cast_to_int64(uint64_t unsignedInt64Value, BOOL is_negative, int64_t* int64
     }
     iRETURN;
 }
+
+SIZE _ion_base64_encode_triples(const BYTE *src, SIZE triples, char *dst)
+{
+    const char *alphabet = _Ion_base64_chars;
+    char       *cp = dst;
+    uint32_t    triple;
+
+    while (triples-- > 0) {
+        triple = ((uint32_t)src[0] << 16) | ((uint32_t)src[1] << 8) | (uint32_t)src[2];
+        cp[0] = alphabet[(triple >> 18) & 0x3F];
+        cp[1] = alphabet[(triple >> 12) & 0x3F];
+        cp[2] = alphabet[(triple >>  6) & 0x3F];
+        cp[3] = alphabet[ triple        & 0x3F];
+        src += 3;
+        cp += 4;
+    }
+    return (SIZE)(cp - dst);
+}
+
+SIZE _ion_base64_decode_quads(const BYTE *src, SIZE max_quads, BYTE *dst)
+{
+    SIZE    quads;
+    int32_t a, b, c, d, quad;
+
+    for (quads = 0; quads < max_quads; quads++) {
+        a = _Ion_base64_value[src[0]];
+        b = _Ion_base64_value[src[1]];
+        c = _Ion_base64_value[src[2]];
+        d = _Ion_base64_value[src[3]];
+        // invalid characters (including whitespace and padding) are -1, so one test covers all four
+        if ((a | b | c | d) < 0) break;
+        quad = (a << 18) | (b << 12) | (c << 6) | d;
+        dst[0] = (BYTE)(quad >> 16);
+        dst[1] = (BYTE)(quad >> 8);
+        dst[2] = (BYTE)quad;
+        src += 4;
+        dst += 3;
+    }
+    return quads;
+}
@@ -64,6 +64,26 @@ ION_API_EXPORT const char *ion_error_to_str(iERR err);
 char *_ion_itoa_10(int32_t val, char *dst, SIZE len);
 char *_ion_i64toa_10(int64_t val, char *dst, SIZE len);
 
+// writes the base-10 digits of value to dst, which must hold MAX_INT64_LENGTH chars,
+// and returns how many were written. No null terminator is written.
+SIZE _ion_u64toa_10_unterminated(uint64_t value, char *dst);
+
+// parses length base-10 digits (no sign) into *p_value. Returns FALSE if a non-digit is
+// found or the value doesn't fit in 64 bits.
+BOOL _ion_decimal_digits_to_uint64(const char *cp, SIZE length, uint64_t *p_value);
+
+// base64 block kernels. encode writes 4 chars for each of the triples 3-byte groups in src
+// and returns the number of chars written. decode converts consecutive 4-char groups from src
+// into 3 bytes each, stopping after max_quads groups or before the first group that contains
+// anything other than a base64 alphabet character (whitespace, padding, ...); it returns the
+// number of groups decoded.
+SIZE _ion_base64_encode_triples(const BYTE *src, SIZE triples, char *dst);
+SIZE _ion_base64_decode_quads(const BYTE *src, SIZE max_quads, BYTE *dst);
+
+// hashes length bytes a word at a time (wyhash style) into a full 64-bit value. Equal byte
+// sequences hash equally for equal seeds.
+uint64_t _ion_hash_bytes(const BYTE *bytes, SIZE length, uint64_t seed);
+
 // utility for portable strnlen
 ION_API_EXPORT SIZE _ion_strnlen(const char *str, const SIZE maxlen);
 
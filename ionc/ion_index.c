@@ -14,13 +14,14 @@
 
 /*
  * these function provide indexed collections used for symbol support
- * in Ion.c.  These follow the collection pattern and use the base
- * collection heavily.  And, like ion_index, the memory used 
- * for the nodes is allocated on the parent, which is passed in when 
+ * in Ion.c.  Like ion_collection, the memory used for the slot
+ * table is allocated on the parent, which is passed in when
  * the user initializes an index.
  *
- * each collections holds a high water mark free list of nodes that
- * were previously used but aren't currently being used
+ * the index is an open addressing hash table using robin hood
+ * probing: each slot holds the key's hash inline next to the key
+ * and data pointers in a single flat array, so a lookup is a run
+ * of adjacent slots rather than a walk of a chain of nodes.
  *
  * index supports:
  *    iERR  initialize(ION_INDEX *idx, CMP_FN cmp, HASH_FN hash)
@@ -30,30 +31,37 @@
  *    BOOL  upsert    (void *key, void *data)
  *    void  delete    (void *key)
  *    void  reset     ()
- *    void  release   ()
  *
  * unlike collection index expects the caller to own the key and
  * the data objects and index itself only maintains the additional
  * data to manage these functions.
  *
- * there are also cursor macros that mirror the collection cursors
- *
  * to define the index comparison behavior the user supplies a
  * compare function and a hash function
  */
 
 #include "ion_internal.h"
 
-static inline size_t _ion_index_hash_to_bucket_index(ION_INDEX* index, ION_INDEX_NODE* node) {
-    return ((size_t) node->_hash) % index->_bucket_count;
+// Fibonacci hashing: the multiply spreads the caller's hash (which may be as weak as an
+// identity function over sequential page ids) across the high bits, which pick the slot.
+#define II_HASH_MULTIPLIER 0x9E3779B9u
+
+static inline uint32_t _ion_index_home_slot(ION_INDEX *index, uint32_t hash) {
+    return (uint32_t)(hash * II_HASH_MULTIPLIER) >> index->_slot_shift;
+}
+
+// how far the entry in slot ii has been displaced from its home slot
+static inline uint32_t _ion_index_probe_distance(ION_INDEX *index, uint32_t ii) {
+    return (ii - _ion_index_home_slot(index, index->_slots[ii]._hash)) & (uint32_t)(index->_slot_count - 1);
 }
 
 // local functions forward declarations
 iERR  _ion_index_set_options_helper(ION_INDEX *index, ION_INDEX_OPTIONS *p_options);
 
-ION_INDEX_NODE **_ion_index_get_bucket_helper(ION_INDEX *index, ION_INDEX_NODE *key);
-BOOL             _ion_index_scan_bucket_helper(ION_INDEX *index, ION_INDEX_NODE *head, ION_INDEX_NODE *node, ION_INDEX_NODE **p_found, ION_INDEX_NODE **p_prev);
-iERR             _ion_index_insert_helper(ION_INDEX *index, void *key, void *data, ION_INDEX_NODE **p_new_node);
+uint32_t        _ion_index_hash_helper(ION_INDEX *index, void *key);
+ION_INDEX_SLOT *_ion_index_find_slot_helper(ION_INDEX *index, void *key, uint32_t hash);
+void            _ion_index_place_helper(ION_INDEX *index, ION_INDEX_SLOT *entry);
+iERR            _ion_index_insert_helper(ION_INDEX *index, void *key, void *data, ION_INDEX_SLOT **p_slot);
 
 
 // actual index functions
@@ -70,8 +78,6 @@ iERR  _ion_index_initialize(ION_INDEX *index, ION_INDEX_OPTIONS *p_options)
         IONCHECK(_ion_index_set_options_helper(index, p_options));
     }
 
-    _ion_collection_initialize(index->_memory_owner, &index->_nodes, sizeof(ION_INDEX_NODE));
-
     if (p_options && p_options->_initial_size) {
         IONCHECK(_ion_index_make_room(index, p_options->_initial_size));
     }
@@ -82,110 +88,78 @@ iERR  _ion_index_initialize(ION_INDEX *index, ION_INDEX_OPTIONS *p_options)
 iERR _ion_index_make_room(ION_INDEX *index, int32_t expected_new)
 {
     iENTER;
-    int32_t          new_key_threshold, new_bucket_count, old_bucket_count;
-    ION_INDEX_NODE **new_table, **old_table;
-    ION_INDEX_NODE  *node, *next;
-    int32_t          ii, in_use;
-    size_t           jj;
+    int32_t         new_key_threshold, new_slot_count, new_slot_shift, old_slot_count;
+    ION_INDEX_SLOT *old_slots;
+    int32_t         ii;
 
     if (!index) FAILWITH(IERR_INVALID_ARG);
 
-    if (expected_new  + index->_key_count < index->_grow_at) {
+    if (expected_new + index->_key_count <= index->_grow_at) {
         SUCCEED();
     }
 
-    // key count <= bucket * (_grow_density_percent/100)
-    // bucket count = ( key count * 100 ) / _grow_density_percent
-    new_key_threshold  = index->_key_count + expected_new;
-    new_key_threshold *= 128; // _grow_density_percent really is whole percent
-    new_key_threshold /= index->_density_target_percent_128x;
-
-    // turn this into the desired bucket size
-    new_bucket_count = index->_grow_at;
-    if (new_bucket_count < II_DEFAULT_MINIMUM) new_bucket_count = II_DEFAULT_MINIMUM;
-    while(new_bucket_count < new_key_threshold) {
-        II_GROW(new_bucket_count);
-        ASSERT(new_bucket_count);
+    // key count <= slot count * (_density_target_percent_128x / 128)
+    new_key_threshold = index->_key_count + expected_new;
+
+    // turn this into the desired (power of 2) slot count
+    new_slot_count = (index->_slot_count < II_DEFAULT_MINIMUM) ? II_DEFAULT_MINIMUM : index->_slot_count;
+    new_slot_shift = 32 - 4; // log2(II_DEFAULT_MINIMUM)
+    for (ii = new_slot_count; ii > II_DEFAULT_MINIMUM; ii >>= 1) {
+        new_slot_shift--;
+    }
+    while ((int64_t)new_slot_count * index->_density_target_percent_128x / 128 < new_key_threshold) {
+        if (new_slot_count > (INT32_MAX >> 1)) FAILWITH(IERR_NO_MEMORY);
+        new_slot_count <<= 1;
+        new_slot_shift--;
     }
 
-    // grow the bucket
-    old_table = index->_bucket_table;
+    old_slots = index->_slots;
+    old_slot_count = index->_slot_count;
     IONCHECK(_ion_index_grow_array(
-                 (void**)&index->_bucket_table
-                 ,index->_bucket_count
-                 ,new_bucket_count
-                 ,sizeof(ION_INDEX_NODE)
+                 (void**)&index->_slots
+                 ,0
+                 ,new_slot_count
+                 ,sizeof(ION_INDEX_SLOT)
                  ,FALSE
                  ,index->_memory_owner
     ));
-    
-    // now resplit the buckets
-    new_table = index->_bucket_table;
-    old_bucket_count = index->_bucket_count;
-    index->_bucket_count = new_bucket_count;
-
-    in_use = 0;
-    for (ii=0; ii<old_bucket_count; ii++) {
-        node = old_table[ii];
-        while(node) {
-            next = node->_next;
-            jj = _ion_index_hash_to_bucket_index( index, node );
-            if (new_table[jj] == NULL) {
-                in_use++;
-            }
-            node->_next = new_table[jj];
-            new_table[jj] = node;
-            node = next;
+    index->_slot_count = new_slot_count;
+    index->_slot_shift = new_slot_shift;
+
+    // now rehash the existing entries into the new table, the hashes are
+    // stored in the slots so the callers hash function isn't needed
+    for (ii = 0; ii < old_slot_count; ii++) {
+        if (old_slots[ii]._hash) {
+            _ion_index_place_helper(index, &old_slots[ii]);
         }
     }
-    index->_bucket_in_use_count = in_use;
-    index->_bucket_count = new_bucket_count;
 
-    // next threshold
-    II_GROW(new_bucket_count);
-    index->_grow_at = new_bucket_count;
+    // next threshold, there is always at least one empty slot to end a probe
+    index->_grow_at = (int32_t)((int64_t)new_slot_count * index->_density_target_percent_128x / 128);
+    if (index->_grow_at >= new_slot_count) index->_grow_at = new_slot_count - 1;
 
     iRETURN;
 }
 
 BOOL  _ion_index_exists(ION_INDEX *index, void *key)
 {
-    BOOL exists;
-    ION_INDEX_NODE   node;
-    ION_INDEX_NODE  *entry, *prev;
-    ION_INDEX_NODE **bucket;
-
-    memset(&node, 0, sizeof(node));
-    node._key = key;
-    bucket = _ion_index_get_bucket_helper(index, &node);
-    if (!bucket || !(*bucket)) return FALSE;
-    
-    exists = _ion_index_scan_bucket_helper(index, *bucket, &node, &entry, &prev);
-    return exists;
+    return (_ion_index_find_slot_helper(index, key, _ion_index_hash_helper(index, key)) != NULL);
 }
 
 void *_ion_index_find(ION_INDEX *index, void *key)
 {
-    BOOL exists;
-    ION_INDEX_NODE   node;
-    ION_INDEX_NODE  *entry, *prev;
-    ION_INDEX_NODE **bucket;
-
-    memset(&node, 0, sizeof(node));
-    node._key = key;
-    bucket = _ion_index_get_bucket_helper(index, &node);
-    if (!bucket || !(*bucket)) return NULL;
-
-    exists = _ion_index_scan_bucket_helper(index, *bucket, &node, &entry, &prev);
-    return exists ? entry->_data : NULL;
+    ION_INDEX_SLOT *slot;
+
+    slot = _ion_index_find_slot_helper(index, key, _ion_index_hash_helper(index, key));
+    return slot ? slot->_data : NULL;
 }
 
 iERR _ion_index_insert(ION_INDEX *index, void *key, void *data)
 {
     iENTER;
-    ION_INDEX_NODE *entry;
+    ION_INDEX_SLOT *slot;
 
-    err = _ion_index_insert_helper(index, key, data, &entry);
+    err = _ion_index_insert_helper(index, key, data, &slot);
     if (err == IERR_KEY_ALREADY_EXISTS) DONTFAILWITH(err);
     IONCHECK(err);
 
@@ -195,11 +169,11 @@ iERR _ion_index_insert(ION_INDEX *index, void *key, void *data)
 iERR _ion_index_upsert(ION_INDEX *index, void *key, void *data)
 {
     iENTER;
-    ION_INDEX_NODE *entry;
+    ION_INDEX_SLOT *slot;
 
-    err = _ion_index_insert_helper(index, key, data, &entry);
+    err = _ion_index_insert_helper(index, key, data, &slot);
     if (err == IERR_KEY_ALREADY_EXISTS) {
-        entry->_data = data;
+        slot->_data = data;
         SUCCEED(); // which will clear the already exists "error"
     }
     IONCHECK(err);
@@ -210,58 +184,44 @@ iERR _ion_index_upsert(ION_INDEX *index, void *key, void *data)
 void _ion_index_delete(ION_INDEX *index, void *key, void **p_data)
 {
 //  iENTER;
-    ION_INDEX_NODE   node;
-    ION_INDEX_NODE  *entry, *prev;
-    ION_INDEX_NODE **bucket;
+    ION_INDEX_SLOT *slot;
+    uint32_t        ii, next, mask;
 
+    *p_data = NULL;
     if (index->_key_count < 1) return;
 
-    node._key = key;
-    bucket = _ion_index_get_bucket_helper(index, &node);
-
-    ASSERT(bucket); // there are some keys, there should be bucket table at least
-    if (!_ion_index_scan_bucket_helper(index, *bucket, &node, &entry, &prev)) {
-        *p_data = NULL;
-        return;
-    }
-    ASSERT(entry);
-    *p_data = entry->_data; // while we still have it around
-
-    // remove this from the list
-    if (prev) {
-        prev->_next = entry->_next;
-        entry->_next = NULL; // just because this might get reused
-    }
-    else {
-        *bucket = entry->_next;
-        if (!entry->_next) index->_bucket_in_use_count--;
+    slot = _ion_index_find_slot_helper(index, key, _ion_index_hash_helper(index, key));
+    if (!slot) return;
+    *p_data = slot->_data; // while we still have it around
+
+    // backward shift deletion: pull the following displaced entries
+    // one slot closer to home, which keeps probe sequences unbroken
+    // without leaving tombstones behind
+    mask = (uint32_t)(index->_slot_count - 1);
+    ii = (uint32_t)(slot - index->_slots);
+    for (;;) {
+        next = (ii + 1) & mask;
+        if (!index->_slots[next]._hash || _ion_index_probe_distance(index, next) == 0) break;
+        index->_slots[ii] = index->_slots[next];
+        ii = next;
     }
+    memset(&index->_slots[ii], 0, sizeof(ION_INDEX_SLOT));
     index->_key_count--;
 
-    _ion_collection_remove(&index->_nodes, entry);
-
     return;
 }
 
 void _ion_index_reset(ION_INDEX *index)
 {
-    int32_t table_size;
-
     ASSERT(index);
 
     if (index->_key_count < 1) return;
 
-    _ion_collection_reset(&index->_nodes);
-    table_size = index->_bucket_count * sizeof(ION_INDEX_NODE *);
-    if (table_size > 0) {
-        memset(index->_bucket_table, 0, table_size);
-    }
+    memset(index->_slots, 0, index->_slot_count * sizeof(ION_INDEX_SLOT));
     index->_key_count = 0;
-    index->_bucket_in_use_count = 0;
     return;
 }
 
-
 // really a local helper function, but it'll probably be useful
 // for the sid to symbol array as well
 iERR _ion_index_grow_array(void **p_array, int32_t old_count, int32_t new_count, int32_t entry_size, BOOL with_copy, void *owner)
@@ -295,6 +255,7 @@ iERR _ion_index_grow_array(void **p_array, int32_t old_count, int32_t new_count,
 iERR _ion_index_set_options_helper(ION_INDEX *index, ION_INDEX_OPTIONS *p_options)
 {
     iENTER;
+    int32_t density_128x;
 
     if (!p_options)              FAILWITH(IERR_INVALID_ARG);
     if (!p_options->_compare_fn) FAILWITH(IERR_INVALID_ARG);
@@ -306,8 +267,10 @@ iERR _ion_index_set_options_helper(ION_INDEX *index, ION_INDEX_OPTIONS *p_option
     index->_fn_context = p_options->_fn_context;
 
     if (p_options->_density_target_percent) {
-        index->_density_target_percent_128x  = p_options->_density_target_percent * 100;
-        index->_density_target_percent_128x /= 128;
+        density_128x = (p_options->_density_target_percent * 128) / 100;
+        if (density_128x > II_MAXIMUM_128X_PERCENT) density_128x = II_MAXIMUM_128X_PERCENT;
+        if (density_128x < 1) density_128x = 1;
+        index->_density_target_percent_128x = (uint8_t)density_128x;
     }
     else {
         index->_density_target_percent_128x = II_DEFAULT_128X_PERCENT;
@@ -316,85 +279,86 @@ iERR _ion_index_set_options_helper(ION_INDEX *index, ION_INDEX_OPTIONS *p_option
     iRETURN;
 }
 
-// gets the initial bucket pointer and fills in the hash
-ION_INDEX_NODE **_ion_index_get_bucket_helper(ION_INDEX *index, ION_INDEX_NODE *node)
+// computes the stored form of the key's hash, 0 is reserved for empty slots
+uint32_t _ion_index_hash_helper(ION_INDEX *index, void *key)
 {
-    node->_hash = (*index->_hash_fn)(node->_key, index->_fn_context);
-
-    if (!index->_bucket_count) return NULL;
-    size_t bucket_index = _ion_index_hash_to_bucket_index( index, node );
-
-    return index->_bucket_table + bucket_index;
+    uint32_t hash = (uint32_t)(*index->_hash_fn)(key, index->_fn_context);
+    return hash ? hash : 1;
 }
 
-BOOL _ion_index_scan_bucket_helper(
-     ION_INDEX *index
-    ,ION_INDEX_NODE *head
-    ,ION_INDEX_NODE *node
-    ,ION_INDEX_NODE **p_found
-    ,ION_INDEX_NODE **p_prev
-)
+ION_INDEX_SLOT *_ion_index_find_slot_helper(ION_INDEX *index, void *key, uint32_t hash)
 {
-    int_fast8_t cmp;
-    ION_INDEX_NODE *entry = NULL;
-    ION_INDEX_NODE *prev = NULL;
-
-
-    ASSERT(p_found);
-    ASSERT(p_prev);
-
-    if (!head) goto return_values;  
-
-    for (entry = head; entry; prev = entry, entry = entry->_next) {
-        if (entry->_hash != node->_hash) continue;
-        cmp = (*index->_compare_fn)(entry->_key, node->_key, index->_fn_context);
-        if (cmp == 0) break;
+    ION_INDEX_SLOT *slot;
+    uint32_t        ii, distance, mask;
+
+    if (!index->_key_count) return NULL;
+
+    mask = (uint32_t)(index->_slot_count - 1);
+    ii = _ion_index_home_slot(index, hash);
+    for (distance = 0; ; distance++, ii = (ii + 1) & mask) {
+        slot = &index->_slots[ii];
+        if (!slot->_hash) break;
+        // robin hood invariant: had the key been present it would have displaced
+        // any entry closer to its own home than we are to ours
+        if (distance > _ion_index_probe_distance(index, ii)) break;
+        if (slot->_hash == hash && (*index->_compare_fn)(slot->_key, key, index->_fn_context) == 0) {
+            return slot;
+        }
     }
-    goto return_values;
-
-return_values:
-    *p_found = entry;
-    *p_prev = prev;
-    return (entry != NULL);
+    return NULL;
 }
 
-iERR _ion_index_insert_helper(ION_INDEX *index, void *key, void *data, ION_INDEX_NODE **p_new_node)
+// puts an entry known not to be present into the table, which must have a free slot
+void _ion_index_place_helper(ION_INDEX *index, ION_INDEX_SLOT *entry)
 {
-    iENTER;
-    ION_INDEX_NODE   node;
-    ION_INDEX_NODE  *entry, *found, *prev;
-    ION_INDEX_NODE **bucket;
-
-    // we pre-grow the bucket table so we can't avoid
-    // the "no table" edge cases - including the bucket table moving
-    if (index->_key_count + 1 >= index->_grow_at) {
-        // if this is an EMTPY index we make room for default
-        // otherwise we just need room for the 1 key
-        IONCHECK(_ion_index_make_room(index, index->_bucket_count ? 1 : II_DEFAULT_MINIMUM));
+    ION_INDEX_SLOT  carry, temp;
+    uint32_t        ii, distance, existing, mask;
+
+    carry = *entry;
+    mask = (uint32_t)(index->_slot_count - 1);
+    ii = _ion_index_home_slot(index, carry._hash);
+    for (distance = 0; ; distance++, ii = (ii + 1) & mask) {
+        if (!index->_slots[ii]._hash) {
+            index->_slots[ii] = carry;
+            return;
+        }
+        existing = _ion_index_probe_distance(index, ii);
+        if (existing < distance) {
+            // take from the rich: the resident is closer to home, so it moves on instead
+            temp = index->_slots[ii];
+            index->_slots[ii] = carry;
+            carry = temp;
+            distance = existing;
+        }
     }
+}
 
-    node._key = key;
-    bucket = _ion_index_get_bucket_helper(index, &node);
+iERR _ion_index_insert_helper(ION_INDEX *index, void *key, void *data, ION_INDEX_SLOT **p_slot)
+{
+    iENTER;
+    ION_INDEX_SLOT  entry;
+    ION_INDEX_SLOT *found;
 
-    ASSERT(bucket); // since we forced buckets to exist
-    if (_ion_index_scan_bucket_helper(index, *bucket, &node, &found, &prev)) {
-        *p_new_node = found;
+    entry._hash = _ion_index_hash_helper(index, key);
+    found = _ion_index_find_slot_helper(index, key, entry._hash);
+    if (found) {
+        *p_slot = found;
         DONTFAILWITH(IERR_KEY_ALREADY_EXISTS);
     }
 
-    // it's not there so we can add this key to the bucket
-    entry = (ION_INDEX_NODE *)_ion_collection_append(&index->_nodes);
-    if (!entry) FAILWITH(IERR_NO_MEMORY);
-    entry->_hash = node._hash;
-    entry->_key  = key;
-    entry->_data = data;
-    if (!*bucket) {
-        index->_bucket_in_use_count++;
+    // we pre-grow the slot table so we can't hit the "no table" or
+    // "no free slot" edge cases
+    if (index->_key_count + 1 > index->_grow_at) {
+        // if this is an EMTPY index we make room for default
+        // otherwise we just need room for the 1 key
+        IONCHECK(_ion_index_make_room(index, index->_slot_count ? 1 : II_DEFAULT_MINIMUM));
     }
-    entry->_next = *bucket;
-    *bucket = entry;
+
+    entry._key  = key;
+    entry._data = data;
+    _ion_index_place_helper(index, &entry);
     index->_key_count++;
-    *p_new_node = entry;
+    *p_slot = NULL; // the entry may have moved on during placement
 
     iRETURN;
 }
@@ -14,13 +14,14 @@
 
 /*
  * this helps define indexed collections used for symbol support
- * in Ion.c.  These follow the collection pattern and use the base
- * collection heavily.  And, like ion_index, the memory used 
- * for the nodes is allocated on the parent, which is passed in when 
+ * in Ion.c.  Like ion_collection, the memory used for the slot
+ * table is allocated on the parent, which is passed in when
  * the user initializes an index.
  *
- * each collections holds a high water mark free list of nodes that
- * were previously used but aren't currently being used
+ * the index is an open addressing hash table using robin hood
+ * probing: each slot holds the key's hash inline next to the key
+ * and data pointers in a single flat array, so a lookup is a run
+ * of adjacent slots rather than a walk of a chain of nodes.
  *
  * index supports:
  *    iERR  initialize(ION_INDEX *idx, CMP_FN cmp, HASH_FN hash)
@@ -30,14 +31,11 @@
  *    BOOL  upsert    (void *key, void *data)
  *    void  delete    (void *key)
  *    void  reset     ()
- *    void  release   ()
  *
  * unlike collection index expects the caller to own the key and
  * the data objects and index itself only maintains the additional
  * data to manage these functions.
  *
- * there are also cursor macros that mirror the collection cursors
- *
  * to define the index comparison behavior the user supplies a
  * compare function and a hash function
  */
@@ -53,7 +51,8 @@ typedef int_fast8_t  (*II_COMPARE_FN)(void *key1, void *key2, void *context);
 typedef int_fast32_t (*II_HASH_FN)   (void *key, void *context);
 
 #define II_DEFAULT_128X_PERCENT 104 /* 80% pre-converted to "base 128 percent" */
-#define II_DEFAULT_MINIMUM       16 /* net desired buckets */
+#define II_MAXIMUM_128X_PERCENT 115 /* 90%, probe sequences get long past this */
+#define II_DEFAULT_MINIMUM       16 /* net desired slots, must be a power of 2 */
 
 typedef struct _ion_index_options ION_INDEX_OPTIONS;
 struct _ion_index_options
@@ -63,21 +62,18 @@ struct _ion_index_options
     II_HASH_FN     _hash_fn;
     void          *_fn_context;
     int32_t        _initial_size;  /* number of actual keys */
-    uint8_t        _density_target_percent; /* whole percent for table size increases 200% is usual (and default) */
+    uint8_t        _density_target_percent; /* whole percent of slots in use before the table doubles, 80% is the default */
 
 };
 
-// the node allocation scheme depends on this
-// layout - currently that there are only 2 members
-// so it uses the size of the ptr as the base to 
-// allocate
-typedef struct _ion_index_node ION_INDEX_NODE;
-struct _ion_index_node
+// an empty slot has a _hash of 0, hash values are adjusted
+// to never be 0 when they're stored
+typedef struct _ion_index_slot ION_INDEX_SLOT;
+struct _ion_index_slot
 {
-    int_fast32_t    _hash;
+    uint32_t        _hash;
     void           *_key;
     void           *_data;
-    ION_INDEX_NODE *_next;
 };
 
 typedef struct _ion_index ION_INDEX;
@@ -90,38 +86,18 @@ struct _ion_index
     uint8_t         _density_target_percent_128x;
 
     int32_t         _key_count;
-    int32_t         _bucket_count;
-    int32_t         _bucket_in_use_count;  // watch for bad distribution
+    int32_t         _slot_count;  // always 0 or a power of 2
+    int32_t         _slot_shift;  // 32 - log2(_slot_count), maps a hash to its home slot
     int32_t         _grow_at;
-    ION_INDEX_NODE**_bucket_table;
-    ION_COLLECTION  _nodes;
+    ION_INDEX_SLOT *_slots;
 
 };
 
-GLOBAL int32_t g_ion_index_multiplier_x128 INITTO(2*128);
-
-#define II_GROW(x)                          \
-    do {                                    \
-        (x) *= g_ion_index_multiplier_x128; \
-        (x) /= 128;                         \
-   } while (0)
-
 // BOOL ion_index_is_empty(ION_INDEX *index)
 #define ION_INDEX_IS_EMPTY(index)       (ION_INDEX_SIZE(index) == 0)
 
 // SIZE count = ion_index_size(ION_INDEX *index)
-#define ION_INDEX_SIZE(index)           ((index)->_count)
-
-typedef struct _ion_index_node *ION_INDEX_CURSOR;
-
-// ION_INDEX_CURSOR pcursor = ion_index_open(ION_INDEX *collection)
-#define ION_INDEX_OPEN(index, pcursor)  ION_COLLECTION_OPEN(&(index)->_nodes, pcursor)
-
-// void *pbuf = ion_index_next(ION_INDEX_CURSOR *pcursor)
-#define ION_INDEX_NEXT(index, pbuf)     ION_COLECTION_NEXT( &(index)->_nodes, pbuf )
-
-// ION_INDEX_CURSOR *pcursor = ion_index_close();
-#define ION_INDEX_CLOSE(pcursor)        ION_COLLECTION_CLOSE( pcursor )
+#define ION_INDEX_SIZE(index)           ((index)->_key_count)
 
 iERR  _ion_index_initialize(ION_INDEX *index, ION_INDEX_OPTIONS *p_options);
 iERR  _ion_index_make_room(ION_INDEX *index, int32_t expected_new);
@@ -132,7 +108,6 @@ iERR  _ion_index_insert    (ION_INDEX *index, void *key, void *data);
 iERR  _ion_index_upsert    (ION_INDEX *index, void *key, void *data);
 void  _ion_index_delete    (ION_INDEX *index, void *key, void **p_data);
 void  _ion_index_reset     (ION_INDEX *index);
-void  _ion_index_release   (ION_INDEX *index);
 
 iERR _ion_index_grow_array(void **p_array, int32_t old_count, int32_t new_count, int32_t entry_size, BOOL with_copy, void *owner);
 
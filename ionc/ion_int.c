@@ -1142,8 +1142,7 @@ void * _ion_int_realloc_helper(void *value, SIZE old_len, void *owner, SIZE new_
 {
     if (old_len < new_len) {
         if (!owner) {
-            if (value) ion_xfree(value);
-            value = ion_xalloc(new_len);
+            value = ion_xrealloc(value, (size_t)old_len, (size_t)new_len);
         }
         else {
             value = ion_alloc_with_owner(owner, new_len);
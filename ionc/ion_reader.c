@@ -48,7 +48,7 @@ iERR _ion_reader_open_buffer_helper(ION_READER **p_preader, BYTE *buffer, SIZE b
     IONCHECK(_ion_reader_make_new_reader(p_options, &preader));
 
     // set up the stream for use
-    IONCHECK(ion_stream_open_buffer(buffer, buf_length, buf_length, TRUE, &preader->istream));
+    IONCHECK(_ion_stream_open_buffer_helper(buffer, buf_length, buf_length, TRUE, preader->options.allocator, &preader->istream));
     preader->_reader_owns_stream = TRUE;
 
     // since the user gave use the whole input in a single buffer this makes it available
@@ -92,7 +92,7 @@ iERR ion_reader_reset_stream_with_length(hREADER   *p_hreader
     IONCHECK(_ion_reader_free_local_symbol_table(*p_hreader));
 
     // initialize given stream with handler
-    ion_stream_open_handler_in(fn_input_handler, handler_state, &pstream);
+    _ion_stream_open_handler_in_helper(fn_input_handler, handler_state, (*p_hreader)->options.allocator, &pstream);
     (*p_hreader)->istream = pstream;
 
     // We need to free any digit space that has been allocated without an
@@ -118,7 +118,8 @@ iERR ion_reader_reset_stream_with_length(hREADER   *p_hreader
     // Parser will subsequently return EOF when "length" number of bytes is reached.
     switch((*p_hreader)->type) {
         case ion_type_text_reader:
-            IONCHECK(_ion_reader_text_open(*p_hreader));
+            (*p_hreader)->typed_reader.text._scanner._stream = pstream;
+            IONCHECK(_ion_reader_text_reset(*p_hreader, tid_DATAGRAM, local_end));
             break;
         case ion_type_binary_reader:
             IONCHECK(_ion_reader_binary_reset((*p_hreader), tid_DATAGRAM, 0, local_end));
@@ -139,7 +140,6 @@ iERR ion_reader_reset_stream(hREADER *p_hreader, void *handler_state, ION_STREAM
     iENTER;
     ION_STREAM *pstream;
     BYTE  ivm_buffer[ION_VERSION_MARKER_LENGTH];
-    BOOL is_binary_stream;
     int  b, pos, ii;
 
     if(!p_hreader)        FAILWITH(IERR_INVALID_ARG);
@@ -149,13 +149,11 @@ iERR ion_reader_reset_stream(hREADER *p_hreader, void *handler_state, ION_STREAM
     ion_stream_close(pstream);
     pstream = NULL;
 
-    IONCHECK(_ion_reader_reset_temp_pool(*p_hreader));
-    IONCHECK(_ion_reader_free_local_symbol_table(*p_hreader));
-
     // initialize given stream with handler
-    ion_stream_open_handler_in(fn_input_handler, handler_state, &pstream);
+    _ion_stream_open_handler_in_helper(fn_input_handler, handler_state, (*p_hreader)->options.allocator, &pstream);
     (*p_hreader)->istream = pstream;
     (*p_hreader)->_reader_owns_stream = TRUE;
+    (*p_hreader)->has_static_buffer = FALSE;
     
     b = 0;
     for (pos = 0; pos < ION_VERSION_MARKER_LENGTH; pos++) {
@@ -174,21 +172,110 @@ iERR ion_reader_reset_stream(hREADER *p_hreader, void *handler_state, ION_STREAM
         IONCHECK(ion_stream_unread_byte(pstream, ivm_buffer[ii]));
     }
     
-    // ensure whether the reader type is same as before & reinitialize the parsers
-    // catalog, symbol table, dec_context & other reader defaults would be reused
-    // @see _ion_reader_initialize impl.
-    is_binary_stream = ion_helper_is_ion_version_marker(ivm_buffer, pos);
-    if ( is_binary_stream && ((*p_hreader)->type == ion_type_binary_reader)) {
-        IONCHECK(_ion_reader_binary_open(*p_hreader));
+    // reinitialize the parsers, the catalog, dec_context & other reader defaults are reused
+    IONCHECK(_ion_reader_reset_input_helper(*p_hreader, ivm_buffer, pos));
+
+    iRETURN;
+}
+
+iERR ion_reader_reset_buffer(hREADER hreader, BYTE *buffer, SIZE buf_length)
+{
+    iENTER;
+    ION_READER *preader;
+
+    if (!hreader) FAILWITH(IERR_INVALID_ARG);
+    preader = HANDLE_TO_PTR(hreader, ION_READER);
+    if (!buffer) FAILWITH(IERR_INVALID_ARG);
+    if (buf_length < 0) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(_ion_reader_reset_buffer_helper(preader, buffer, buf_length));
+
+    iRETURN;
+}
+
+iERR _ion_reader_reset_buffer_helper(ION_READER *preader, BYTE *buffer, SIZE buf_length)
+{
+    iENTER;
+
+    ASSERT(preader);
+    ASSERT(buffer);
+
+    // a buffer stream the reader opened itself can simply be pointed at the new buffer
+    if (preader->_reader_owns_stream && preader->has_static_buffer) {
+        IONCHECK(_ion_stream_reset_buffer_helper(preader->istream, buffer, buf_length, buf_length));
+    }
+    else {
+        if (preader->_reader_owns_stream) {
+            ion_stream_close(preader->istream);
+        }
+        preader->istream = NULL;
+        preader->_reader_owns_stream = FALSE;
+        IONCHECK(_ion_stream_open_buffer_helper(buffer, buf_length, buf_length, TRUE, preader->options.allocator, &preader->istream));
+        preader->_reader_owns_stream = TRUE;
+        preader->has_static_buffer = TRUE;
+    }
+
+    IONCHECK(_ion_reader_reset_input_helper(preader, buffer, buf_length));
+
+    iRETURN;
+}
+
+iERR _ion_reader_reset_input_helper(ION_READER *preader, BYTE *version_buffer, SIZE version_length)
+{
+    iENTER;
+    ION_SYMBOL_TABLE *system;
+    ION_OBJ_TYPE      type;
+
+    ASSERT(preader);
+    ASSERT(preader->istream);
+
+    // the previous input's values and symbol table go, the catalog and the
+    // cache of local symbol tables stay
+    IONCHECK(_ion_reader_reset_temp_pool(preader));
+    IONCHECK(_ion_reader_free_local_symbol_table(preader));
+    IONCHECK(_ion_symbol_table_get_system_symbol_helper(&system, ION_SYSTEM_VERSION));
+    preader->_current_symtab = system;
+
+    // We need to free any digit space that has been allocated without an
+    // owner before resetting everything to zero below with the memset.
+    ION_INT *iint = &preader->_int_helper._as_ion_int;
+    if (iint && NULL == iint->_owner) {
+        if (iint->_digits) {
+            ion_xfree(iint->_digits);
+            iint->_digits = NULL;
+        }
+    }
+    memset(&preader->_int_helper, 0, sizeof(preader->_int_helper));
+
+    preader->_depth = 0;
+    preader->_eof = FALSE;
+    preader->_expected_remaining_utf8_bytes = 0;
+
+    type = ion_helper_is_ion_version_marker(version_buffer, version_length) ? ion_type_binary_reader : ion_type_text_reader;
+    if (type == preader->type) {
+        // same kind of input, so the parser's buffers and stacks are kept as they are
+        if (type == ion_type_binary_reader) {
+            IONCHECK(_ion_reader_binary_reset(preader, tid_DATAGRAM, 0, ION_STREAM_MAX_LENGTH));
+        }
+        else {
+            preader->typed_reader.text._scanner._stream = preader->istream;
+            IONCHECK(_ion_reader_text_reset(preader, tid_DATAGRAM, -1));
+        }
+        SUCCEED();
     }
-    else if ( (!is_binary_stream) && ((*p_hreader)->type == ion_type_text_reader) ){
-        IONCHECK(_ion_reader_text_open(*p_hreader));
+
+    // The other parser's buffers all live in the typed reader's pool, so only they go.
+    _ion_alloc_rewind(preader->_typed_reader_pool, &preader->_typed_reader_mark);
+    memset(&preader->typed_reader, 0, sizeof(preader->typed_reader));
+
+    preader->type = type;
+    if (type == ion_type_binary_reader) {
+        IONCHECK(_ion_reader_binary_open(preader));
     }
     else {
-        FAILWITH(IERR_INVALID_STATE);
+        IONCHECK(_ion_reader_text_open(preader));
     }
-    // Mark the eof flag to false, since reader is provided with new stream
-    (*p_hreader)->_eof = FALSE;
+
     iRETURN;
 }
 
@@ -204,7 +291,7 @@ iERR ion_reader_open_stream(hREADER *p_hreader
     if(!p_hreader) FAILWITH(IERR_INVALID_ARG);
     if(!p_hreader) FAILWITH(IERR_INVALID_ARG);
 
-    IONCHECK(ion_stream_open_handler_in( fn_input_handler, handler_state, &pstream ));
+    IONCHECK(_ion_stream_open_handler_in_helper( fn_input_handler, handler_state, (p_options) ? p_options->allocator : NULL, &pstream ));
     IONCHECK(_ion_reader_open_stream_helper( &preader, pstream, p_options ));
     preader->_reader_owns_stream = TRUE;
 
@@ -298,7 +385,7 @@ iERR _ion_reader_make_new_reader(ION_READER_OPTIONS *p_options, ION_READER **p_r
     // the stream.  Later we'll initialize typed portion of the reader
     // once we know what format we're going to be processing
     len = sizeof(ION_READER);
-    preader = (ION_READER *)ion_alloc_owner(len);
+    preader = (ION_READER *)ion_alloc_owner_with_allocator(len, (p_options) ? p_options->allocator : NULL);
     *p_reader = preader;
     if (!preader) {
         FAILWITH(IERR_NO_MEMORY);
@@ -394,6 +481,11 @@ void _ion_reader_initialize_option_defaults(ION_READER_OPTIONS* p_options)
         p_options->allocation_page_size = DEFAULT_BLOCK_SIZE;
     }
 
+    // the number of local symbol tables kept for reuse
+    if (!p_options->symbol_table_cache_size) {
+        p_options->symbol_table_cache_size = DEFAULT_SYMBOL_TABLE_CACHE_SIZE;
+    }
+
     return;
 }
 
@@ -488,6 +580,11 @@ iERR _ion_reader_initialize(ION_READER *preader, BYTE *version_buffer, SIZE vers
     // keep the readers copy of depth up to date
     preader->_depth = 0;
 
+    // everything the typed reader allocates is dropped if the reader is later
+    // reset onto input of the other kind, so it has a pool of its own
+    IONCHECK(_ion_reader_allocate_pool_owner(preader, &preader->_typed_reader_pool));
+    _ion_alloc_mark(preader->_typed_reader_pool, &preader->_typed_reader_mark);
+
     // now we can check the binary Ion Version Marker
     // we'll have to "unread" these bytes 
     if (ion_helper_is_ion_version_marker(version_buffer, version_length)) {
@@ -542,6 +639,44 @@ iERR _ion_reader_get_catalog_helper(ION_READER *preader, ION_CATALOG **p_pcatalo
     iRETURN;
 }
 
+iERR ion_reader_get_memory_stats(hREADER hreader, ION_MEMORY_STATS *p_stats)
+{
+    iENTER;
+    ION_READER *preader;
+
+    if (!hreader) FAILWITH(IERR_INVALID_ARG);
+    preader = HANDLE_TO_PTR(hreader, ION_READER);
+    if (!p_stats) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(_ion_reader_get_memory_stats_helper(preader, p_stats));
+
+    iRETURN;
+}
+
+iERR _ion_reader_get_memory_stats_helper(ION_READER *preader, ION_MEMORY_STATS *p_stats)
+{
+    iENTER;
+    SIZE ii;
+
+    ASSERT(preader);
+    ASSERT(p_stats);
+
+    memset(p_stats, 0, sizeof(ION_MEMORY_STATS));
+    _ion_alloc_owner_add_stats(preader, p_stats);
+    _ion_alloc_owner_add_stats(preader->_temp_entity_pool, p_stats);
+    _ion_alloc_owner_add_stats(preader->_typed_reader_pool, p_stats);
+    _ion_alloc_owner_add_stats(preader->_local_symtab_pool, p_stats);
+    for (ii = 0; ii < preader->_lst_cache_count; ii++) {
+        _ion_alloc_owner_add_stats(preader->_lst_cache[ii].pool, p_stats);
+    }
+    if (preader->_reader_owns_stream) {
+        _ion_alloc_owner_add_stats(preader->istream, p_stats);
+    }
+    SUCCEED();
+
+    iRETURN;
+}
+
 iERR ion_reader_next(hREADER hreader, ION_TYPE *p_value_type)
 {
     iENTER;
@@ -1800,8 +1935,13 @@ iERR _ion_reader_close_helper(ION_READER *preader)
         ion_free_owner( preader->_temp_entity_pool );
         preader->_temp_entity_pool = NULL;
     }
+    if (preader->_typed_reader_pool != NULL) {
+        ion_free_owner( preader->_typed_reader_pool );
+        preader->_typed_reader_pool = NULL;
+    }
 
     IONCHECK(_ion_reader_free_local_symbol_table(preader));
+    _ion_reader_free_lst_cache(preader);
 
     // Free any un-owned digit space before releasing the reader.
     ION_INT *iint = &preader->_int_helper._as_ion_int;
@@ -1822,22 +1962,25 @@ iERR _ion_reader_reset_temp_pool( ION_READER *preader )
 {
     iENTER;
     void *owner;
-    if ((preader->_temp_entity_pool != NULL)) {
-        ion_free_owner( preader->_temp_entity_pool );
-        preader->_temp_entity_pool = NULL;
+
+    // keep the pool itself, only the previous value's memory goes
+    if (preader->_temp_entity_pool != NULL) {
+        _ion_alloc_rewind(preader->_temp_entity_pool, &preader->_temp_entity_mark);
+        SUCCEED();
     }
 
-    IONCHECK(_ion_reader_allocate_pool_owner(&owner));
+    IONCHECK(_ion_reader_allocate_pool_owner(preader, &owner));
     preader->_temp_entity_pool = owner;
+    _ion_alloc_mark(owner, &preader->_temp_entity_mark);
 
     iRETURN;
 }
 
-iERR _ion_reader_allocate_pool_owner(void **p_owner)
+iERR _ion_reader_allocate_pool_owner(ION_READER *preader, void **p_owner)
 {
     iENTER;
     void *owner;
-    owner = ion_alloc_owner(sizeof(int));  // this is a fake allocation to hold the pool
+    owner = ion_alloc_owner_with_allocator(sizeof(int), preader->options.allocator);  // this is a fake allocation to hold the pool
     if (owner == NULL) {
         FAILWITH(IERR_NO_MEMORY);
     }
@@ -1894,6 +2037,263 @@ iERR _ion_reader_symbol_table_context_change_notify(ION_READER *preader, ION_SYM
     iRETURN;
 }
 
+// Hashes what makes two local symbol tables interchangeable: their imports and their symbols' text, in order.
+static iERR _ion_reader_lst_structure_hash(ION_SYMBOL_TABLE *symtab, uint64_t *p_hash)
+{
+    iENTER;
+    ION_COLLECTION          *imports, *symbols;
+    ION_COLLECTION_CURSOR    cursor;
+    ION_SYMBOL_TABLE_IMPORT *import;
+    ION_SYMBOL              *sym;
+    uint64_t                 hash = ION_SYMBOL_HASH_SEED;
+    int32_t                  numbers[2];
+
+    IONCHECK(_ion_symbol_table_get_imports_helper(symtab, &imports));
+    IONCHECK(_ion_symbol_table_get_symbols_helper(symtab, &symbols));
+
+    ION_COLLECTION_OPEN(imports, cursor);
+    for (;;) {
+        ION_COLLECTION_NEXT(cursor, import);
+        if (!import) break;
+        numbers[0] = import->descriptor.version;
+        numbers[1] = import->descriptor.max_id;
+        hash = _ion_hash_bytes(import->descriptor.name.value, import->descriptor.name.length, hash);
+        hash = _ion_hash_bytes((BYTE *)numbers, sizeof(numbers), hash);
+    }
+    ION_COLLECTION_CLOSE(cursor);
+
+    ION_COLLECTION_OPEN(symbols, cursor);
+    for (;;) {
+        ION_COLLECTION_NEXT(cursor, sym);
+        if (!sym) break;
+        // the length keeps "ab","c" apart from "a","bc", and -1 marks unknown text
+        numbers[0] = ION_STRING_IS_NULL(&sym->value) ? -1 : sym->value.length;
+        hash = _ion_hash_bytes((BYTE *)numbers, sizeof(numbers[0]), hash);
+        if (numbers[0] > 0) hash = _ion_hash_bytes(sym->value.value, sym->value.length, hash);
+    }
+    ION_COLLECTION_CLOSE(cursor);
+
+    *p_hash = hash;
+
+    iRETURN;
+}
+
+static iERR _ion_reader_lst_structure_equals(ION_SYMBOL_TABLE *lhs, ION_SYMBOL_TABLE *rhs, BOOL *p_is_equal)
+{
+    iENTER;
+    ION_COLLECTION          *lhs_imports, *rhs_imports, *lhs_symbols, *rhs_symbols;
+    ION_COLLECTION_CURSOR    lhs_cursor, rhs_cursor;
+    ION_SYMBOL              *lhs_sym, *rhs_sym;
+    SID                      lhs_max_id, rhs_max_id;
+
+    *p_is_equal = FALSE;
+
+    IONCHECK(_ion_symbol_table_get_max_sid_helper(lhs, &lhs_max_id));
+    IONCHECK(_ion_symbol_table_get_max_sid_helper(rhs, &rhs_max_id));
+    if (lhs_max_id != rhs_max_id) SUCCEED();
+
+    IONCHECK(_ion_symbol_table_get_imports_helper(lhs, &lhs_imports));
+    IONCHECK(_ion_symbol_table_get_imports_helper(rhs, &rhs_imports));
+    IONCHECK(_ion_collection_compare(lhs_imports, rhs_imports, &_ion_symbol_table_import_compare_fn, p_is_equal));
+    if (!*p_is_equal) SUCCEED();
+
+    *p_is_equal = FALSE;
+    IONCHECK(_ion_symbol_table_get_symbols_helper(lhs, &lhs_symbols));
+    IONCHECK(_ion_symbol_table_get_symbols_helper(rhs, &rhs_symbols));
+    if (lhs_symbols->_count != rhs_symbols->_count) SUCCEED();
+
+    ION_COLLECTION_OPEN(lhs_symbols, lhs_cursor);
+    ION_COLLECTION_OPEN(rhs_symbols, rhs_cursor);
+    for (;;) {
+        ION_COLLECTION_NEXT(lhs_cursor, lhs_sym);
+        ION_COLLECTION_NEXT(rhs_cursor, rhs_sym);
+        if (!lhs_sym || !rhs_sym) break;
+        if (lhs_sym->sid != rhs_sym->sid) SUCCEED();
+        if (ION_STRING_IS_NULL(&lhs_sym->value) != ION_STRING_IS_NULL(&rhs_sym->value)) SUCCEED();
+        if (!ION_STRING_IS_NULL(&lhs_sym->value) && !ION_STRING_EQUALS(&lhs_sym->value, &rhs_sym->value)) SUCCEED();
+    }
+    ION_COLLECTION_CLOSE(lhs_cursor);
+    ION_COLLECTION_CLOSE(rhs_cursor);
+
+    *p_is_equal = TRUE;
+
+    iRETURN;
+}
+
+// A table can only stand in for a later, identical one if resolving its imports again would give the same result.
+// The catalog may gain tables while the reader is open, so that's only certain when every import was found at its
+// exact version.
+static iERR _ion_reader_lst_is_cacheable(ION_SYMBOL_TABLE *symtab, BOOL *p_is_cacheable)
+{
+    iENTER;
+    ION_COLLECTION          *imports;
+    ION_COLLECTION_CURSOR    import_cursor;
+    ION_SYMBOL_TABLE_IMPORT *import;
+    int32_t                  version;
+
+    *p_is_cacheable = FALSE;
+
+    IONCHECK(_ion_symbol_table_get_imports_helper(symtab, &imports));
+    ION_COLLECTION_OPEN(imports, import_cursor);
+    for (;;) {
+        ION_COLLECTION_NEXT(import_cursor, import);
+        if (!import) break;
+        if (!import->shared_symbol_table) SUCCEED();
+        IONCHECK(_ion_symbol_table_get_version_helper(import->shared_symbol_table, &version));
+        if (version != import->descriptor.version) SUCCEED();
+    }
+    ION_COLLECTION_CLOSE(import_cursor);
+
+    *p_is_cacheable = TRUE;
+
+    iRETURN;
+}
+
+static ION_READER_LST_CACHE_ENTRY *_ion_reader_lst_cache_find_raw(ION_READER *preader, BYTE *raw, SIZE raw_length, uint64_t raw_hash)
+{
+    ION_READER_LST_CACHE_ENTRY *entry;
+    SIZE                        ii;
+
+    for (ii = 0; ii < preader->_lst_cache_count; ii++) {
+        entry = &preader->_lst_cache[ii];
+        if (entry->raw == NULL || entry->raw_hash != raw_hash || entry->raw_length != raw_length) continue;
+        if (entry->appended_to != NULL && entry->appended_to != preader->_current_symtab) continue;
+        if (memcmp(entry->raw, raw, raw_length) == 0) return entry;
+    }
+    return NULL;
+}
+
+static iERR _ion_reader_lst_cache_find_structure(ION_READER *preader, ION_SYMBOL_TABLE *symtab, uint64_t structure_hash, ION_READER_LST_CACHE_ENTRY **p_entry)
+{
+    iENTER;
+    ION_READER_LST_CACHE_ENTRY *entry;
+    SIZE                        ii;
+    BOOL                        is_equal;
+
+    *p_entry = NULL;
+    for (ii = 0; ii < preader->_lst_cache_count; ii++) {
+        entry = &preader->_lst_cache[ii];
+        if (entry->structure_hash != structure_hash) continue;
+        IONCHECK(_ion_reader_lst_structure_equals(entry->symtab, symtab, &is_equal));
+        if (is_equal) {
+            *p_entry = entry;
+            SUCCEED();
+        }
+    }
+
+    iRETURN;
+}
+
+// Makes room for one more entry by dropping the least recently used table that isn't the current context.
+// Returns FALSE if there's no such table.
+static BOOL _ion_reader_lst_cache_evict(ION_READER *preader)
+{
+    ION_READER_LST_CACHE_ENTRY *entry, *victim = NULL;
+    SIZE                        ii;
+
+    for (ii = 0; ii < preader->_lst_cache_count; ii++) {
+        entry = &preader->_lst_cache[ii];
+        if (entry->symtab == preader->_current_symtab) continue;
+        if (victim == NULL || entry->last_used < victim->last_used) victim = entry;
+    }
+    if (victim == NULL) return FALSE;
+
+    // tables read as appends to the victim can't be matched by their bytes any longer,
+    // since a new table could be allocated where the victim was
+    for (ii = 0; ii < preader->_lst_cache_count; ii++) {
+        entry = &preader->_lst_cache[ii];
+        if (entry->appended_to == victim->symtab) {
+            entry->raw = NULL;
+            entry->appended_to = NULL;
+        }
+    }
+
+    ion_free_owner(victim->pool);
+    *victim = preader->_lst_cache[--preader->_lst_cache_count];
+    return TRUE;
+}
+
+// Takes ownership of the pool holding symtab, unless the table can't be reused (*p_entry is then NULL).
+static iERR _ion_reader_lst_cache_add(ION_READER *preader, ION_SYMBOL_TABLE *symtab, void *pool, uint64_t structure_hash, BYTE *raw, SIZE raw_length, uint64_t raw_hash, BOOL appends, ION_READER_LST_CACHE_ENTRY **p_entry)
+{
+    iENTER;
+    ION_READER_LST_CACHE_ENTRY *entry;
+    ION_SYMBOL_TABLE           *system;
+    BYTE                       *raw_copy = NULL;
+    BOOL                        is_cacheable;
+    SIZE                        ii;
+
+    *p_entry = NULL;
+
+    IONCHECK(_ion_reader_lst_is_cacheable(symtab, &is_cacheable));
+    if (!is_cacheable) SUCCEED();
+
+    if (appends && raw) {
+        // the bytes only mean the same thing when read in the same context, which must outlive the entry
+        IONCHECK(_ion_symbol_table_get_system_symbol_helper(&system, ION_SYSTEM_VERSION));
+        if (preader->_current_symtab != system) {
+            for (ii = 0; ii < preader->_lst_cache_count; ii++) {
+                if (preader->_lst_cache[ii].symtab == preader->_current_symtab) break;
+            }
+            if (ii == preader->_lst_cache_count) raw = NULL;
+        }
+    }
+    if (raw) {
+        raw_copy = (BYTE *)ion_alloc_with_owner(pool, raw_length);
+        if (!raw_copy) FAILWITH(IERR_NO_MEMORY);
+        memcpy(raw_copy, raw, raw_length);
+    }
+
+    if (!preader->_lst_cache) {
+        preader->_lst_cache = (ION_READER_LST_CACHE_ENTRY *)ion_alloc_with_owner(preader, preader->options.symbol_table_cache_size * sizeof(ION_READER_LST_CACHE_ENTRY));
+        if (!preader->_lst_cache) FAILWITH(IERR_NO_MEMORY);
+        preader->_lst_cache_count = 0;
+    }
+    if (preader->_lst_cache_count == preader->options.symbol_table_cache_size
+     && !_ion_reader_lst_cache_evict(preader)
+    ) {
+        SUCCEED();
+    }
+
+    entry = &preader->_lst_cache[preader->_lst_cache_count++];
+    memset(entry, 0, sizeof(ION_READER_LST_CACHE_ENTRY));
+    entry->symtab         = symtab;
+    entry->pool           = pool;
+    entry->structure_hash = structure_hash;
+    entry->raw            = raw_copy;
+    entry->raw_length     = raw_copy ? raw_length : 0;
+    entry->raw_hash       = raw_hash;
+    entry->appended_to    = (raw_copy && appends) ? preader->_current_symtab : NULL;
+    *p_entry = entry;
+
+    iRETURN;
+}
+
+void _ion_reader_free_lst_cache(ION_READER *preader)
+{
+    SIZE ii;
+
+    ASSERT(preader);
+
+    for (ii = 0; ii < preader->_lst_cache_count; ii++) {
+        ion_free_owner(preader->_lst_cache[ii].pool);
+    }
+    preader->_lst_cache_count = 0;
+}
+
+// Makes the table the reader's context. The reader owns pool, if there is one; otherwise the table is in the cache.
+static iERR _ion_reader_switch_to_local_symbol_table(ION_READER *preader, ION_SYMBOL_TABLE *local, void *pool)
+{
+    iENTER;
+
+    IONCHECK(_ion_reader_symbol_table_context_change_notify(preader, local));
+    IONCHECK(_ion_reader_free_local_symbol_table(preader));
+    preader->_local_symtab_pool = pool;
+    preader->_current_symtab = local;
+
+    iRETURN;
+}
+
 iERR _ion_reader_process_possible_symbol_table(ION_READER *preader, BOOL *is_symbol_table)
 {
     /*
@@ -1904,10 +2304,14 @@ iERR _ion_reader_process_possible_symbol_table(ION_READER *preader, BOOL *is_sym
      * readers must throw if the annotation wrapper is malformed (e.g. has no annotation SIDs).
      */
     iENTER;
-    BOOL              has_previous_local_symbol_table = TRUE;
-    ION_SYMBOL_TABLE *system, *local = NULL;
-    void             *owner = NULL;
-    ION_STRING        annotation;
+    ION_SYMBOL_TABLE           *system, *local = NULL;
+    ION_READER_LST_CACHE_ENTRY *entry = NULL;
+    void                       *owner = NULL;
+    ION_STRING                  annotation;
+    BOOL                        use_cache, appends;
+    BYTE                       *raw = NULL;
+    SIZE                        raw_length = 0, skipped;
+    uint64_t                    raw_hash = 0, structure_hash;
 
     ASSERT(preader);
     ASSERT(is_symbol_table);
@@ -1919,30 +2323,59 @@ iERR _ion_reader_process_possible_symbol_table(ION_READER *preader, BOOL *is_sym
     // if we return system values we don't process them
     if (*is_symbol_table && preader->options.return_system_values != TRUE) {
         // this is a local symbol table and the user has not *insisted* we return system values, so we process it
-        IONCHECK(_ion_symbol_table_get_system_symbol_helper(&system, ION_SYSTEM_VERSION));
-        IONCHECK(_ion_reader_allocate_pool_owner(&owner));
-        if (!preader->_local_symtab_pool) {
-            has_previous_local_symbol_table = FALSE;
+        use_cache = (preader->options.symbol_table_cache_size > 0);
+
+        // a binary table we've seen before is recognized by its bytes, without parsing it again
+        if (use_cache && preader->type == ion_type_binary_reader) {
+            IONCHECK(_ion_reader_binary_peek_contents(preader, &raw, &raw_length));
+            if (raw) {
+                raw_hash = _ion_hash_bytes(raw, raw_length, ION_SYMBOL_HASH_SEED);
+                entry = _ion_reader_lst_cache_find_raw(preader, raw, raw_length, raw_hash);
+                if (entry) {
+                    IONCHECK(ion_stream_skip(preader->istream, raw_length, &skipped));
+                    if (skipped != raw_length) FAILWITH(IERR_UNEXPECTED_EOF);
+                    entry->last_used = ++preader->_lst_cache_clock;
+                    IONCHECK(_ion_reader_switch_to_local_symbol_table(preader, entry->symtab, NULL));
+                    SUCCEED();
+                }
+            }
         }
+
+        IONCHECK(_ion_symbol_table_get_system_symbol_helper(&system, ION_SYSTEM_VERSION));
+        IONCHECK(_ion_reader_allocate_pool_owner(preader, &owner));
         if (preader->type == ion_type_text_reader) {
             // fake the state values so the symbol table load helper will "next" properly
             preader->typed_reader.text._state = IPS_BEFORE_CONTAINER;
             preader->typed_reader.text._value_type = tid_STRUCT;
         }
-        IONCHECK(_ion_symbol_table_load_helper(preader, owner, system, &local));
+        IONCHECK(_ion_symbol_table_load_with_context_helper(preader, owner, system, &local, &appends));
         if (local == NULL) {
             FAILWITH(IERR_NOT_A_SYMBOL_TABLE);
         }
-        IONCHECK(_ion_reader_symbol_table_context_change_notify(preader, local));
-        if (has_previous_local_symbol_table) {
-            IONCHECK(_ion_reader_free_local_symbol_table(preader));
+
+        if (use_cache) {
+            // otherwise, one built from the same imports and symbols is just as good
+            IONCHECK(_ion_reader_lst_structure_hash(local, &structure_hash));
+            IONCHECK(_ion_reader_lst_cache_find_structure(preader, local, structure_hash, &entry));
+            if (entry) {
+                ion_free_owner(owner);
+                owner = NULL;
+                entry->last_used = ++preader->_lst_cache_clock;
+                IONCHECK(_ion_reader_switch_to_local_symbol_table(preader, entry->symtab, NULL));
+                SUCCEED();
+            }
+            IONCHECK(_ion_reader_lst_cache_add(preader, local, owner, structure_hash, raw, raw_length, raw_hash, appends, &entry));
+            if (entry) {
+                entry->last_used = ++preader->_lst_cache_clock;
+                owner = NULL; // the cache has it now
+            }
         }
-        preader->_local_symtab_pool = owner;
-        preader->_current_symtab = local;
+
+        IONCHECK(_ion_reader_switch_to_local_symbol_table(preader, local, owner));
     }
     return IERR_OK;
 fail:
-    if (owner != NULL) {
+    if (owner != NULL && owner != preader->_local_symtab_pool) {
         ion_free_owner(owner);
     }
     return err;
@@ -37,8 +37,8 @@ iERR _ion_reader_binary_open(ION_READER *preader)
 
     binary = &preader->typed_reader.binary;
 
-    _ion_collection_initialize(preader, &binary->_parent_stack, sizeof(BINARY_PARENT_STATE)); // array of BINARY_PARENT_STATE
-    _ion_collection_initialize(preader, &binary->_annotation_sids, sizeof(SID)); // array of SID's
+    _ion_collection_initialize(preader->_typed_reader_pool, &binary->_parent_stack, sizeof(BINARY_PARENT_STATE)); // array of BINARY_PARENT_STATE
+    _ion_collection_initialize(preader->_typed_reader_pool, &binary->_annotation_sids, sizeof(SID)); // array of SID's
 
     binary->_local_end = ION_STREAM_MAX_LENGTH;
     binary->_state = S_BEFORE_TID;
@@ -233,8 +233,10 @@ begin:
                 preader->typed_reader.binary._state = S_BEFORE_CONTENTS;
                 IONCHECK(_ion_reader_process_possible_symbol_table(preader, &is_system_value));
                 if (is_system_value) {
-                    // Another value will be consumed; set the next_state back to the default.
+                    // Another value will be consumed; set the next_state back to the default. The symbol table's
+                    // annotations are not that value's (and aren't cleared by loading it when it came from the cache).
                     next_state = S_BEFORE_CONTENTS;
+                    _ion_collection_reset(&binary->_annotation_sids);
                     continue;
                 }
             }
@@ -475,6 +477,34 @@ iERR _ion_reader_binary_get_value_offset(ION_READER *preader, POSITION *p_offset
 }
 
 
+iERR _ion_reader_binary_peek_contents(ION_READER *preader, BYTE **p_contents, SIZE *p_length)
+{
+    iENTER;
+    ION_BINARY_READER *binary;
+    ION_STREAM        *stream;
+
+    ASSERT(preader && preader->type == ion_type_binary_reader);
+    ASSERT(p_contents);
+    ASSERT(p_length);
+
+    binary = &preader->typed_reader.binary;
+    if (binary->_state != S_BEFORE_CONTENTS) FAILWITH(IERR_INVALID_STATE);
+
+    // only when the whole value is already in the stream's current page,
+    // which is always the case when reading from a single buffer
+    stream = preader->istream;
+    if (binary->_value_len > 0 && binary->_value_len <= stream->_limit - stream->_curr) {
+        *p_contents = stream->_curr;
+        *p_length   = binary->_value_len;
+    }
+    else {
+        *p_contents = NULL;
+        *p_length   = 0;
+    }
+
+    iRETURN;
+}
+
 iERR _ion_reader_binary_get_type(ION_READER *preader, ION_TYPE *p_value_type)
 {
     iENTER;
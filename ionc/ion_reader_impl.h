@@ -156,6 +156,22 @@ typedef struct _ion_reader_binary
 
 #define BINARY(preader) (&((preader)->typed_reader.binary))
 
+// A local symbol table the reader has already built, kept so that a repeat of it later in
+// the stream (e.g. at the head of each chunk of concatenated data) is reused rather than
+// rebuilt. See _ion_reader_process_possible_symbol_table.
+typedef struct _ion_reader_lst_cache_entry
+{
+    ION_SYMBOL_TABLE   *symtab;
+    void               *pool;           // owns symtab and raw
+    uint64_t            structure_hash; // over the imports and symbol text, see _ion_reader_lst_structure_hash
+    BYTE               *raw;            // the binary struct contents symtab was built from, NULL if there aren't any
+    SIZE                raw_length;
+    uint64_t            raw_hash;
+    ION_SYMBOL_TABLE   *appended_to;    // the context raw was read in, if it appends to it (imports: $ion_symbol_table)
+    uint64_t            last_used;
+
+} ION_READER_LST_CACHE_ENTRY;
+
 /** Read both text ion and binary ion data.
  *
  */
@@ -179,6 +195,13 @@ struct _ion_reader
     ION_SYMBOL_TABLE   *_current_symtab;
     ION_SYMBOL_TABLE   *_local_symtab_pool;         // memory pool for local symbol table we recycle
     void               *_temp_entity_pool;          // memory pool for top level objects that we'll throw away
+    ION_ALLOC_MARK      _temp_entity_mark;          // the empty _temp_entity_pool, rewound to between top level values
+    void               *_typed_reader_pool;         // memory pool for typed_reader's buffers and stacks
+    ION_ALLOC_MARK      _typed_reader_mark;         // the empty _typed_reader_pool, rewound to when the input changes kind
+
+    ION_READER_LST_CACHE_ENTRY *_lst_cache;         // options.symbol_table_cache_size entries, allocated on first use
+    SIZE                _lst_cache_count;
+    uint64_t            _lst_cache_clock;
 
     ION_READER_CONTEXT_CHANGE_NOTIFIER context_change_notifier;
     
@@ -205,8 +228,11 @@ iERR _ion_reader_set_options(ION_READER *preader, ION_READER_OPTIONS* p_options)
 void _ion_reader_initialize_option_defaults(ION_READER_OPTIONS *p_options);
 iERR _ion_reader_validate_options(ION_READER_OPTIONS* p_options);
 iERR _ion_reader_initialize(ION_READER *preader, BYTE *version_buffer, SIZE version_length);
+iERR _ion_reader_reset_buffer_helper(ION_READER *preader, BYTE *buffer, SIZE buf_length);
+iERR _ion_reader_reset_input_helper(ION_READER *preader, BYTE *version_buffer, SIZE version_length);
 
 iERR _ion_reader_get_catalog_helper(ION_READER *preader, ION_CATALOG **p_pcatalog);
+iERR _ion_reader_get_memory_stats_helper(ION_READER *preader, ION_MEMORY_STATS *p_stats);
 iERR _ion_reader_get_symbol_table_helper(ION_READER *preader, ION_SYMBOL_TABLE **p_psymtab);
 iERR _ion_reader_set_symbol_table_helper(ION_READER *preader, ION_SYMBOL_TABLE *symtab);
 iERR _ion_reader_next_helper(ION_READER *preader, ION_TYPE *p_value_type);
@@ -250,10 +276,11 @@ iERR _ion_reader_close_helper(ION_READER *preader);
 
 iERR _ion_reader_allocate_temp_pool                 (ION_READER *preader);
 iERR _ion_reader_reset_temp_pool                    (ION_READER *preader);
-iERR _ion_reader_allocate_pool_owner                (void **p_owner);
+iERR _ion_reader_allocate_pool_owner                (ION_READER *preader, void **p_owner);
 iERR _ion_reader_free_local_symbol_table            (ION_READER *preader);
 iERR _ion_reader_reset_local_symbol_table           (ION_READER *preader);
 iERR _ion_reader_process_possible_symbol_table      (ION_READER *preader, BOOL *is_symbol_table);
+void _ion_reader_free_lst_cache                     (ION_READER *preader);
 
 iERR _ion_reader_get_position_helper(ION_READER *preader, int64_t *p_bytes, int32_t *p_line, int32_t *p_offset);
 
@@ -281,6 +308,7 @@ iERR _ion_reader_binary_step_out            (ION_READER *preader);
 iERR _ion_reader_binary_get_depth           (ION_READER *preader, SIZE *p_depth);
 iERR _ion_reader_binary_get_value_length    (ION_READER *preader, SIZE *p_length);
 iERR _ion_reader_binary_get_value_offset    (ION_READER *preader, POSITION *p_offset);
+iERR _ion_reader_binary_peek_contents       (ION_READER *preader, BYTE **p_contents, SIZE *p_length);
 
 iERR _ion_reader_binary_get_type            (ION_READER *preader, ION_TYPE *p_value_type);
 iERR _ion_reader_binary_has_any_annotations (ION_READER *preader, BOOL *p_has_any_annotations);
@@ -17,6 +17,7 @@
  */
 #include <ionc/ion.h>
 #include "ion_internal.h"
+#include "ion_float_impl.h"
 #include <stdlib.h>
 #include <errno.h>
 #include <limits.h>
@@ -87,12 +88,12 @@ iERR _ion_reader_text_open(ION_READER *preader)
     text->_annotation_string_pool_length = preader->options.max_annotation_count;  // max number of annotations, size of string pool as count
     text->_annotation_value_buffer_length = preader->options.max_annotation_buffered + (preader->options.max_annotation_count * sizeof(BYTE));
 
-    text->_annotation_string_pool = (ION_SYMBOL *)ion_alloc_with_owner(preader, text->_annotation_string_pool_length * sizeof(ION_SYMBOL));
+    text->_annotation_string_pool = (ION_SYMBOL *)ion_alloc_with_owner(preader->_typed_reader_pool, text->_annotation_string_pool_length * sizeof(ION_SYMBOL));
     if (!text->_annotation_string_pool) {
         FAILWITH(IERR_NO_MEMORY);
     }
 
-    text->_annotation_value_buffer = (BYTE *)ion_alloc_with_owner(preader, text->_annotation_value_buffer_length);
+    text->_annotation_value_buffer = (BYTE *)ion_alloc_with_owner(preader->_typed_reader_pool, text->_annotation_value_buffer_length);
     if (!text->_annotation_value_buffer) {
         FAILWITH(IERR_NO_MEMORY);
     }
@@ -103,7 +104,7 @@ iERR _ion_reader_text_open(ION_READER *preader)
     text->_value_type         = tid_none;
     text->_value_sub_type     = IST_NONE;
 
-    _ion_collection_initialize(preader, &(text->_container_state_stack), sizeof(ION_TYPE));
+    _ion_collection_initialize(preader->_typed_reader_pool, &(text->_container_state_stack), sizeof(ION_TYPE));
     
     IONCHECK(_ion_scanner_initialize(&(text->_scanner), preader));
 
@@ -115,7 +116,7 @@ iERR _ion_reader_text_open_alloc_buffered_string(ION_READER *preader, SIZE len,
     iENTER;
     BYTE *ptr;
 
-    ptr = (BYTE *)ion_alloc_with_owner(preader, len);
+    ptr = (BYTE *)ion_alloc_with_owner(preader->_typed_reader_pool, len);
     if (!ptr) {
         FAILWITH(IERR_NO_MEMORY);
     }
@@ -1339,6 +1340,29 @@ iERR _ion_reader_text_read_bool(ION_READER *preader, BOOL *p_value)
     iRETURN;
 }
 
+// Converts the image of a base-10 int to an int64_t. Returns FALSE if the value doesn't fit.
+static BOOL _ion_reader_text_decimal_image_to_int64(ION_TEXT_READER *text, int64_t *p_value)
+{
+    char     *value_start = (char *)text->_scanner._value_image.value;
+    SIZE      len = text->_scanner._value_image.length;
+    uint64_t  magnitude;
+    BOOL      sign = (text->_value_sub_type == IST_INT_NEG_DECIMAL);
+
+    if (sign) {
+        value_start++; // skip the "-"
+        len--;
+    }
+    if (!_ion_decimal_digits_to_uint64(value_start, len, &magnitude)) {
+        return FALSE;
+    }
+    if ((!sign && magnitude > ((uint64_t) LLONG_MAX)) || (sign && magnitude > (((uint64_t) LLONG_MAX) + 1))) {
+        return FALSE;
+    }
+    // negating as unsigned handles LLONG_MIN, whose magnitude isn't representable as int64_t
+    *p_value = sign ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+    return TRUE;
+}
+
 iERR _ion_reader_text_read_mixed_int_helper(ION_READER *preader)
 {
     iENTER;
@@ -1363,10 +1387,11 @@ iERR _ion_reader_text_read_mixed_int_helper(ION_READER *preader)
     len = text->_scanner._value_image.length; // decimal or hex characters
     preader->_int_helper._is_ion_int = TRUE;  // we will default to var len int
     
-    if (text->_value_sub_type == IST_INT_NEG_DECIMAL) {
-        len --; // discount the "-"
-        if (len < 19) { // 9,223,372,036,854,775,807 is max signed int64, 19 decimal chars
+    if (text->_value_sub_type == IST_INT_NEG_DECIMAL || text->_value_sub_type == IST_INT_POS_DECIMAL) {
+        // decimal images are converted directly; only values that overflow int64 use ION_INT
+        if (_ion_reader_text_decimal_image_to_int64(text, &preader->_int_helper._as_int64)) {
             preader->_int_helper._is_ion_int = FALSE;
+            SUCCEED();
         }
     }
     else if (text->_value_sub_type == IST_INT_NEG_HEX) {
@@ -1383,12 +1408,6 @@ iERR _ion_reader_text_read_mixed_int_helper(ION_READER *preader)
             preader->_int_helper._is_ion_int = FALSE;
         }
     }
-    else if (text->_value_sub_type == IST_INT_POS_DECIMAL) {
-        /* no adjustment */
-        if (len < 19) { // 9,223,372,036,854,775,807 is max signed int64, 19 decimal chars
-            preader->_int_helper._is_ion_int = FALSE;
-        }
-    }
     else if (text->_value_sub_type == IST_INT_POS_HEX) {
         len -= 2; // discount the "0x" prefix
         if ((len / 2) < 16) { // 64 bit int is 16 hex chars
@@ -1457,15 +1476,15 @@ iERR _ion_reader_text_read_int64(ION_READER *preader, int64_t *p_value)
     value_end = text->_scanner._value_image.value + text->_scanner._value_image.length;
     value_start = text->_scanner._value_image.value; // if this is hexadecimal, we may need to skip past the "0x"
 
-    // convert only the magnitude
-    if (text->_value_sub_type == IST_INT_POS_DECIMAL) {
-        magnitude = STR_TO_UINT64(value_start, &value_end, 10);
-    }
-    else if (text->_value_sub_type == IST_INT_NEG_DECIMAL) {
-        // we add 1 to go past the "-"
-        magnitude = STR_TO_UINT64(value_start + 1, &value_end, 10);
+    if (text->_value_sub_type == IST_INT_POS_DECIMAL || text->_value_sub_type == IST_INT_NEG_DECIMAL) {
+        if (!_ion_reader_text_decimal_image_to_int64(text, p_value)) {
+            FAILWITHMSG(IERR_NUMERIC_OVERFLOW, "value too large for type int64_t");
+        }
+        SUCCEED();
     }
-    else if (text->_value_sub_type == IST_INT_POS_HEX) {
+
+    // convert only the magnitude
+    if (text->_value_sub_type == IST_INT_POS_HEX) {
         // base is now 16, and we add 2 to the start for the "0x"
         magnitude = STR_TO_UINT64(value_start + 2, &value_end, II_HEX_BASE);
     }
@@ -1558,8 +1577,10 @@ iERR _ion_reader_text_read_double(ION_READER *preader, double *p_value)
     if (text->_value_sub_type == IST_FLOAT_64) {
         ASSERT(text->_scanner._value_location == SVL_VALUE_IMAGE);
         ASSERT(text->_scanner._value_image.length > 0);
-        ASSERT(text->_scanner._value_image.value[text->_scanner._value_image.length] == 0);
-        double_value = atof(text->_scanner._value_image.value);
+        if (!_ion_float_from_text((char *)text->_scanner._value_image.value, text->_scanner._value_image.length, &double_value)) {
+            ASSERT(text->_scanner._value_image.value[text->_scanner._value_image.length] == 0);
+            double_value = atof((char *)text->_scanner._value_image.value);
+        }
     }
     else if (text->_value_sub_type == IST_PLUS_INF) {
         double_value = ION_FLOAT64_POS_INF;
@@ -863,61 +863,79 @@ not_a_typename:
     iRETURN;
 }
 
+// The text keywords and the type names that may follow "null.", placed at compile time by a perfect hash of their
+// length and first and last bytes: each has its own slot, so recognizing one is one hash and at most one compare.
+// The sub types are held by address since they are variables (see ion_sub_type_records.h).
+typedef struct _ion_keyword
+{
+    char          *text;
+    SIZE           length;
+    ION_SUB_TYPE  *p_null_type;     // the type of null.<text>, if text is a type name
+    ION_SUB_TYPE  *p_keyword_type;  // the type of the bare text, if it is a keyword
+} ION_KEYWORD;
+
+#define KEYWORD_SLOT_COUNT 32
+#define KEYWORD_SLOT(length, first, last) ((((length) * 8) + (first) + (last)) & (KEYWORD_SLOT_COUNT - 1))
+
+static const ION_KEYWORD _Ion_keywords[KEYWORD_SLOT_COUNT] = {
+    { "list",      4, &IST_NULL_LIST,      NULL            }, //  0
+    { NULL,        0, NULL,                NULL            },
+    { "float",     5, &IST_NULL_FLOAT,     NULL            }, //  2
+    { "sexp",      4, &IST_NULL_SEXP,      NULL            }, //  3
+    { "blob",      4, &IST_NULL_BLOB,      NULL            }, //  4
+    { "clob",      4, &IST_NULL_CLOB,      NULL            }, //  5
+    { NULL,        0, NULL,                NULL            },
+    { NULL,        0, NULL,                NULL            },
+    { "decimal",   7, &IST_NULL_DECIMAL,   NULL            }, //  8
+    { NULL,        0, NULL,                NULL            },
+    { "string",    6, &IST_NULL_STRING,    NULL            }, // 10
+    { NULL,        0, NULL,                NULL            },
+    { "timestamp", 9, &IST_NULL_TIMESTAMP, NULL            }, // 12
+    { NULL,        0, NULL,                NULL            },
+    { "bool",      4, &IST_NULL_BOOL,      NULL            }, // 14
+    { "symbol",    6, &IST_NULL_SYMBOL,    NULL            }, // 15
+    { NULL,        0, NULL,                NULL            },
+    { NULL,        0, NULL,                NULL            },
+    { NULL,        0, NULL,                NULL            },
+    { "false",     5, NULL,                &IST_BOOL_FALSE }, // 19
+    { "nan",       3, NULL,                &IST_NAN        }, // 20
+    { "int",       3, &IST_NULL_INT,       NULL            }, // 21
+    { NULL,        0, NULL,                NULL            },
+    { "struct",    6, &IST_NULL_STRUCT,    NULL            }, // 23
+    { NULL,        0, NULL,                NULL            },
+    { "true",      4, NULL,                &IST_BOOL_TRUE  }, // 25
+    { "null",      4, &IST_NULL_NULL,      &IST_NULL_NULL  }, // 26
+    { NULL,        0, NULL,                NULL            },
+    { NULL,        0, NULL,                NULL            },
+    { NULL,        0, NULL,                NULL            },
+    { NULL,        0, NULL,                NULL            },
+    { NULL,        0, NULL,                NULL            },
+};
+
+static const ION_KEYWORD *_ion_scanner_find_keyword(char *buf, SIZE len)
+{
+    const ION_KEYWORD *keyword;
+
+    if (len < MIN_TYPE_NAME_LEN || len > MAX_TYPE_NAME_LEN) return NULL;
+
+    keyword = &_Ion_keywords[KEYWORD_SLOT(len, (BYTE)buf[0], (BYTE)buf[len - 1])];
+    if (keyword->length != len || memcmp(keyword->text, buf, len) != 0) return NULL;
+
+    return keyword;
+}
+
 ION_SUB_TYPE _ion_scanner_check_typename(char *buf, int len)
 {
-    if (len < MIN_TYPE_NAME_LEN || len > MAX_TYPE_NAME_LEN) return NULL;
+    const ION_KEYWORD *keyword = _ion_scanner_find_keyword(buf, len);
 
+    return (keyword && keyword->p_null_type) ? *keyword->p_null_type : NULL;
+}
 
-    
-    // check the string against type names or fail
-    switch(buf[0]) {
-    case 'b':
-        if (len != 4) return 0;
-	    if (strncmp("bool", buf, 4) == 0) return IST_NULL_BOOL;
-	    if (strncmp("blob", buf, 4) == 0) return IST_NULL_BLOB;
-	    break;
-    case 'c':
-        if (len != 4) return 0;
-	    if (strncmp("clob", buf, 4) == 0) return IST_NULL_CLOB;
-	    break;
-    case 'd':
-        if (len != 7) return 0;
-	    if (strncmp("decimal", buf, 7) == 0) return IST_NULL_DECIMAL;
-	    break;
-    case 'f':
-        if (len != 5) return 0;
-	    if (strncmp("float", buf, 5) == 0) return IST_NULL_FLOAT;
-	    break;
-    case 'i':
-        if (len != 3) return 0;
-	    if (strncmp("int", buf, 3) == 0) return IST_NULL_INT;
-	    break;
-    case 'l':
-        if (len != 4) return 0;
-	    if (strncmp("list", buf, 4) == 0) return IST_NULL_LIST;
-	    break;
-    case 'n':
-        if (len != 4) return 0;
-	    if (strncmp("null", buf, 4) == 0) return IST_NULL_NULL;
-	    break;
-    case 's':
-        if (len == 6) {
-    	    if (strncmp("string", buf, 6) == 0) return IST_NULL_STRING;
-	        if (strncmp("struct", buf, 6) == 0) return IST_NULL_STRUCT;
-	        if (strncmp("symbol", buf, 6) == 0) return IST_NULL_SYMBOL;
-        }
-        else if (len == 4) {
-            if (strncmp("sexp", buf, 4) == 0) return IST_NULL_SEXP;
-        }
-	    break;
-    case 't':
-        if (len != 9) return 0;
-        if (strncmp("timestamp", buf, 9) == 0) return IST_NULL_TIMESTAMP;
-	    break;
-    default:
-        break;
-    }
-    return 0;
+BOOL _ion_scanner_is_keyword(char *buf, SIZE len)
+{
+    const ION_KEYWORD *keyword = _ion_scanner_find_keyword(buf, len);
+
+    return keyword != NULL && keyword->p_keyword_type != NULL;
 }
 
 // c is an already read-ahead character
@@ -1993,7 +2011,7 @@ iERR _ion_scanner_read_as_base64(ION_SCANNER *scanner, BYTE *buf, SIZE len, SIZE
     iENTER;
     BOOL        eos_encountered = FALSE;
     BYTE       *dst = buf;
-    SIZE        remaining = len, written, output_length;
+    SIZE        remaining = len, written, output_length, quads;
     int         c, b64_value, b64_block;
     int         padding = 0;
 
@@ -2027,6 +2045,22 @@ iERR _ion_scanner_read_as_base64(ION_SCANNER *scanner, BYTE *buf, SIZE len, SIZE
     //  buffer
 
     while (remaining) {
+        // decode runs of whole 4 character groups straight out of the stream's buffer, anything
+        // else (whitespace, padding, the closing curlies, a page boundary) is handled below one
+        // character at a time
+        quads = (SIZE)((scanner->_stream->_limit - scanner->_stream->_curr) / 4);
+        if (quads > remaining / 3) {
+            quads = remaining / 3;
+        }
+        if (quads > 0) {
+            quads = _ion_base64_decode_quads(scanner->_stream->_curr, quads, dst);
+            scanner->_stream->_curr += quads * 4;
+            scanner->_col_offset += quads * 4;
+            dst += quads * 3;
+            remaining -= quads * 3;
+            if (!remaining) break;
+        }
+
         // this doesn't help perf, but whitespace is allowed so there's not 
         // much to do about it (and i'm not overly concerned about the perf 
         // of converting base64 text since it should an unusual case)
@@ -424,6 +424,7 @@ iERR _ion_scanner_peek_two_single_quotes            (ION_SCANNER *scanner, BOOL
 iERR _ion_scanner_peek_for_null                     (ION_SCANNER *scanner, BOOL *p_is_null, int *p_char);
 iERR _ion_scanner_read_null_type                    (ION_SCANNER *scanner, ION_SUB_TYPE *p_ist);
 ION_SUB_TYPE _ion_scanner_check_typename            (char *buf, int len);
+BOOL _ion_scanner_is_keyword                        (char *buf, SIZE len); // true, false, null or nan
 iERR _ion_scanner_is_value_terminator               (ION_SCANNER *scanner, int c, BOOL *p_is_terminator);
 iERR _ion_scanner_peek_keyword                      (ION_SCANNER *scanner, char *tail, BOOL *p_is_match);
 
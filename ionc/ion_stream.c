@@ -176,6 +176,16 @@ iERR ion_stream_open_buffer( BYTE *buffer       // pointer to memory to stream o
                            , SIZE buf_filled    // length of user filled data (0 or more bytes)
                            , BOOL read_only     // if read_only is true write is disallowed (read is always valid)
                            , ION_STREAM **pp_stream
+) {
+  return _ion_stream_open_buffer_helper(buffer, buf_length, buf_filled, read_only, NULL, pp_stream);
+}
+
+iERR _ion_stream_open_buffer_helper( BYTE *buffer
+                                   , SIZE buf_length
+                                   , SIZE buf_filled
+                                   , BOOL read_only
+                                   , ION_ALLOCATOR *allocator // NULL == the default allocator
+                                   , ION_STREAM **pp_stream
 ) {
   iENTER;
   ION_STREAM_FLAG  flags;
@@ -194,7 +204,7 @@ iERR ion_stream_open_buffer( BYTE *buffer       // pointer to memory to stream o
   }
  
   
-  IONCHECK(_ion_stream_open_helper(flags, buf_length, &stream));
+  IONCHECK(_ion_stream_open_helper(flags, buf_length, allocator, &stream));
 
   // here we manualy set up the state to mimic a paged stream
   // see _ion_stream_page_make_current
@@ -211,6 +221,34 @@ iERR ion_stream_open_buffer( BYTE *buffer       // pointer to memory to stream o
   iRETURN;
 }
 
+iERR _ion_stream_reset_buffer_helper( ION_STREAM *stream
+                                    , BYTE *buffer
+                                    , SIZE buf_length
+                                    , SIZE buf_filled
+) {
+  iENTER;
+
+  if (!stream)                  FAILWITH(IERR_INVALID_ARG);
+  if (!buffer)                  FAILWITH(IERR_INVALID_ARG);
+  if (buf_filled < 0)           FAILWITH(IERR_INVALID_ARG);
+  if (buf_length < buf_filled)  FAILWITH(IERR_INVALID_ARG);
+  if (!IS_FLAG_ON(stream->_flags, FLAG_IS_USER_BUFFER)) FAILWITH(IERR_INVALID_STATE);
+
+  // same state as _ion_stream_open_buffer_helper leaves behind
+  SET_FLAG_OFF(stream->_flags, (FLAG_IS_DIRTY | FLAG_IS_ANY_UPDATE | FLAG_IS_AT_EOF | FLAG_IS_FAKE_PAGE));
+  stream->_buffer       = buffer;
+  stream->_buffer_size  = buf_length;
+  stream->_offset       = 0;
+  stream->_limit        = buffer + buf_filled;
+  stream->_curr         = buffer;
+  stream->_mark         = -1;
+  stream->_dirty_start  = NULL;
+  stream->_dirty_length = 0;
+  SUCCEED();
+
+  iRETURN;
+}
+
 iERR ion_stream_open_stdin( ION_STREAM **pp_stream )
 {
   iENTER;
@@ -219,7 +257,7 @@ iERR ion_stream_open_stdin( ION_STREAM **pp_stream )
   
   if (!pp_stream) FAILWITH(IERR_INVALID_ARG);
 
-  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, &stream));
+  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, NULL, &stream));
 
   SET_MODE_BINARY(stdin);
   stream->_fp = stdin;
@@ -244,7 +282,7 @@ iERR ion_stream_open_stdout( ION_STREAM **pp_stream )
 
   if (!pp_stream) FAILWITH(IERR_INVALID_ARG);
 
-  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, &stream));
+  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, NULL, &stream));
   SET_MODE_BINARY(stdout);
   stream->_fp = stdout;
   IONCHECK(_ion_stream_fetch_position(stream, 0));
@@ -263,7 +301,7 @@ iERR ion_stream_open_stderr( ION_STREAM **pp_stream )
 
   if (!pp_stream) FAILWITH(IERR_INVALID_ARG);
 
-  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, &stream));
+  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, NULL, &stream));
   SET_MODE_BINARY(stderr);
   stream->_fp = stderr;
   IONCHECK(_ion_stream_fetch_position(stream, 0));
@@ -283,7 +321,7 @@ iERR ion_stream_open_file_in( FILE *in, ION_STREAM **pp_stream )
   if (!pp_stream) FAILWITH(IERR_INVALID_ARG);
   if (!in) FAILWITH(IERR_INVALID_ARG);
 
-  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, &stream));
+  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, NULL, &stream));
 
   stream->_fp = in;
   IONCHECK(_ion_stream_fetch_position(stream, 0));
@@ -303,7 +341,7 @@ iERR ion_stream_open_file_out( FILE *out, ION_STREAM **pp_stream )
   if (!pp_stream) FAILWITH(IERR_INVALID_ARG);
   if (!out) FAILWITH(IERR_INVALID_ARG);
    
-  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, &stream));
+  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, NULL, &stream));
   stream->_fp = out;
   IONCHECK(_ion_stream_fetch_position(stream, 0));
    
@@ -314,6 +352,11 @@ iERR ion_stream_open_file_out( FILE *out, ION_STREAM **pp_stream )
 }
 
 iERR ion_stream_open_file_rw( FILE *fp, BOOL cache_all, ION_STREAM **pp_stream )
+{
+  return _ion_stream_open_file_rw_helper(fp, NULL, pp_stream);
+}
+
+iERR _ion_stream_open_file_rw_helper( FILE *fp, ION_ALLOCATOR *allocator, ION_STREAM **pp_stream )
 {
   iENTER;
   ION_STREAM       *stream;
@@ -322,7 +365,7 @@ iERR ion_stream_open_file_rw( FILE *fp, BOOL cache_all, ION_STREAM **pp_stream )
   if (!pp_stream) FAILWITH(IERR_INVALID_ARG);
   if (!fp) FAILWITH(IERR_INVALID_ARG);
 
-  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, &stream));
+  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, allocator, &stream));
 
   stream->_fp = fp;
   IONCHECK(_ion_stream_fetch_position(stream, 0));
@@ -346,7 +389,7 @@ iERR ion_stream_open_fd_in( int fd_in, ION_STREAM **pp_stream )
 	  flags |= FLAG_IS_TTY;  // or should we throw an error ?
   }
 
-  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, &stream));
+  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, NULL, &stream));
   stream->_fp = FD_TO_FILEP(fd_in);
   IONCHECK(_ion_stream_fetch_position(stream, 0));
   
@@ -369,7 +412,7 @@ iERR ion_stream_open_fd_out( int fd_out, ION_STREAM **pp_stream )
 	  flags |= FLAG_IS_TTY;
   }
 
-  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, &stream));
+  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, NULL, &stream));
   stream->_fp = FD_TO_FILEP(fd_out);
   IONCHECK(_ion_stream_fetch_position(stream, 0));
   
@@ -392,7 +435,7 @@ iERR ion_stream_open_fd_rw( int fd, BOOL cache_all, ION_STREAM **pp_stream )
 	  flags |= FLAG_IS_TTY;  // or should we throw an error ?
   }
 
-  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, &stream));
+  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, NULL, &stream));
   stream->_fp = FD_TO_FILEP(fd);
   IONCHECK(_ion_stream_fetch_position(stream, 0));
   
@@ -403,6 +446,11 @@ iERR ion_stream_open_fd_rw( int fd, BOOL cache_all, ION_STREAM **pp_stream )
 }
 
 iERR ion_stream_open_memory_only( ION_STREAM **pp_stream )
+{
+  return _ion_stream_open_memory_only_helper(NULL, pp_stream);
+}
+
+iERR _ion_stream_open_memory_only_helper( ION_ALLOCATOR *allocator, ION_STREAM **pp_stream )
 {
   iENTER;
   ION_STREAM       *stream;
@@ -412,7 +460,7 @@ iERR ion_stream_open_memory_only( ION_STREAM **pp_stream )
 
   if (!pp_stream) FAILWITH(IERR_INVALID_ARG);
 
-  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, &stream));
+  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, allocator, &stream));
 
   // for the all in memory case 
   paged = PAGED_STREAM( stream );
@@ -427,6 +475,12 @@ iERR ion_stream_open_memory_only( ION_STREAM **pp_stream )
 }
 
 iERR ion_stream_open_handler_in( ION_STREAM_HANDLER fn_input_handler, void *handler_state, ION_STREAM **pp_stream )
+{
+  return _ion_stream_open_handler_in_helper(fn_input_handler, handler_state, NULL, pp_stream);
+}
+
+iERR _ion_stream_open_handler_in_helper( ION_STREAM_HANDLER fn_input_handler, void *handler_state, ION_ALLOCATOR *allocator
+                                      , ION_STREAM **pp_stream )
 {
   iENTER;
   ION_STREAM              *stream = NULL;
@@ -436,7 +490,7 @@ iERR ion_stream_open_handler_in( ION_STREAM_HANDLER fn_input_handler, void *hand
   if (!pp_stream) FAILWITH(IERR_INVALID_ARG);
   if (!fn_input_handler) FAILWITH(IERR_INVALID_ARG);
 
-  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, &stream));
+  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, allocator, &stream));
 
   user_stream = &(((ION_STREAM_USER_PAGED *)stream)->_user_stream);
 
@@ -451,6 +505,12 @@ iERR ion_stream_open_handler_in( ION_STREAM_HANDLER fn_input_handler, void *hand
 }
 
 iERR ion_stream_open_handler_out( ION_STREAM_HANDLER fn_output_handler, void *handler_state, ION_STREAM **pp_stream )
+{
+  return _ion_stream_open_handler_out_helper(fn_output_handler, handler_state, NULL, pp_stream);
+}
+
+iERR _ion_stream_open_handler_out_helper( ION_STREAM_HANDLER fn_output_handler, void *handler_state, ION_ALLOCATOR *allocator
+                                      , ION_STREAM **pp_stream )
 {
   iENTER;
   ION_STREAM              *stream = NULL;
@@ -460,7 +520,7 @@ iERR ion_stream_open_handler_out( ION_STREAM_HANDLER fn_output_handler, void *ha
   if (!pp_stream) FAILWITH(IERR_INVALID_ARG);
   if (!fn_output_handler) FAILWITH(IERR_INVALID_ARG);
 
-  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, &stream));
+  IONCHECK(_ion_stream_open_helper(flags, g_Ion_Stream_Default_Page_Size, allocator, &stream));
 
   user_stream = &(((ION_STREAM_USER_PAGED *)stream)->_user_stream);
   user_stream->handler_state = handler_state;
@@ -949,7 +1009,13 @@ iERR ion_stream_seek( ION_STREAM *stream, POSITION target_pos)
 
   if (_ion_stream_current_page_contains_position( stream, target_pos )) {
       stream->_curr = IH_CURR_OF( target_pos );
-  } 
+  }
+  else if (target_pos == IH_POSITION_OF(stream->_limit) && target_pos >= _ion_stream_position(stream)) {
+      // back to the end of what's been written on this page, after a write
+      // behind it. Fetching here would reset the limit from the page, which
+      // doesn't know about the bytes written since the page was made current
+      stream->_curr = stream->_limit;
+  }
   else {
 	if (_ion_stream_is_paged(stream) == FALSE) {
 		if (target_pos != _ion_stream_position(stream)) {
@@ -1126,7 +1192,7 @@ iERR _ion_stream_mark_clear_helper( ION_STREAM_PAGED *paged, POSITION position )
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-iERR _ion_stream_open_helper(ION_STREAM_FLAG flags, SIZE page_size, ION_STREAM **pp_stream)
+iERR _ion_stream_open_helper(ION_STREAM_FLAG flags, SIZE page_size, ION_ALLOCATOR *allocator, ION_STREAM **pp_stream)
 {
   iENTER;
   BOOL              user_buffer, user_managed;
@@ -1152,7 +1218,7 @@ iERR _ion_stream_open_helper(ION_STREAM_FLAG flags, SIZE page_size, ION_STREAM *
 	}
   }
 
-  stream = ion_alloc_owner(len);
+  stream = ion_alloc_owner_with_allocator(len, allocator);
   if (!stream) FAILWITH(IERR_NO_MEMORY);
    
   memset(stream, 0, len);
@@ -1200,6 +1266,11 @@ iERR _ion_stream_flush_helper(ION_STREAM *stream)
   
   if (_ion_stream_is_dirty(stream)) {
     if (_ion_stream_is_file_backed(stream)) {
+      if (_ion_stream_can_read(stream) && !_ion_stream_is_user_controlled(stream)) {
+        // reads move the file position, and the dirty bytes may be anywhere
+        // behind the end, so put the file where these bytes belong
+        IONCHECK(_ion_stream_fseek(stream, IH_POSITION_OF(stream->_dirty_start)));
+      }
       // now we either write through the user handler, or directly to the file
       if (_ion_stream_is_user_controlled(stream)) {
         user_stream = &(((ION_STREAM_USER_PAGED *)stream)->_user_stream);
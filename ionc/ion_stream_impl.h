@@ -195,7 +195,7 @@ struct _ion_stream_paged // extends _ion_stream
   ION_PAGE         *_free_pages;  // list of allocated pages but unused pages 
   // the ION_INDEX is a hashed index which requires pages to all be the same 
   // size so that locations can be converted to page numbers functionally
-  ION_INDEX         _index;       // index into current pages by page_offset (9 ptrs, 6 int32's, 1 byte == 61 or 97 bytes)
+  ION_INDEX         _index;       // index into current pages by page_offset (5 ptrs, 5 int32's, 1 byte == 41 or 61 bytes)
 }; // ( 15 ptrs, 9 int32's, 1 byte = 97 - 157 bytes) which means it's probably still worth having the two structs
 
 struct _ion_stream_user_paged // extends _ion_stream_paged
@@ -233,7 +233,16 @@ struct _ion_page
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-iERR _ion_stream_open_helper( ION_STREAM_FLAG flags, SIZE page_size, ION_STREAM **pp_stream );
+iERR _ion_stream_open_helper( ION_STREAM_FLAG flags, SIZE page_size, ION_ALLOCATOR *allocator, ION_STREAM **pp_stream );
+iERR _ion_stream_open_buffer_helper( BYTE *buffer, SIZE buf_length, SIZE buf_filled, BOOL read_only
+                                   , ION_ALLOCATOR *allocator, ION_STREAM **pp_stream );
+iERR _ion_stream_reset_buffer_helper( ION_STREAM *stream, BYTE *buffer, SIZE buf_length, SIZE buf_filled );
+iERR _ion_stream_open_memory_only_helper( ION_ALLOCATOR *allocator, ION_STREAM **pp_stream );
+iERR _ion_stream_open_file_rw_helper( FILE *fp, ION_ALLOCATOR *allocator, ION_STREAM **pp_stream );
+iERR _ion_stream_open_handler_in_helper( ION_STREAM_HANDLER fn_input_handler, void *handler_state
+                                       , ION_ALLOCATOR *allocator, ION_STREAM **pp_stream );
+iERR _ion_stream_open_handler_out_helper( ION_STREAM_HANDLER fn_output_handler, void *handler_state
+                                        , ION_ALLOCATOR *allocator, ION_STREAM **pp_stream );
 iERR _ion_stream_flush_helper( ION_STREAM *stream );
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -19,6 +19,7 @@
 
 #include "ion_internal.h"
 #include <ctype.h>
+#include <stddef.h>
 #include <string.h>
 //#include "hashfn.h"
 
@@ -32,7 +33,9 @@ struct _ion_symbol_table
 {
     void               *owner;          // this may be a reader, writer, catalog or itself
     BOOL                is_locked;
+    BOOL                is_frozen;      // locked and never written again, even by lookups; see _ion_symbol_table_freeze_helper.
     BOOL                has_local_symbols;
+    BOOL                shares_storage; // symbols, imports and indices are borrowed from the locked table this was cloned from; see _ion_symbol_table_unshare_helper.
     ION_STRING          name;
     int32_t             version;
     SID                 max_id;         // the max SID of this symbol tables symbols, including shared symbols.
@@ -46,9 +49,14 @@ struct _ion_symbol_table
     ION_SYMBOL        **by_id;          // the local symbols. Accessing shared symbols requires delegate lookups to the imports.
     ION_INDEX           by_name;        // the local symbols (by name).
 
+    SID                 flat_max_id;    // the highest SID held by flat_by_sid; 0 if the imported SIDs have not been flattened.
+    ION_SYMBOL        **flat_by_sid;    // the system and imported symbols of a local table, indexed directly by SID.
+    BOOL                flat_declined;  // the imported SIDs are too many or too sparse to flatten; cleared when the imports change.
+
 };
 
 iERR _ion_symbol_table_local_find_by_sid(ION_SYMBOL_TABLE *symtab, SID sid, ION_SYMBOL **p_sym);
+static iERR _ion_symbol_table_find_imported_symbol_by_sid(ION_SYMBOL_TABLE *symtab, SID sid, ION_SYMBOL **p_sym);
 
 iERR ion_symbol_table_open(hSYMTAB *p_hsymtab, hOWNER owner)
 {
@@ -205,6 +213,28 @@ iERR _ion_symbol_table_clone_with_owner_helper(ION_SYMBOL_TABLE **p_pclone, ION_
     // since these value should be immutable if the owner
     // has NOT changed we can use cheaper copies
     new_owner = (orig->owner != clone->owner);
+
+    if (orig->is_locked && (orig->is_frozen || !new_owner)) {
+        // A locked table never changes again, and this one will outlive the clone: either they share an owner, or
+        // it is frozen (and frozen tables outlive their users, see ion_catalog_freeze). So rather than copying, the
+        // clone borrows its storage and indices, and copies them only if it is itself modified.
+        if (is_shared) {
+            clone->version = orig->version;
+            ION_STRING_ASSIGN(&clone->name, &orig->name);
+        }
+        clone->import_list = orig->import_list;
+        clone->symbols = orig->symbols;
+        clone->by_id_max = orig->by_id_max;
+        clone->by_id = orig->by_id;
+        clone->by_name = orig->by_name;
+        clone->flat_max_id = orig->flat_max_id;
+        clone->flat_by_sid = orig->flat_by_sid;
+        clone->flat_declined = orig->flat_declined;
+        clone->shares_storage = TRUE;
+        *p_pclone = clone;
+        SUCCEED();
+    }
+
     if (is_shared) {
         // if this is a shared table we copy the name and version
         clone->version = orig->version;
@@ -241,104 +271,170 @@ iERR _ion_symbol_table_clone_with_owner_helper(ION_SYMBOL_TABLE **p_pclone, ION_
     iRETURN;
 }
 
-iERR ion_symbol_table_get_system_table(hSYMTAB *p_hsystem_table, int32_t version)
+iERR _ion_symbol_table_unshare_helper(ION_SYMBOL_TABLE *symtab)
 {
     iENTER;
-    ION_SYMBOL_TABLE *system;
+    ION_COLLECTION borrowed_imports, borrowed_symbols;
 
-    if (p_hsystem_table == NULL) FAILWITH(IERR_INVALID_ARG);
-    if (version != 1)            FAILWITH(IERR_INVALID_ION_VERSION);
+    ASSERT(symtab != NULL);
+    ASSERT(!symtab->is_locked);
 
-    IONCHECK(_ion_symbol_table_get_system_symbol_helper(&system, version));
-    *p_hsystem_table = PTR_TO_HANDLE(system);
+    if (!symtab->shares_storage) SUCCEED();
+
+    // The table the storage was borrowed from outlives this one, so the strings and imported tables it refers to can
+    // still be shared; only the collections themselves are copied. The indices are rebuilt on demand, as they would
+    // be for any other clone.
+    borrowed_imports = symtab->import_list;
+    borrowed_symbols = symtab->symbols;
+    _ion_collection_initialize(symtab->owner, &symtab->import_list, sizeof(ION_SYMBOL_TABLE_IMPORT));
+    _ion_collection_initialize(symtab->owner, &symtab->symbols, sizeof(ION_SYMBOL));
+    IONCHECK(_ion_collection_copy(&symtab->import_list, &borrowed_imports, _ion_symbol_table_local_import_copy_same_owner, symtab->owner));
+    IONCHECK(_ion_collection_copy(&symtab->symbols, &borrowed_symbols, _ion_symbol_local_copy_same_owner, symtab->owner));
+
+    symtab->by_id_max = 0;
+    symtab->by_id = NULL;
+    memset(&symtab->by_name, 0, sizeof(symtab->by_name));
+    symtab->flat_max_id = 0;
+    symtab->flat_by_sid = NULL;
+    symtab->shares_storage = FALSE;
 
     iRETURN;
 }
 
-// HACK - TODO - hate this
-static THREAD_LOCAL_STORAGE ION_SYMBOL_TABLE *p_system_symbol_table_version_1 = NULL;
-
-iERR _ion_symbol_table_get_system_symbol_helper(ION_SYMBOL_TABLE **pp_system_table, int32_t version)
+iERR ion_symbol_table_get_system_table(hSYMTAB *p_hsystem_table, int32_t version)
 {
     iENTER;
+    ION_SYMBOL_TABLE *system;
 
-    ASSERT( pp_system_table != NULL );
-    ASSERT( version == 1 ); // only one we understand at this point
+    if (p_hsystem_table == NULL) FAILWITH(IERR_INVALID_ARG);
+    if (version != 1)            FAILWITH(IERR_INVALID_ION_VERSION);
 
-    if (!p_system_symbol_table_version_1) {
-        IONCHECK(_ion_symbol_table_local_make_system_symbol_table_helper(version));
-    }
-    *pp_system_table = p_system_symbol_table_version_1;
+    IONCHECK(_ion_symbol_table_get_system_symbol_helper(&system, version));
+    *p_hsystem_table = PTR_TO_HANDLE(system);
 
     iRETURN;
 }
 
+// The Ion 1.0 system symbol table is constant, so it is laid out here at compile time: locked, indexed by SID and
+// frozen (its import locations are already set). Every thread shares it and none has to build it. Its nodes must have
+// the layout _ion_collection_append gives an ION_SYMBOL, so the table's symbols can be iterated like any other's.
+typedef struct _ion_system_symbol_node
+{
+    ION_COLLECTION_NODE *_next;
+    ION_COLLECTION_NODE *_prev;
+    ION_SYMBOL           symbol;
+} ION_SYSTEM_SYMBOL_NODE;
+
+typedef char ION_SYSTEM_SYMBOL_NODE_LAYOUT_CHECK[(offsetof(ION_SYSTEM_SYMBOL_NODE, symbol) == IPCN_OVERHEAD_SIZE) ? 1 : -1];
+
+#define SYSTEM_SYMBOL_NODE_PTR(index)  ((ION_COLLECTION_NODE *)&_Ion_system_symbol_nodes[index])
+#define SYSTEM_SYMBOL_NODE(sid, strlen, bytes, next, prev) \
+    { next, prev, { sid, { strlen, bytes }, { { ION_SYS_STRLEN_ION, ION_SYMBOL_ION_BYTES }, sid }, 0, 0 } }
+
+static ION_SYSTEM_SYMBOL_NODE _Ion_system_symbol_nodes[ION_SYS_SID_SHARED_SYMBOL_TABLE] = {
+    SYSTEM_SYMBOL_NODE(ION_SYS_SID_ION, ION_SYS_STRLEN_ION, ION_SYMBOL_ION_BYTES,
+                       SYSTEM_SYMBOL_NODE_PTR(1), NULL),
+    SYSTEM_SYMBOL_NODE(ION_SYS_SID_IVM, ION_SYS_STRLEN_IVM, ION_SYMBOL_VTM_BYTES,
+                       SYSTEM_SYMBOL_NODE_PTR(2), SYSTEM_SYMBOL_NODE_PTR(0)),
+    SYSTEM_SYMBOL_NODE(ION_SYS_SID_SYMBOL_TABLE, ION_SYS_STRLEN_SYMBOL_TABLE, ION_SYMBOL_SYMBOL_TABLE_BYTES,
+                       SYSTEM_SYMBOL_NODE_PTR(3), SYSTEM_SYMBOL_NODE_PTR(1)),
+    SYSTEM_SYMBOL_NODE(ION_SYS_SID_NAME, ION_SYS_STRLEN_NAME, ION_SYMBOL_NAME_BYTES,
+                       SYSTEM_SYMBOL_NODE_PTR(4), SYSTEM_SYMBOL_NODE_PTR(2)),
+    SYSTEM_SYMBOL_NODE(ION_SYS_SID_VERSION, ION_SYS_STRLEN_VERSION, ION_SYMBOL_VERSION_BYTES,
+                       SYSTEM_SYMBOL_NODE_PTR(5), SYSTEM_SYMBOL_NODE_PTR(3)),
+    SYSTEM_SYMBOL_NODE(ION_SYS_SID_IMPORTS, ION_SYS_STRLEN_IMPORTS, ION_SYMBOL_IMPORTS_BYTES,
+                       SYSTEM_SYMBOL_NODE_PTR(6), SYSTEM_SYMBOL_NODE_PTR(4)),
+    SYSTEM_SYMBOL_NODE(ION_SYS_SID_SYMBOLS, ION_SYS_STRLEN_SYMBOLS, ION_SYMBOL_SYMBOLS_BYTES,
+                       SYSTEM_SYMBOL_NODE_PTR(7), SYSTEM_SYMBOL_NODE_PTR(5)),
+    SYSTEM_SYMBOL_NODE(ION_SYS_SID_MAX_ID, ION_SYS_STRLEN_MAX_ID, ION_SYMBOL_MAX_ID_BYTES,
+                       SYSTEM_SYMBOL_NODE_PTR(8), SYSTEM_SYMBOL_NODE_PTR(6)),
+    SYSTEM_SYMBOL_NODE(ION_SYS_SID_SHARED_SYMBOL_TABLE, ION_SYS_STRLEN_SHARED_SYMBOL_TABLE, ION_SYMBOL_SHARED_SYMBOL_TABLE_BYTES,
+                       NULL, SYSTEM_SYMBOL_NODE_PTR(7)),
+};
 
-// currently the system symbol table uses 1304 bytes or so
-#define kIonSystemSymbolMemorySize 2048
-// This needs to be aligned to `ALLOC_ALIGNMENT` bytes since it's being used as a block of memory
-// The ION_ALLOCATION_CHAIN created at the beginning of the memory array might need a wider alignment than what a char[] provides by default
-// User data allocated within this block will also likely need a wider alignment, but this is taken care of by the `ION_ALLOC_BLOCK_TO_USER_PTR` macro
-static THREAD_LOCAL_STORAGE ALIGN_AS(ALLOC_ALIGNMENT) char gSystemSymbolMemory[kIonSystemSymbolMemorySize];
-
-void* smallLocalAllocationBlock()
-{
-    ION_ALLOCATION_CHAIN *new_block = (ION_ALLOCATION_CHAIN*)gSystemSymbolMemory;
-    SIZE                  alloc_size = kIonSystemSymbolMemorySize;
-
-    // Assert that the new block is aligned
-    assert(new_block == (ION_ALLOCATION_CHAIN *)ALIGN_PTR(new_block));
+#define SYSTEM_SYMBOL(sid)  (&_Ion_system_symbol_nodes[(sid) - 1].symbol)
+
+// by_id of the system table (and of its clones, until they are modified); slot 0 is unused since SIDs are 1 based
+static ION_SYMBOL *_Ion_system_symbols_by_sid[ION_SYS_SID_SHARED_SYMBOL_TABLE + 1] = {
+    NULL,
+    SYSTEM_SYMBOL(ION_SYS_SID_ION),
+    SYSTEM_SYMBOL(ION_SYS_SID_IVM),
+    SYSTEM_SYMBOL(ION_SYS_SID_SYMBOL_TABLE),
+    SYSTEM_SYMBOL(ION_SYS_SID_NAME),
+    SYSTEM_SYMBOL(ION_SYS_SID_VERSION),
+    SYSTEM_SYMBOL(ION_SYS_SID_IMPORTS),
+    SYSTEM_SYMBOL(ION_SYS_SID_SYMBOLS),
+    SYSTEM_SYMBOL(ION_SYS_SID_MAX_ID),
+    SYSTEM_SYMBOL(ION_SYS_SID_SHARED_SYMBOL_TABLE),
+};
 
-    new_block->size     = alloc_size;
+// A perfect hash of the system symbols: each one's length and first and last bytes put it in its own slot, so a
+// lookup by name is one hash and at most one compare.
+#define SYSTEM_SYMBOL_SLOT_COUNT 16
+#define SYSTEM_SYMBOL_SLOT(length, first, last) ((((length) * 6) + (first) + (last)) & (SYSTEM_SYMBOL_SLOT_COUNT - 1))
+
+static ION_SYMBOL *const _Ion_system_symbols_by_slot[SYSTEM_SYMBOL_SLOT_COUNT] = {
+    SYSTEM_SYMBOL(ION_SYS_SID_SYMBOLS),             //  0: "symbols"
+    NULL,
+    NULL,
+    NULL,
+    SYSTEM_SYMBOL(ION_SYS_SID_IVM),                 //  4: "$ion_1_0"
+    SYSTEM_SYMBOL(ION_SYS_SID_MAX_ID),              //  5: "max_id"
+    SYSTEM_SYMBOL(ION_SYS_SID_IMPORTS),             //  6: "imports"
+    NULL,
+    NULL,
+    SYSTEM_SYMBOL(ION_SYS_SID_SHARED_SYMBOL_TABLE), //  9: "$ion_shared_symbol_table"
+    SYSTEM_SYMBOL(ION_SYS_SID_ION),                 // 10: "$ion"
+    SYSTEM_SYMBOL(ION_SYS_SID_NAME),                // 11: "name"
+    NULL,
+    NULL,
+    SYSTEM_SYMBOL(ION_SYS_SID_VERSION),             // 14: "version"
+    SYSTEM_SYMBOL(ION_SYS_SID_SYMBOL_TABLE),        // 15: "$ion_symbol_table"
+};
 
-    new_block->next     = NULL;
-    new_block->head     = NULL;
+static ION_SYMBOL_TABLE _Ion_system_symbol_table_version_1 = {
+    .owner               = NULL,    // not in any arena: a clone of it is opened with an owner of its own
+    .is_locked           = TRUE,
+    .is_frozen           = TRUE,
+    .has_local_symbols   = TRUE,
+    .name                = { ION_SYS_STRLEN_ION, ION_SYMBOL_ION_BYTES },
+    .version             = 1,
+    .max_id              = ION_SYS_SID_SHARED_SYMBOL_TABLE,
+    .min_local_id        = 0,
+    .import_list         = { NULL, IPCN_OVERHEAD_SIZE + sizeof(ION_SYMBOL_TABLE_IMPORT), 0, NULL, NULL, NULL },
+    .symbols             = { NULL, IPCN_OVERHEAD_SIZE + sizeof(ION_SYMBOL), ION_SYS_SID_SHARED_SYMBOL_TABLE,
+                             SYSTEM_SYMBOL_NODE_PTR(0), SYSTEM_SYMBOL_NODE_PTR(ION_SYS_SID_SHARED_SYMBOL_TABLE - 1), NULL },
+    .system_symbol_table = &_Ion_system_symbol_table_version_1,   // the system symbol table is its own system symbol table
+    .by_id_max           = ION_SYS_SID_SHARED_SYMBOL_TABLE,
+    .by_id               = _Ion_system_symbols_by_sid,
+    // by_name stays empty; see _ion_symbol_table_system_find_by_name
+};
 
-    new_block->position = ION_ALLOC_BLOCK_TO_USER_PTR(new_block);
-    new_block->limit    = ((BYTE*)new_block) + alloc_size;
+iERR _ion_symbol_table_get_system_symbol_helper(ION_SYMBOL_TABLE **pp_system_table, int32_t version)
+{
+    ASSERT( pp_system_table != NULL );
+    ASSERT( version == 1 ); // only one we understand at this point
 
-    // Assert that the user data pointer we're about to hand out is aligned and lives past the end of the allocation chain
-    assert(new_block->position == ((BYTE *)ALIGN_PTR((BYTE *)(&new_block->limit) + ALIGN_SIZE(sizeof(new_block->limit)))));
+    *pp_system_table = &_Ion_system_symbol_table_version_1;
 
-    return new_block->position;
+    return IERR_OK;
 }
 
-// HACK - hate this
-iERR _ion_symbol_table_local_make_system_symbol_table_helper(int32_t version)
-{
-    iENTER;
-    ION_SYMBOL_TABLE      *psymtab;
-    hOWNER sysBlock;
-
-    ASSERT( version == 1 ); // only one we understand at this point
-    ASSERT(p_system_symbol_table_version_1 == NULL);
-    
-    // need a SMALL block for the system symbol table
-    sysBlock = smallLocalAllocationBlock();
-    
-    IONCHECK(_ion_symbol_table_open_helper(&psymtab, sysBlock, NULL));
+static THREAD_LOCAL_STORAGE ION_SYMBOL _Ion_unknown_text_symbol;
 
-    psymtab->version = version;
-    ION_STRING_ASSIGN(&psymtab->name, &ION_SYMBOL_ION_STRING);
-    psymtab->system_symbol_table = psymtab; // the system symbol table is it's own system symbol table (hmmm)
+static BYTE       _Ion_symbol_zero_bytes[] = { '$', '0', 0 };
+static ION_STRING _Ion_symbol_zero_name = { 2, _Ion_symbol_zero_bytes };
 
-    IONCHECK(_ion_symbol_table_local_add_symbol_helper(psymtab, &ION_SYMBOL_ION_STRING, ION_SYS_SID_ION, NULL));
-    IONCHECK(_ion_symbol_table_local_add_symbol_helper(psymtab, &ION_SYMBOL_VTM_STRING, ION_SYS_SID_IVM, NULL));
-    IONCHECK(_ion_symbol_table_local_add_symbol_helper(psymtab, &ION_SYMBOL_SYMBOL_TABLE_STRING, ION_SYS_SID_SYMBOL_TABLE, NULL));
-    IONCHECK(_ion_symbol_table_local_add_symbol_helper(psymtab, &ION_SYMBOL_NAME_STRING, ION_SYS_SID_NAME, NULL));
-    IONCHECK(_ion_symbol_table_local_add_symbol_helper(psymtab, &ION_SYMBOL_VERSION_STRING, ION_SYS_SID_VERSION, NULL));
-    IONCHECK(_ion_symbol_table_local_add_symbol_helper(psymtab, &ION_SYMBOL_IMPORTS_STRING, ION_SYS_SID_IMPORTS, NULL));
-    IONCHECK(_ion_symbol_table_local_add_symbol_helper(psymtab, &ION_SYMBOL_SYMBOLS_STRING, ION_SYS_SID_SYMBOLS, NULL));
-    IONCHECK(_ion_symbol_table_local_add_symbol_helper(psymtab, &ION_SYMBOL_MAX_ID_STRING, ION_SYS_SID_MAX_ID, NULL));
-    IONCHECK(_ion_symbol_table_local_add_symbol_helper(psymtab, &ION_SYMBOL_SHARED_SYMBOL_TABLE_STRING, ION_SYS_SID_SHARED_SYMBOL_TABLE, NULL));
+static ION_SYMBOL *_ion_symbol_table_system_find_by_name(ION_STRING *name)
+{
+    ION_SYMBOL *sym;
 
-    IONCHECK(_ion_symbol_table_lock_helper(psymtab));
+    if (name->length < 1) return NULL;
 
-    // TODO: THREADING - THIS ASSIGNMENT NEEDS TO BE MAKE THREAD SAFE !!
-    // but we only need 1 copy of each system symbol table (the system symbol table)
-    p_system_symbol_table_version_1 = psymtab;
+    sym = _Ion_system_symbols_by_slot[SYSTEM_SYMBOL_SLOT(name->length, name->value[0], name->value[name->length - 1])];
+    if (sym == NULL || !ION_STRING_EQUALS(&sym->value, name)) return NULL;
 
-    iRETURN;
+    return sym;
 }
 
 iERR _ion_symbol_table_local_load_import_list(ION_READER *preader, hOWNER owner, ION_COLLECTION *pimport_list)
@@ -450,6 +546,7 @@ iERR _ion_symbol_table_local_load_symbol_list(ION_READER *preader, hOWNER owner,
             ION_STRING_ASSIGN(&sym->value, &str);
         }
         sym->sid = UNKNOWN_SID;
+        sym->hash = 0;
         ION_STRING_INIT(&sym->import_location.name);
         sym->import_location.location = UNKNOWN_SID;
     }
@@ -515,6 +612,7 @@ iERR _ion_symbol_table_append(ION_READER *preader, hOWNER owner, ION_SYMBOL_TABL
         // Copy all the symbols and imports of the current symbol table into the new symbol table.
         IONCHECK(_ion_symbol_table_clone_with_owner_helper(&cloned, preader->_current_symtab, owner, system));
         if (!ION_COLLECTION_IS_EMPTY(symbols_to_append)) {
+            IONCHECK(_ion_symbol_table_unshare_helper(cloned));
             ION_COLLECTION_OPEN(symbols_to_append, symbol_cursor);
             for (;;) {
                 ION_COLLECTION_NEXT(symbol_cursor, symbol_to_append);
@@ -525,6 +623,7 @@ iERR _ion_symbol_table_append(ION_READER *preader, hOWNER owner, ION_SYMBOL_TABL
                 appended_symbol->import_location.location = UNKNOWN_SID;
                 ION_STRING_ASSIGN(&appended_symbol->value, &symbol_to_append->value);
                 appended_symbol->sid = UNKNOWN_SID; // This is assigned correctly later.
+                appended_symbol->hash = 0;
             }
             ION_COLLECTION_CLOSE(symbol_cursor);
         }
@@ -536,6 +635,11 @@ iERR _ion_symbol_table_append(ION_READER *preader, hOWNER owner, ION_SYMBOL_TABL
 }
 
 iERR _ion_symbol_table_load_helper(ION_READER *preader, hOWNER owner, ION_SYMBOL_TABLE *system, ION_SYMBOL_TABLE **p_psymtab)
+{
+    return _ion_symbol_table_load_with_context_helper(preader, owner, system, p_psymtab, NULL);
+}
+
+iERR _ion_symbol_table_load_with_context_helper(ION_READER *preader, hOWNER owner, ION_SYMBOL_TABLE *system, ION_SYMBOL_TABLE **p_psymtab, BOOL *p_appends)
 {
     iENTER;
     ION_SYMBOL_TABLE        *symtab;
@@ -551,6 +655,7 @@ iERR _ion_symbol_table_load_helper(ION_READER *preader, hOWNER owner, ION_SYMBOL
     ASSERT(preader   != NULL);
     ASSERT(p_psymtab != NULL);
 
+    if (p_appends) *p_appends = FALSE;
     ION_STRING_INIT(&name);
     ION_STRING_INIT(&str);
 
@@ -622,6 +727,7 @@ iERR _ion_symbol_table_load_helper(ION_READER *preader, hOWNER owner, ION_SYMBOL
                 IONCHECK(_ion_reader_read_string_helper(preader, &str));
                 if (ION_STRING_EQUALS(&ION_SYMBOL_SYMBOL_TABLE_STRING, &str)) {
                     // This LST's symbols should be appended to the previous context's symbols.
+                    if (p_appends) *p_appends = TRUE;
                     IONCHECK(_ion_symbol_table_append(preader, owner, system, &symtab->symbols, &symtab));
                     processed_imports = TRUE;
                 }
@@ -829,12 +935,282 @@ iERR _ion_symbol_table_lock_helper(ION_SYMBOL_TABLE *symtab)
     if (symtab->max_id > 0 && !INDEX_IS_ACTIVE(symtab)) {
         IONCHECK(_ion_symbol_table_initialize_indices_helper(symtab));
     }
+    IONCHECK(_ion_symbol_table_flatten_imports_helper(symtab));
 
     symtab->is_locked = TRUE;
 
     iRETURN;;
 }
 
+iERR _ion_symbol_table_freeze_helper(ION_SYMBOL_TABLE *symtab)
+{
+    iENTER;
+    ION_COLLECTION_CURSOR   symbol_cursor;
+    ION_SYMBOL             *sym;
+    int32_t                 old_count, new_count;
+
+    ASSERT(symtab != NULL);
+    if (symtab->is_frozen) SUCCEED();
+
+    IONCHECK(_ion_symbol_table_lock_helper(symtab));
+
+    // Lookups on an ordinary locked table still write: they stamp the import location onto shared symbols, and
+    // allocate symbols with unknown text for SIDs past the end of by_id. Do both up front so a frozen table can be
+    // read from any number of threads at once.
+    if (INDEX_IS_ACTIVE(symtab) && symtab->max_id - symtab->min_local_id > symtab->by_id_max) {
+        old_count = symtab->by_id_max + 1;
+        new_count = symtab->max_id - symtab->min_local_id + 1;
+        IONCHECK(_ion_index_grow_array((void **)&symtab->by_id, old_count, new_count, sizeof(symtab->by_id[0]), TRUE, symtab->owner));
+        symtab->by_id_max = new_count - 1;
+    }
+    if (!ION_STRING_IS_NULL(&symtab->name)) {
+        ION_COLLECTION_OPEN(&symtab->symbols, symbol_cursor);
+        for (;;) {
+            ION_COLLECTION_NEXT(symbol_cursor, sym);
+            if (!sym) break;
+            if (sym->import_location.location == sym->sid && sym->import_location.name.value == symtab->name.value) {
+                continue; // already set, possibly in storage borrowed from the table this one was cloned from
+            }
+            ION_STRING_ASSIGN(&sym->import_location.name, &symtab->name);
+            sym->import_location.location = sym->sid;
+        }
+        ION_COLLECTION_CLOSE(symbol_cursor);
+    }
+
+    symtab->is_frozen = TRUE;
+
+    iRETURN;
+}
+
+iERR _ion_symbol_table_adopt_import_helper(ION_SYMBOL_TABLE **p_pimport, ION_SYMBOL_TABLE *import_symtab, hOWNER owner)
+{
+    iENTER;
+
+    ASSERT(p_pimport != NULL);
+    ASSERT(import_symtab != NULL);
+
+    if (import_symtab->is_frozen || import_symtab->owner == owner) {
+        // frozen tables are immutable and outlive their users (see ion_catalog_freeze), so they are shared
+        *p_pimport = import_symtab;
+    }
+    else {
+        IONCHECK(_ion_symbol_table_clone_with_owner_helper(p_pimport, import_symtab, owner, import_symtab->system_symbol_table));
+    }
+
+    iRETURN;
+}
+
+// Lets an image reader tell whether the hashes in the image were computed the same way its own would be.
+static uint32_t _ion_symbol_table_image_hash_check()
+{
+    ION_SYMBOL sym;
+
+    memset(&sym, 0, sizeof(sym));
+    ION_STRING_ASSIGN(&sym.value, &ION_SYMBOL_SYMBOL_TABLE_STRING);
+    return (uint32_t)_ion_symbol_table_hash_fn(&sym, NULL);
+}
+
+iERR ion_symbol_table_write_image(hSYMTAB hsymtab, BYTE *buffer, SIZE buffer_length, SIZE *p_image_length)
+{
+    iENTER;
+    ION_SYMBOL_TABLE *symtab;
+
+    if (hsymtab == NULL) FAILWITH(IERR_INVALID_ARG);
+    if (buffer_length < 0) FAILWITH(IERR_INVALID_ARG);
+    if (p_image_length == NULL) FAILWITH(IERR_INVALID_ARG);
+
+    symtab = HANDLE_TO_PTR(hsymtab, ION_SYMBOL_TABLE);
+
+    IONCHECK(_ion_symbol_table_write_image_helper(symtab, buffer, buffer_length, p_image_length));
+
+    iRETURN;
+}
+
+iERR _ion_symbol_table_write_image_helper(ION_SYMBOL_TABLE *symtab, BYTE *buffer, SIZE buffer_length, SIZE *p_image_length)
+{
+    iENTER;
+    ION_SYMBOL_TABLE_TYPE          type;
+    ION_SYMBOL_TABLE_IMAGE_HEADER *header;
+    ION_SYMBOL_TABLE_IMAGE_ENTRY  *entry;
+    ION_COLLECTION_CURSOR          symbol_cursor;
+    ION_SYMBOL                    *sym, key_sym;
+    int64_t                        image_length;
+    uint32_t                       text_offset;
+
+    ASSERT(symtab != NULL);
+    ASSERT(p_image_length != NULL);
+
+    IONCHECK(_ion_symbol_table_get_type_helper(symtab, &type));
+    if (type != ist_SHARED) FAILWITH(IERR_INVALID_ARG);
+    if (!symtab->is_locked) FAILWITH(IERR_INVALID_STATE);
+
+    image_length = sizeof(ION_SYMBOL_TABLE_IMAGE_HEADER)
+                 + (int64_t)symtab->symbols._count * sizeof(ION_SYMBOL_TABLE_IMAGE_ENTRY)
+                 + symtab->name.length;
+    ION_COLLECTION_OPEN(&symtab->symbols, symbol_cursor);
+    for (;;) {
+        ION_COLLECTION_NEXT(symbol_cursor, sym);
+        if (!sym) break;
+        if (!ION_STRING_IS_NULL(&sym->value)) image_length += sym->value.length;
+    }
+    ION_COLLECTION_CLOSE(symbol_cursor);
+    if (image_length > INT32_MAX) FAILWITH(IERR_NUMERIC_OVERFLOW);
+
+    *p_image_length = (SIZE)image_length;
+    if (buffer == NULL) SUCCEED(); // they just wanted the size
+    if (buffer_length < image_length) FAILWITH(IERR_BUFFER_TOO_SMALL);
+    if (((intptr_t)buffer) & (sizeof(uint32_t) - 1)) FAILWITH(IERR_INVALID_ARG);
+
+    header = (ION_SYMBOL_TABLE_IMAGE_HEADER *)buffer;
+    memset(header, 0, sizeof(*header));
+    header->magic          = ION_SYMBOL_TABLE_IMAGE_MAGIC;
+    header->format_version = ION_SYMBOL_TABLE_IMAGE_VERSION;
+    header->hash_check     = _ion_symbol_table_image_hash_check();
+    header->image_length   = (uint32_t)image_length;
+    header->version        = symtab->version;
+    header->max_id         = symtab->max_id;
+    header->symbol_count   = (uint32_t)symtab->symbols._count;
+    header->entries_offset = sizeof(ION_SYMBOL_TABLE_IMAGE_HEADER);
+
+    text_offset = header->entries_offset + header->symbol_count * sizeof(ION_SYMBOL_TABLE_IMAGE_ENTRY);
+    header->name_offset = text_offset;
+    header->name_length = (uint32_t)symtab->name.length;
+    memcpy(buffer + text_offset, symtab->name.value, symtab->name.length);
+    text_offset += header->name_length;
+
+    entry = (ION_SYMBOL_TABLE_IMAGE_ENTRY *)(buffer + header->entries_offset);
+    ION_COLLECTION_OPEN(&symtab->symbols, symbol_cursor);
+    for (;;) {
+        ION_COLLECTION_NEXT(symbol_cursor, sym);
+        if (!sym) break;
+        entry->sid = sym->sid;
+        entry->hash = sym->hash;
+        if (!entry->hash) {
+            // hash a copy, the table may be frozen and shared with other threads
+            key_sym = *sym;
+            entry->hash = (uint32_t)_ion_symbol_table_hash_fn(&key_sym, NULL);
+        }
+        if (ION_STRING_IS_NULL(&sym->value)) {
+            entry->text_offset = 0;
+            entry->text_length = ION_SYMBOL_TABLE_IMAGE_NO_TEXT;
+        }
+        else {
+            entry->text_offset = text_offset;
+            entry->text_length = sym->value.length;
+            memcpy(buffer + text_offset, sym->value.value, sym->value.length);
+            text_offset += sym->value.length;
+        }
+        entry++;
+    }
+    ION_COLLECTION_CLOSE(symbol_cursor);
+    ASSERT(text_offset == image_length);
+
+    iRETURN;
+}
+
+iERR ion_symbol_table_open_image(BYTE *image, SIZE image_length, hOWNER owner, hSYMTAB *p_hsymtab)
+{
+    iENTER;
+    ION_SYMBOL_TABLE *symtab;
+
+    if (image == NULL) FAILWITH(IERR_INVALID_ARG);
+    if (p_hsymtab == NULL) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(_ion_symbol_table_open_image_helper(&symtab, image, image_length, owner));
+
+    *p_hsymtab = PTR_TO_HANDLE(symtab);
+
+    iRETURN;
+}
+
+iERR _ion_symbol_table_open_image_helper(ION_SYMBOL_TABLE **p_psymtab, BYTE *image, SIZE image_length, hOWNER owner)
+{
+    iENTER;
+    ION_SYMBOL_TABLE_IMAGE_HEADER *header;
+    ION_SYMBOL_TABLE_IMAGE_ENTRY  *entries, *entry;
+    ION_SYMBOL_TABLE              *symtab = NULL, *system;
+    ION_COLLECTION_CURSOR          symbol_cursor;
+    ION_SYMBOL                    *sym;
+    BOOL                           use_hashes;
+
+    ASSERT(p_psymtab != NULL);
+    ASSERT(image != NULL);
+
+    if (((intptr_t)image) & (sizeof(uint32_t) - 1)) FAILWITH(IERR_INVALID_ARG);
+    if (image_length < (SIZE)sizeof(ION_SYMBOL_TABLE_IMAGE_HEADER)) FAILWITH(IERR_INVALID_SYMBOL_TABLE);
+
+    // everything in the image is checked against its bounds before it's used, but
+    // the text isn't validated as UTF-8: it was when the table was first built
+    header = (ION_SYMBOL_TABLE_IMAGE_HEADER *)image;
+    if (header->magic != ION_SYMBOL_TABLE_IMAGE_MAGIC
+     || header->format_version != ION_SYMBOL_TABLE_IMAGE_VERSION
+     || header->image_length != (uint32_t)image_length
+     || header->max_id < 0
+     || header->symbol_count > (uint32_t)header->max_id
+     || header->name_length < 1
+     || header->name_offset > (uint32_t)image_length
+     || header->name_length > (uint32_t)image_length - header->name_offset
+     || header->entries_offset > (uint32_t)image_length
+     || (header->entries_offset & (sizeof(uint32_t) - 1))
+     || header->symbol_count > ((uint32_t)image_length - header->entries_offset) / sizeof(ION_SYMBOL_TABLE_IMAGE_ENTRY)
+    ) {
+        FAILWITH(IERR_INVALID_SYMBOL_TABLE);
+    }
+    entries = (ION_SYMBOL_TABLE_IMAGE_ENTRY *)(image + header->entries_offset);
+    for (entry = entries; entry < entries + header->symbol_count; entry++) {
+        if (entry->sid < 1 || entry->sid > header->max_id) FAILWITH(IERR_INVALID_SYMBOL_TABLE);
+        if (entry->text_length == ION_SYMBOL_TABLE_IMAGE_NO_TEXT) continue;
+        if (entry->text_length < 0
+         || entry->text_offset > (uint32_t)image_length
+         || (uint32_t)entry->text_length > (uint32_t)image_length - entry->text_offset
+        ) {
+            FAILWITH(IERR_INVALID_SYMBOL_TABLE);
+        }
+    }
+    use_hashes = (header->hash_check == _ion_symbol_table_image_hash_check());
+
+    IONCHECK(_ion_symbol_table_get_system_symbol_helper(&system, ION_SYSTEM_VERSION));
+    IONCHECK(_ion_symbol_table_open_helper(&symtab, owner, NULL));
+    symtab->system_symbol_table = system;
+
+    // the strings point into the image rather than being copied
+    symtab->name.value  = image + header->name_offset;
+    symtab->name.length = (int32_t)header->name_length;
+    symtab->version     = header->version;
+    symtab->max_id      = header->max_id;
+
+    if (header->symbol_count > 0) {
+        if (!_ion_collection_append_block(&symtab->symbols, (int32_t)header->symbol_count)) FAILWITH(IERR_NO_MEMORY);
+        entry = entries;
+        ION_COLLECTION_OPEN(&symtab->symbols, symbol_cursor);
+        for (;;) {
+            ION_COLLECTION_NEXT(symbol_cursor, sym);
+            if (!sym) break;
+            sym->sid = entry->sid;
+            if (entry->text_length != ION_SYMBOL_TABLE_IMAGE_NO_TEXT) {
+                sym->value.value  = image + entry->text_offset;
+                sym->value.length = entry->text_length;
+            }
+            if (use_hashes) sym->hash = entry->hash; // so building the index never touches the text
+            entry++;
+        }
+        ION_COLLECTION_CLOSE(symbol_cursor);
+        symtab->has_local_symbols = TRUE;
+    }
+
+    IONCHECK(_ion_symbol_table_freeze_helper(symtab));
+
+    *p_psymtab = symtab;
+    symtab = NULL;
+
+fail:
+    if (symtab) {
+        _ion_symbol_table_close_helper(symtab);
+        *p_psymtab = NULL;
+    }
+    return err;
+}
+
 iERR ion_symbol_table_is_locked(hSYMTAB hsymtab, BOOL *p_is_locked)
 {
     iENTER;
@@ -1060,6 +1436,8 @@ iERR _ion_symbol_table_set_name_helper(ION_SYMBOL_TABLE *symtab, ION_STRING *nam
 
     if (symtab->is_locked) FAILWITH(IERR_IS_IMMUTABLE);
 
+    // lookups stamp the table's name onto its symbols, which must not reach the borrowed ones
+    IONCHECK(_ion_symbol_table_unshare_helper(symtab));
     IONCHECK(ion_string_copy_to_owner(symtab->owner, &symtab->name, name));    
 
     iRETURN;
@@ -1180,6 +1558,7 @@ iERR _ion_symbol_table_import_symbol_table_helper(ION_SYMBOL_TABLE *symtab, ION_
     iENTER;
     ION_SYMBOL_TABLE_IMPORT *import;
 
+    IONCHECK(_ion_symbol_table_unshare_helper(symtab));
     import = (ION_SYMBOL_TABLE_IMPORT *)_ion_collection_append(&symtab->import_list);
     if (!import) FAILWITH(IERR_NO_MEMORY);
 
@@ -1187,12 +1566,8 @@ iERR _ion_symbol_table_import_symbol_table_helper(ION_SYMBOL_TABLE *symtab, ION_
     import->descriptor.max_id = import_max_id;
     import->descriptor.version = import_version;
     IONCHECK(ion_string_copy_to_owner(symtab->owner, &import->descriptor.name, import_name));
-    if (import_symtab && symtab->owner != import_symtab->owner) {
-        IONCHECK(_ion_symbol_table_clone_with_owner_helper(&import->shared_symbol_table, import_symtab, symtab->owner,
-                                                           import_symtab->system_symbol_table));
-    }
-    else {
-        import->shared_symbol_table = import_symtab;
+    if (import_symtab) {
+        IONCHECK(_ion_symbol_table_adopt_import_helper(&import->shared_symbol_table, import_symtab, symtab->owner));
     }
 
     IONCHECK(_ion_symbol_table_local_incorporate_symbols(symtab, import_symtab, import_max_id));
@@ -1280,6 +1655,11 @@ iERR _ion_symbol_table_local_incorporate_symbols(ION_SYMBOL_TABLE *symtab, ION_S
     symtab->max_id += import_max_id;
     symtab->min_local_id = symtab->max_id + 1;
 
+    // The imported SID range just changed; any flattened view of it (or decision not to build one) is stale.
+    symtab->flat_by_sid = NULL;
+    symtab->flat_max_id = 0;
+    symtab->flat_declined = FALSE;
+
     iRETURN;
 }
 
@@ -1377,7 +1757,18 @@ iERR _ion_symbol_table_parse_possible_symbol_identifier(ION_SYMBOL_TABLE *symtab
             // SID 0 is not in any symbol table, but is available in all symbol table contexts.
             // If the requested SID is out of range for the current symtab context, an error will be raised when the
             // user retrieves the symbol token.
-            _ion_symbol_table_allocate_symbol_unknown_text(symtab->owner, sid, &sym);
+            if (symtab->is_frozen) {
+                // Frozen tables (such as the system table) are never allocated into. Callers copy this symbol
+                // before looking up another, so a per-thread one will do.
+                sym = &_Ion_unknown_text_symbol;
+                memset(sym, 0, sizeof(ION_SYMBOL));
+                sym->sid = sid;
+                sym->add_count = 1;
+                sym->import_location.location = UNKNOWN_SID;
+            }
+            else {
+                _ion_symbol_table_allocate_symbol_unknown_text(symtab->owner, sid, &sym);
+            }
         }
         else if (p_sym) {
             IONCHECK(_ion_symbol_table_find_symbol_by_sid_helper(symtab, sid, &sym));
@@ -1489,8 +1880,11 @@ iERR _ion_symbol_table_local_find_by_sid(ION_SYMBOL_TABLE *symtab, SID sid, ION_
         }
 
     }
-    if (sym && !ION_STRING_IS_NULL(&symtab->name)) {
-        // The symbol is found and this is a shared symbol table. Set the import location.
+    if (sym && !ION_STRING_IS_NULL(&symtab->name) && !symtab->is_frozen
+        && (sym->import_location.location != sid || sym->import_location.name.value != symtab->name.value)) {
+        // The symbol is found and this is a shared symbol table. Set the import location, unless it is already set,
+        // which keeps lookups through a clone from writing to the storage it borrows. (Frozen tables had theirs set
+        // when they were frozen.)
         ION_STRING_ASSIGN(&sym->import_location.name, &symtab->name);
         sym->import_location.location = sid;
     }
@@ -1523,55 +1917,161 @@ iERR _ion_symbol_table_find_symbol_by_sid_helper(ION_SYMBOL_TABLE *symtab, SID s
 {
     iENTER;
     ION_SYMBOL              *sym = NULL;
-    ION_SYMBOL_TABLE        *imported;
-    ION_SYMBOL_TABLE_IMPORT *imp;
-    ION_COLLECTION_CURSOR    import_cursor;
-    int32_t                  offset;
 
     ASSERT(symtab != NULL);
     ASSERT(sid > UNKNOWN_SID);
     ASSERT(p_sym);
 
+    if (ION_STRING_IS_NULL(&symtab->name) && sid < symtab->min_local_id
+        && !ION_COLLECTION_IS_EMPTY(&symtab->import_list)
+    ) {
+        // A system or imported SID of a local table. Resolve it with a single load from the flattened view, rather
+        // than walking the import list, whenever that view can be (or has been) built. Locked tables were flattened
+        // when they were locked, and may share the view with their clones, so lookups never write to it.
+        if (symtab->flat_by_sid == NULL && !symtab->flat_declined && !symtab->is_locked && !symtab->shares_storage) {
+            IONCHECK(_ion_symbol_table_flatten_imports_helper(symtab));
+        }
+        if (sid <= symtab->flat_max_id) {
+            *p_sym = symtab->flat_by_sid[sid];
+            SUCCEED();
+        }
+    }
+
+    IONCHECK(_ion_symbol_table_find_imported_symbol_by_sid(symtab, sid, &sym));
+    if (sym == NULL) {
+        IONCHECK(_ion_symbol_table_local_find_by_sid(symtab, sid, &sym));
+    }
+
+    *p_sym = sym;
+    iRETURN;
+}
+
+// Resolves SIDs that fall within the system symbols (local tables only) or the imports. Leaves *p_sym NULL if the SID
+// belongs to neither.
+static iERR _ion_symbol_table_find_imported_symbol_by_sid(ION_SYMBOL_TABLE *symtab, SID sid, ION_SYMBOL **p_sym)
+{
+    iENTER;
+    ION_SYMBOL              *sym = NULL;
+    ION_SYMBOL_TABLE        *imported;
+    ION_SYMBOL_TABLE_IMPORT *imp;
+    ION_COLLECTION_CURSOR    import_cursor;
+    int32_t                  offset;
+
     if (ION_STRING_IS_NULL(&symtab->name) && sid <= symtab->system_symbol_table->max_id) {
         // Only local symbol tables implicitly import the system symbol table. Shared symbol table SIDs start at 1.
         IONCHECK(_ion_symbol_table_local_find_by_sid(symtab->system_symbol_table, sid, &sym));
     }
-    else {
-        if (!ION_COLLECTION_IS_EMPTY(&symtab->import_list)) {
-            offset = symtab->system_symbol_table->max_id;
+    else if (!ION_COLLECTION_IS_EMPTY(&symtab->import_list)) {
+        offset = symtab->system_symbol_table->max_id;
 
-            ION_COLLECTION_OPEN(&symtab->import_list, import_cursor);
-            for (;;) {
-                ION_COLLECTION_NEXT(import_cursor, imp);
-                if (!imp) break;
-                if (sid - offset <= imp->descriptor.max_id) {
-                    imported = imp->shared_symbol_table;
-                    if (imported != NULL) {
-                        IONCHECK(_ion_symbol_table_local_find_by_sid(imported, sid - offset, &sym));
-                    }
-                    if (sym == NULL) {
-                        // The SID is in range, but either the shared symbol table is not found, or the SID refers to a
-                        // NULL slot in the shared symbol table. This symbol has unknown text.
-                        _ion_symbol_table_allocate_symbol_unknown_text(symtab->owner, sid, &sym);
-                        ION_STRING_ASSIGN(&sym->import_location.name, &imp->descriptor.name);
-                        sym->import_location.location = sid - offset;
-                    }
-                    ASSERT(sym);
-                    break;
+        ION_COLLECTION_OPEN(&symtab->import_list, import_cursor);
+        for (;;) {
+            ION_COLLECTION_NEXT(import_cursor, imp);
+            if (!imp) break;
+            if (sid - offset <= imp->descriptor.max_id) {
+                imported = imp->shared_symbol_table;
+                if (imported != NULL) {
+                    IONCHECK(_ion_symbol_table_local_find_by_sid(imported, sid - offset, &sym));
                 }
-                offset += imp->descriptor.max_id;
+                if (sym == NULL) {
+                    // The SID is in range, but either the shared symbol table is not found, or the SID refers to a
+                    // NULL slot in the shared symbol table. This symbol has unknown text.
+                    _ion_symbol_table_allocate_symbol_unknown_text(symtab->owner, sid, &sym);
+                    ION_STRING_ASSIGN(&sym->import_location.name, &imp->descriptor.name);
+                    sym->import_location.location = sid - offset;
+                }
+                ASSERT(sym);
+                break;
             }
-            ION_COLLECTION_CLOSE(import_cursor);
-        }
-        if (sym == NULL) {
-            IONCHECK(_ion_symbol_table_local_find_by_sid(symtab, sid, &sym));
+            offset += imp->descriptor.max_id;
         }
+        ION_COLLECTION_CLOSE(import_cursor);
     }
 
     *p_sym = sym;
     iRETURN;
 }
 
+iERR _ion_symbol_table_flatten_imports_helper(ION_SYMBOL_TABLE *symtab)
+{
+    iENTER;
+    ION_SYMBOL             **flat;
+    ION_SYMBOL_TABLE        *imported;
+    ION_SYMBOL_TABLE_IMPORT *imp;
+    ION_COLLECTION_CURSOR    import_cursor;
+    SID                      flat_max_id, offset, sid, limit, known;
+
+    ASSERT(symtab != NULL);
+
+    if (symtab->flat_by_sid != NULL || symtab->flat_declined) SUCCEED(); // it's been done (or ruled out) before
+    // Shared tables, and local tables that only import the system symbols, have no import list to walk.
+    if (!ION_STRING_IS_NULL(&symtab->name) || ION_COLLECTION_IS_EMPTY(&symtab->import_list)) SUCCEED();
+
+    flat_max_id = symtab->min_local_id - 1;
+    // Import max_ids are declared by the data, so the range may be arbitrarily large and sparse. Past the limit the
+    // import list is walked as before.
+    if (flat_max_id <= 0 || flat_max_id > DEFAULT_FLAT_SID_LIMIT) {
+        symtab->flat_declined = TRUE;
+        SUCCEED();
+    }
+
+    // The same goes for a range that is mostly unknown text, e.g. a large declared max_id over a small (or missing)
+    // shared table: the view is only built when at least half of its slots will hold a symbol.
+    known = symtab->system_symbol_table->max_id;
+    ION_COLLECTION_OPEN(&symtab->import_list, import_cursor);
+    for (;;) {
+        ION_COLLECTION_NEXT(import_cursor, imp);
+        if (!imp) break;
+        imported = imp->shared_symbol_table;
+        if (imported != NULL) {
+            known += (imported->max_id < imp->descriptor.max_id) ? imported->max_id : imp->descriptor.max_id;
+        }
+    }
+    ION_COLLECTION_CLOSE(import_cursor);
+    if (flat_max_id > 2 * known) {
+        symtab->flat_declined = TRUE;
+        SUCCEED();
+    }
+
+    flat = (ION_SYMBOL **)ion_alloc_with_owner(symtab->owner, (flat_max_id + 1) * sizeof(flat[0]));
+    if (flat == NULL) FAILWITH(IERR_NO_MEMORY);
+    memset(flat, 0, (flat_max_id + 1) * sizeof(flat[0]));
+
+    for (sid = 1; sid <= symtab->system_symbol_table->max_id; sid++) {
+        IONCHECK(_ion_symbol_table_local_find_by_sid(symtab->system_symbol_table, sid, &flat[sid]));
+    }
+
+    offset = symtab->system_symbol_table->max_id;
+    ION_COLLECTION_OPEN(&symtab->import_list, import_cursor);
+    for (;;) {
+        ION_COLLECTION_NEXT(import_cursor, imp);
+        if (!imp) break;
+        imported = imp->shared_symbol_table;
+        limit = 0;
+        if (imported != NULL) {
+            limit = (imported->max_id < imp->descriptor.max_id) ? imported->max_id : imp->descriptor.max_id;
+            for (sid = 1; sid <= limit; sid++) {
+                IONCHECK(_ion_symbol_table_local_find_by_sid(imported, sid, &flat[offset + sid]));
+            }
+        }
+        // SIDs past the shared table's own max_id (or in a missing shared table) and NULL slots within it have
+        // unknown text. Their symbols are materialized here, so that lookups never have to write to the view.
+        for (sid = 1; sid <= imp->descriptor.max_id; sid++) {
+            if (flat[offset + sid] != NULL) continue;
+            _ion_symbol_table_allocate_symbol_unknown_text(symtab->owner, offset + sid, &flat[offset + sid]);
+            ION_STRING_ASSIGN(&flat[offset + sid]->import_location.name, &imp->descriptor.name);
+            flat[offset + sid]->import_location.location = sid;
+        }
+        offset += imp->descriptor.max_id;
+    }
+    ION_COLLECTION_CLOSE(import_cursor);
+
+    symtab->flat_by_sid = flat;
+    symtab->flat_max_id = flat_max_id;
+
+    iRETURN;
+}
+
 iERR _ion_symbol_table_find_by_sid_helper(ION_SYMBOL_TABLE *symtab, SID sid, ION_STRING **p_name)
 {
     iENTER;
@@ -1610,6 +2110,11 @@ iERR _ion_symbol_table_get_unknown_symbol_name(ION_SYMBOL_TABLE *symtab, SID sid
         // This is a local symbol with unknown text, which is equivalent to symbol zero.
         sid = 0;
     }
+    if (sid == 0) {
+        // Needs no allocation, which matters for tables that must not be written to (e.g. the system table).
+        *p_name = &_Ion_symbol_zero_name;
+        SUCCEED();
+    }
     // A symbol name was not found, but the SID is within range for the current symbol table context -
     // make a symbol identifier of the form $<int> to represent the name
     temp[0] = '$';
@@ -1744,7 +2249,10 @@ iERR _ion_symbol_table_add_symbol_helper(ION_SYMBOL_TABLE *symtab, ION_STRING *n
         IONCHECK(_ion_symbol_table_local_add_symbol_helper(symtab, name, sid, &sym));
     }
 
-    if (sym) sym->add_count++;
+    if (sym && sym->sid >= symtab->min_local_id && !symtab->is_frozen && !symtab->shares_storage) {
+        // advisory only, so it is not kept for symbols in storage this table does not own (imported, borrowed or frozen)
+        sym->add_count++;
+    }
     if (p_sid) *p_sid = sid;
 
     iRETURN;
@@ -1760,6 +2268,7 @@ iERR _ion_symbol_table_local_add_symbol_helper(ION_SYMBOL_TABLE *symtab, ION_STR
     ASSERT(sid > UNKNOWN_SID);
     ASSERT(!symtab->is_locked);
 
+    IONCHECK(_ion_symbol_table_unshare_helper(symtab));
     sym = (ION_SYMBOL *)_ion_collection_append(&symtab->symbols);
     if (!sym) FAILWITH(IERR_NO_MEMORY);
     memset(sym, 0, sizeof(ION_SYMBOL));
@@ -1812,7 +2321,8 @@ iERR _ion_symbol_table_close_helper(ION_SYMBOL_TABLE *symtab)
 
     IONCHECK(ion_symbol_table_get_type(symtab, &table_type));
 
-    if (table_type == ist_SYSTEM) {
+    // the system table itself can't be closed, but a clone that owns itself can
+    if (table_type == ist_SYSTEM && symtab->owner != symtab) {
         FAILWITH(IERR_INVALID_ARG);
     }
 
@@ -1991,21 +2501,9 @@ BOOL _ion_symbol_needs_quotes(ION_STRING *p_str, BOOL symbol_identifiers_need_qu
     }
 
     // if the leading char was the start of one of our keywords
-    // and we never hit a special character we can use the length
-    // to check our
-    if (is_possible_keyword) {
-        switch (length) {
-            case 3: // nan
-                if (memcmp(start, "nan", 3) == 0) return TRUE;
-                break;
-            case 4: // true or null
-                if (memcmp(start, "true", 4) == 0) return TRUE;
-                if (memcmp(start, "null", 4) == 0) return TRUE;
-                break;
-            case 5: // false
-                if (memcmp(start, "false", 5) == 0) return TRUE;
-                break;
-        }
+    // and we never hit a special character it may be a keyword
+    if (is_possible_keyword && _ion_scanner_is_keyword(start, length)) {
+        return TRUE;
     }
 
     return FALSE;
@@ -2037,6 +2535,7 @@ iERR _ion_symbol_local_copy_same_owner(void *context, void *dst, void *src, int3
     ASSERT(src);
 
     symbol_dst->sid = symbol_src->sid;
+    symbol_dst->hash = symbol_src->hash; // same bytes, same hash
     ION_STRING_ASSIGN(&symbol_dst->value, &symbol_src->value);
     ION_STRING_ASSIGN(&symbol_dst->import_location.name, &symbol_src->import_location.name);
     symbol_dst->import_location.location = symbol_src->import_location.location;
@@ -2155,35 +2654,20 @@ int_fast8_t  _ion_symbol_table_compare_fn(void *key1, void *key2, void *context)
     return cmp;
 }
 
-// Disable the unexpected behavior sanitizer's shift, and signed int overflow checks since
-// we know _ion_symbol_table_hash_fn uses these behaviors.
-NOSAN_SHIFT NOSAN_SINT_OVERFLOW
 int_fast32_t _ion_symbol_table_hash_fn(void *key, void *context)
 {
     ION_SYMBOL  *sym = (ION_SYMBOL *)key;
-    int_fast32_t hash;
-    int len;
-    BYTE *cb;
-    
+    uint64_t     hash;
+
     ASSERT(sym);
-    
-#if 0
-    hash = hashfn_mem(sym->value.value, sym->value.length);
-    return hash;
-#else
-    hash = 0;
-    len = sym->value.length;
-    cb = sym->value.value;
-    
-    while (len)
-    {
-        hash = *cb + (hash << 6) + (hash << 16) - hash;
-        ++cb;
-        --len;
+
+    if (!sym->hash) {
+        // computed once per symbol; the index keeps its own copy, so growing the index never rehashes
+        hash = _ion_hash_bytes(sym->value.value, (sym->value.length > 0) ? sym->value.length : 0, ION_SYMBOL_HASH_SEED);
+        sym->hash = (uint32_t)(hash ^ (hash >> 32));
+        if (!sym->hash) sym->hash = 1; // 0 means "not computed"
     }
-    // the previous hash function was only returning 24 bits.
-    return hash & 0x00FFFFFF;
-#endif
+    return (int_fast32_t)sym->hash;
 }
 
 iERR _ion_symbol_table_index_insert_helper(ION_SYMBOL_TABLE *symtab, ION_SYMBOL *sym) 
@@ -2253,9 +2737,15 @@ ION_SYMBOL *_ion_symbol_table_index_find_by_name_helper(ION_SYMBOL_TABLE *symtab
     ASSERT(!ION_STRING_IS_NULL(str));
     ASSERT(INDEX_IS_ACTIVE(symtab));
 
+    if (symtab->by_id == _Ion_system_symbols_by_sid) {
+        // the system table, or a clone still borrowing its storage
+        return _ion_symbol_table_system_find_by_name(str);
+    }
+
     // dummy up a symbol with the right key
     key_sym.value.length = str->length;
     key_sym.value.value = str->value;
+    key_sym.hash = 0;
 
     found_sym = _ion_index_find(&symtab->by_name, &key_sym);
 
@@ -2271,6 +2761,7 @@ void _ion_symbol_table_allocate_symbol_unknown_text(hOWNER owner, SID sid, ION_S
     ION_STRING_INIT(&symbol->value); // NULLS the value.
     symbol->sid = sid;
     symbol->add_count++;
+    symbol->hash = 0;
     ION_STRING_INIT(&symbol->import_location.name); // NULLS the value.
     symbol->import_location.location = UNKNOWN_SID;
 
@@ -2306,6 +2797,7 @@ iERR ion_symbol_copy_to_owner(hOWNER owner, ION_SYMBOL *dst, ION_SYMBOL *src)
 
     dst->sid = src->sid;
     dst->add_count = 0;
+    dst->hash = 0; // src may not belong to a symbol table, so its hash isn't trusted
     IONCHECK(ion_string_copy_to_owner(owner, &dst->value, &src->value));
     IONCHECK(ion_string_copy_to_owner(owner, &dst->import_location.name, &src->import_location.name));
     dst->import_location.location = src->import_location.location;
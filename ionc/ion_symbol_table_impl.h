@@ -44,13 +44,24 @@ BOOL _ion_symbol_needs_quotes(ION_STRING *p_str, BOOL symbol_identifiers_need_qu
 // internal (pointer based helpers) functions for symbol tables (in ion_symbol_table.c)
 iERR _ion_symbol_table_open_helper(ION_SYMBOL_TABLE **p_psymtab, hOWNER owner, ION_SYMBOL_TABLE *psystem);
 iERR _ion_symbol_table_clone_with_owner_helper(ION_SYMBOL_TABLE **p_pclone, ION_SYMBOL_TABLE *orig, hOWNER owner, ION_SYMBOL_TABLE *system_symtab);
+iERR _ion_symbol_table_unshare_helper(ION_SYMBOL_TABLE *symtab);
 iERR _ion_symbol_table_clone_with_owner_and_system_table(hSYMTAB hsymtab, hSYMTAB *p_hclone, hOWNER owner, hSYMTAB hsystem);
 iERR _ion_symbol_table_get_system_symbol_helper(ION_SYMBOL_TABLE **pp_system_table, int32_t version);
 //iERR _ion_symbol_table_load_import_list_helper(ION_READER *preader, hOWNER owner, ION_SYMBOL_TABLE_IMPORT **p_head);
 iERR _ion_symbol_table_load_symbol_list_helper(ION_READER *preader, hOWNER owner, ION_SYMBOL **p_listhead);
 iERR _ion_symbol_table_load_helper(ION_READER *preader, hOWNER owner, ION_SYMBOL_TABLE *system_symtab, ION_SYMBOL_TABLE **p_psymtab);
+// As _ion_symbol_table_load_helper; also reports whether the table appends to the reader's current symbol table
+// (imports: $ion_symbol_table), i.e. whether its content depends on the context it was read in.
+iERR _ion_symbol_table_load_with_context_helper(ION_READER *preader, hOWNER owner, ION_SYMBOL_TABLE *system_symtab, ION_SYMBOL_TABLE **p_psymtab, BOOL *p_appends);
 iERR _ion_symbol_table_unload_helper(ION_SYMBOL_TABLE *symtab, ION_WRITER *pwriter);
 iERR _ion_symbol_table_lock_helper(ION_SYMBOL_TABLE *symtab);
+// Locks the table and makes all later lookups on it read-only, so it can be shared between threads.
+iERR _ion_symbol_table_freeze_helper(ION_SYMBOL_TABLE *symtab);
+// Sets *p_pimport to a copy of import_symtab that belongs to owner, or to import_symtab itself if it already belongs to
+// owner or is frozen.
+iERR _ion_symbol_table_adopt_import_helper(ION_SYMBOL_TABLE **p_pimport, ION_SYMBOL_TABLE *import_symtab, hOWNER owner);
+iERR _ion_symbol_table_write_image_helper(ION_SYMBOL_TABLE *symtab, BYTE *buffer, SIZE buffer_length, SIZE *p_image_length);
+iERR _ion_symbol_table_open_image_helper(ION_SYMBOL_TABLE **p_psymtab, BYTE *image, SIZE image_length, hOWNER owner);
 iERR _ion_symbol_table_is_locked_helper(ION_SYMBOL_TABLE *symtab, BOOL *p_is_locked);
 iERR _ion_symbol_table_get_type_helper(ION_SYMBOL_TABLE *symtab, ION_SYMBOL_TABLE_TYPE *p_type);
 iERR _ion_symbol_table_get_owner(hSYMTAB hsymtab, hOWNER *howner);
@@ -69,6 +80,8 @@ iERR _ion_symbol_table_parse_possible_symbol_identifier(ION_SYMBOL_TABLE *symtab
 iERR _ion_symbol_table_find_by_name_helper(ION_SYMBOL_TABLE *symtab, ION_STRING *name, SID *p_sid, ION_SYMBOL **p_sym, BOOL symbol_identifiers_as_sids);
 iERR _ion_symbol_table_find_by_sid_helper(ION_SYMBOL_TABLE *symtab, SID sid, ION_STRING **p_name);
 iERR _ion_symbol_table_find_symbol_by_sid_helper(ION_SYMBOL_TABLE *symtab, SID sid, ION_SYMBOL **p_sym);
+// Builds the contiguous SID -> symbol view of a local table's system and imported symbols (see find_symbol_by_sid).
+iERR _ion_symbol_table_flatten_imports_helper(ION_SYMBOL_TABLE *symtab);
 iERR _ion_symbol_table_get_unknown_symbol_name(ION_SYMBOL_TABLE *symtab, SID sid, ION_STRING **p_name);
 iERR _ion_symbol_table_find_by_sid_force(ION_SYMBOL_TABLE *symtab, SID sid, ION_STRING **p_name, BOOL *p_is_symbol_identifier);
 void _ion_symbol_table_allocate_symbol_unknown_text(hOWNER owner, SID sid, ION_SYMBOL **p_symbol);
@@ -79,9 +92,7 @@ iERR _ion_symbol_table_close_helper(ION_SYMBOL_TABLE *symtab);
 #define DEFAULT_SYMBOL_TABLE_SID_MULTIPLIER  2
 #define DEFAULT_INDEX_BUILD_THRESHOLD       15
 #define DEFAULT_SYMBOL_TABLE_SIZE           15
-
-// local function forward reference declarations
-iERR _ion_symbol_table_local_make_system_symbol_table_helper(int32_t version);
+#define DEFAULT_FLAT_SID_LIMIT         (1 << 20) // largest imported SID range that will be flattened
 
 // The text reader doesn't automatically provide SIDs for known symbols. This forces a by-name lookup to the system
 // symbol table in those cases.
@@ -102,6 +113,40 @@ iERR _ion_symbol_local_copy_new_owner(void *context, void *dst, void *src, int32
 iERR _ion_symbol_table_local_import_copy_new_owner(void *context, void *dst, void *src, int32_t data_size);
 iERR _ion_symbol_table_local_import_copy_same_owner(void *context, void *dst, void *src, int32_t data_size);
 
+// seeds the symbol text hash; every table must agree on it since symbols carry their hash between tables
+#ifndef ION_SYMBOL_HASH_SEED
+#define ION_SYMBOL_HASH_SEED 0
+#endif
+
+// The precompiled image of a shared symbol table (see ion_symbol_table_write_image): this header, an array of
+// symbol_count entries, then the text of the name and symbols. Every field is a native 32 bit integer and every
+// offset is from the start of the image, so images are only portable between machines of the same byte order.
+#define ION_SYMBOL_TABLE_IMAGE_MAGIC    0x49535431 /* "IST1" in big endian order */
+#define ION_SYMBOL_TABLE_IMAGE_VERSION  1
+#define ION_SYMBOL_TABLE_IMAGE_NO_TEXT  -1         /* the length of a symbol with unknown text */
+
+typedef struct _ion_symbol_table_image_header
+{
+    uint32_t magic;
+    uint32_t format_version;
+    uint32_t hash_check;     // the hash of "$ion_symbol_table" when written, the entry hashes are only used if ours matches
+    uint32_t image_length;
+    int32_t  version;
+    int32_t  max_id;
+    uint32_t name_offset;
+    uint32_t name_length;
+    uint32_t symbol_count;
+    uint32_t entries_offset;
+} ION_SYMBOL_TABLE_IMAGE_HEADER;
+
+typedef struct _ion_symbol_table_image_entry
+{
+    int32_t  sid;
+    uint32_t text_offset;
+    int32_t  text_length;    // ION_SYMBOL_TABLE_IMAGE_NO_TEXT if the symbol has no text
+    uint32_t hash;
+} ION_SYMBOL_TABLE_IMAGE_ENTRY;
+
 #define INDEX_IS_ACTIVE(symtab) ((symtab)->by_id_max > 0)
 iERR         _ion_symbol_table_initialize_indices_helper(ION_SYMBOL_TABLE *symtab);
 int_fast8_t  _ion_symbol_table_compare_fn               (void *key1, void *key2, void *context);
@@ -25,7 +25,7 @@
 iERR ion_writer_options_initialize_shared_imports(ION_WRITER_OPTIONS *options)
 {
     iENTER;
-    hOWNER owner = ion_alloc_owner(sizeof(int)); // Dummy allocation to create an owning pool for the collection.
+    hOWNER owner = ion_alloc_owner_with_allocator(sizeof(int), options->allocator); // Dummy allocation to create an owning pool for the collection.
     if (owner == NULL) FAILWITH(IERR_NO_MEMORY);
     _ion_collection_initialize(owner, &options->encoding_psymbol_table, sizeof(ION_SYMBOL_TABLE_IMPORT));
     iRETURN;
@@ -36,7 +36,6 @@ iERR ion_writer_options_add_shared_imports(ION_WRITER_OPTIONS *options, ION_COLL
     iENTER;
     ION_SYMBOL_TABLE_IMPORT *user_import, *option_import;
     ION_COLLECTION_CURSOR import_cursor;
-    hOWNER owner;
 
     ASSERT(options != NULL);
     ASSERT(imports != NULL);
@@ -60,12 +59,9 @@ iERR ion_writer_options_add_shared_imports(ION_WRITER_OPTIONS *options, ION_COLL
         }
         ASSERT(option_import->shared_symbol_table == user_import->shared_symbol_table);
         if (option_import->shared_symbol_table) {
-            IONCHECK(_ion_symbol_table_get_owner(option_import->shared_symbol_table, &owner));
-            if (owner != options->encoding_psymbol_table._owner) {
-                IONCHECK(ion_symbol_table_clone_with_owner(option_import->shared_symbol_table,
-                                                           &option_import->shared_symbol_table,
+            IONCHECK(_ion_symbol_table_adopt_import_helper(&option_import->shared_symbol_table,
+                                                           option_import->shared_symbol_table,
                                                            options->encoding_psymbol_table._owner));
-            }
         }
     }
     ION_COLLECTION_CLOSE(import_cursor);
@@ -78,7 +74,6 @@ iERR ion_writer_options_add_shared_imports_symbol_tables(ION_WRITER_OPTIONS *opt
     ION_SYMBOL_TABLE_IMPORT *import;
     int i;
     ION_STRING name;
-    hOWNER owner;
 
     for (i = 0; i < imports_count; i++) {
         if (imports[i] == NULL) FAILWITH(IERR_INVALID_ARG);
@@ -92,16 +87,9 @@ iERR ion_writer_options_add_shared_imports_symbol_tables(ION_WRITER_OPTIONS *opt
         memset(import, 0, sizeof(ION_SYMBOL_TABLE_IMPORT));
         IONCHECK(_ion_symbol_table_get_max_sid_helper(imports[i], &import->descriptor.max_id));
         IONCHECK(_ion_symbol_table_get_version_helper(imports[i], &import->descriptor.version));
-        IONCHECK(_ion_symbol_table_get_owner(imports[i], &owner));
         IONCHECK(ion_string_copy_to_owner(options->encoding_psymbol_table._owner, &import->descriptor.name, &name));
-        if (owner != options->encoding_psymbol_table._owner) {
-            IONCHECK(ion_symbol_table_clone_with_owner(imports[i],
-                                                       &import->shared_symbol_table,
+        IONCHECK(_ion_symbol_table_adopt_import_helper(&import->shared_symbol_table, imports[i],
                                                        options->encoding_psymbol_table._owner));
-        }
-        else {
-            import->shared_symbol_table = imports[i];
-        }
 
     }
     iRETURN;
@@ -150,7 +138,7 @@ iERR _ion_writer_open_buffer_helper(
     ASSERT(buffer);
     ASSERT(buf_length >= 0);
 
-    IONCHECK(ion_stream_open_buffer(buffer, buf_length, buf_length, FALSE, &stream));
+    IONCHECK(_ion_stream_open_buffer_helper(buffer, buf_length, buf_length, FALSE, (p_options) ? p_options->allocator : NULL, &stream));
     IONCHECK(_ion_writer_open_helper(&pwriter, stream, p_options));
     pwriter->writer_owns_stream = TRUE;
 
@@ -159,6 +147,10 @@ iERR _ion_writer_open_buffer_helper(
 //  iRETURN;
 
 fail:
+    if (!pwriter && stream) {
+        // the writer was never opened over the stream, so it won't close it
+        ion_stream_close(stream);
+    }
     IONCLOSEpWRITER(pwriter);
 
     *p_pwriter = pwriter;
@@ -174,7 +166,7 @@ iERR ion_writer_open_stream(hWRITER *p_hwriter
     ION_WRITER *pwriter = NULL;
     ION_STREAM *pstream = NULL;
     if (!p_hwriter) FAILWITH(IERR_INVALID_ARG);
-    IONCHECK(ion_stream_open_handler_out( fn_output_handler, handler_state, &pstream ));
+    IONCHECK(_ion_stream_open_handler_out_helper( fn_output_handler, handler_state, (p_options) ? p_options->allocator : NULL, &pstream ));
     IONCHECK(_ion_writer_open_helper(&pwriter, pstream, p_options));
     pwriter->writer_owns_stream = TRUE;
     *p_hwriter = PTR_TO_HANDLE(pwriter);
@@ -207,6 +199,7 @@ iERR _ion_writer_initialize_local_symbol_table(ION_WRITER *pwriter)
     ASSERT( pwriter->symbol_table == NULL || pwriter->symbol_table == system );
 
     IONCHECK(_ion_symbol_table_open_helper(&pwriter->symbol_table, pwriter->_temp_entity_pool, system));
+    pwriter->_symbol_context++;
 
     ION_COLLECTION_OPEN(&pwriter->_imported_symbol_tables, import_cursor);
     for (;;) {
@@ -232,8 +225,8 @@ iERR _ion_writer_initialize_imports(ION_WRITER *pwriter) {
         ION_COLLECTION_NEXT(import_cursor, import);
         if (!import) break;
         if (import->shared_symbol_table) {
-            IONCHECK(ion_symbol_table_clone_with_owner(import->shared_symbol_table, &import->shared_symbol_table,
-                                                       pwriter));
+            IONCHECK(_ion_symbol_table_adopt_import_helper(&import->shared_symbol_table, import->shared_symbol_table,
+                                                           pwriter));
         }
     }
     ION_COLLECTION_CLOSE(import_cursor);
@@ -247,7 +240,7 @@ iERR _ion_writer_open_helper(ION_WRITER **p_pwriter, ION_STREAM *stream, ION_WRI
     ION_WRITER         *pwriter = NULL;
     ION_OBJ_TYPE        writer_type;
 
-    pwriter = ion_alloc_owner(sizeof(ION_WRITER));
+    pwriter = ion_alloc_owner_with_allocator(sizeof(ION_WRITER), (p_options) ? p_options->allocator : NULL);
     if (!pwriter) FAILWITH(IERR_NO_MEMORY);
     *p_pwriter = pwriter;
 
@@ -263,6 +256,12 @@ iERR _ion_writer_open_helper(ION_WRITER **p_pwriter, ION_STREAM *stream, ION_WRI
         memset(&(pwriter->options), 0, sizeof(ION_WRITER_OPTIONS));
     }
     _ion_writer_initialize_option_defaults(&(pwriter->options));
+    if (pwriter->options.binary_reserved_length_size < 0
+     || pwriter->options.binary_reserved_length_size > ION_BINARY_MAX_RESERVED_LENGTH_SIZE
+     || pwriter->options.binary_spill_threshold < 0
+    ) {
+        FAILWITH(IERR_INVALID_ARG);
+    }
 
     // initialize decimal context
     if (pwriter->options.decimal_context == NULL) {
@@ -390,6 +389,68 @@ iERR _ion_writer_get_depth_helper(ION_WRITER *pwriter, SIZE *p_depth)
     iRETURN;
 }
 
+iERR ion_writer_get_local_symbol_stats(hWRITER hwriter, int64_t *p_symbols_added, int64_t *p_rotations)
+{
+    iENTER;
+    ION_WRITER *pwriter;
+
+    if (!hwriter) FAILWITH(IERR_BAD_HANDLE);
+    pwriter = HANDLE_TO_PTR(hwriter, ION_WRITER);
+
+    IONCHECK(_ion_writer_get_local_symbol_stats_helper(pwriter, p_symbols_added, p_rotations));
+
+    iRETURN;
+}
+
+iERR _ion_writer_get_local_symbol_stats_helper(ION_WRITER *pwriter, int64_t *p_symbols_added, int64_t *p_rotations)
+{
+    iENTER;
+
+    ASSERT(pwriter);
+
+    if (p_symbols_added) *p_symbols_added = pwriter->_local_symbols_added;
+    if (p_rotations) *p_rotations = pwriter->_local_symbol_rotations;
+    SUCCEED();
+
+    iRETURN;
+}
+
+iERR ion_writer_get_memory_stats(hWRITER hwriter, ION_MEMORY_STATS *p_stats)
+{
+    iENTER;
+    ION_WRITER *pwriter;
+
+    if (!hwriter) FAILWITH(IERR_BAD_HANDLE);
+    pwriter = HANDLE_TO_PTR(hwriter, ION_WRITER);
+    if (!p_stats) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(_ion_writer_get_memory_stats_helper(pwriter, p_stats));
+
+    iRETURN;
+}
+
+iERR _ion_writer_get_memory_stats_helper(ION_WRITER *pwriter, ION_MEMORY_STATS *p_stats)
+{
+    iENTER;
+
+    ASSERT(pwriter);
+    ASSERT(p_stats);
+
+    memset(p_stats, 0, sizeof(ION_MEMORY_STATS));
+    _ion_alloc_owner_add_stats(pwriter, p_stats);
+    _ion_alloc_owner_add_stats(pwriter->_temp_entity_pool, p_stats);
+    _ion_alloc_owner_add_stats(pwriter->_pending_temp_entity_pool, p_stats);
+    if (pwriter->writer_owns_stream) {
+        _ion_alloc_owner_add_stats(pwriter->output, p_stats);
+    }
+    if (pwriter->type == ion_type_binary_writer) {
+        _ion_alloc_owner_add_stats(pwriter->_typed_writer.binary._value_stream, p_stats);
+    }
+    SUCCEED();
+
+    iRETURN;
+}
+
 iERR ion_writer_set_temp_size(hWRITER hwriter, SIZE size_of_temp_space)
 {
     iENTER;
@@ -606,6 +667,7 @@ iERR _ion_writer_set_symbol_table_helper(ION_WRITER *pwriter, ION_SYMBOL_TABLE *
     }
 
     pwriter->symbol_table = psymtab;
+    pwriter->_symbol_context++;
 
     iRETURN;
 }
@@ -742,6 +804,8 @@ iERR _ion_writer_add_imported_tables_helper(ION_WRITER *pwriter, ION_COLLECTION
         IONCHECK(_ion_writer_add_imported_table_helper(pwriter, import, &require_finish));
     }
     ION_COLLECTION_CLOSE(import_cursor);
+    // the local symbols now follow the added imports
+    pwriter->_symbol_context++;
 
     iRETURN;
 }
@@ -1223,6 +1287,100 @@ iERR _ion_writer_add_annotation_symbol_helper(ION_WRITER *pwriter, ION_SYMBOL *a
     iRETURN;
 }
 
+iERR ion_writer_prepare_symbol(hWRITER hwriter, iSTRING name, ION_PREPARED_SYMBOL *p_symbol)
+{
+    iENTER;
+    ION_WRITER *pwriter;
+
+    if (!hwriter) FAILWITH(IERR_BAD_HANDLE);
+    pwriter = HANDLE_TO_PTR(hwriter, ION_WRITER);
+    if (!name || ION_STRING_IS_NULL(name) || name->length < 0) FAILWITH(IERR_INVALID_ARG);
+    if (!p_symbol) FAILWITH(IERR_INVALID_ARG);
+
+    // the SID is resolved on first use, so preparing never adds a symbol
+    ION_STRING_ASSIGN(&p_symbol->_text, name);
+    p_symbol->_sid = UNKNOWN_SID;
+    p_symbol->_writer = pwriter;
+    p_symbol->_context = pwriter->_symbol_context - 1;
+
+    iRETURN;
+}
+
+iERR _ion_writer_prepared_symbol_sid_helper(ION_WRITER *pwriter, ION_PREPARED_SYMBOL *symbol, SID *p_sid)
+{
+    iENTER;
+    SID sid;
+
+    ASSERT(pwriter);
+    ASSERT(symbol);
+    ASSERT(p_sid);
+
+    // a symbol table written by hand is intercepted by its text, and a top
+    // level annotation may be followed by a fresh symbol table context when
+    // the value starts, so those are written as text
+    if (pwriter->type != ion_type_binary_writer
+     || pwriter->_current_symtab_intercept_state != iWSIS_NONE
+     || (pwriter->depth == 0
+         && (pwriter->options.max_local_symbol_count > 0 || pwriter->options.max_local_symbol_bytes > 0))
+    ) {
+        *p_sid = UNKNOWN_SID;
+        SUCCEED();
+    }
+
+    if (symbol->_context != pwriter->_symbol_context) {
+        IONCHECK(_ion_writer_make_symbol_helper(pwriter, &symbol->_text, &sid));
+        symbol->_sid = sid;
+        // read after adding the symbol, which may have begun the context
+        symbol->_context = pwriter->_symbol_context;
+    }
+    *p_sid = symbol->_sid;
+
+    iRETURN;
+}
+
+iERR ion_writer_write_field_name_prepared(hWRITER hwriter, ION_PREPARED_SYMBOL *field_name)
+{
+    iENTER;
+    ION_WRITER *pwriter;
+    SID         sid;
+
+    if (!hwriter) FAILWITH(IERR_BAD_HANDLE);
+    pwriter = HANDLE_TO_PTR(hwriter, ION_WRITER);
+    if (!field_name || field_name->_writer != pwriter) FAILWITH(IERR_INVALID_ARG);
+    if (pwriter->_current_symtab_intercept_state == iWSIS_NONE && !pwriter->_in_struct) FAILWITH(IERR_INVALID_STATE);
+
+    IONCHECK(_ion_writer_prepared_symbol_sid_helper(pwriter, field_name, &sid));
+    if (sid <= UNKNOWN_SID) {
+        IONCHECK(ion_writer_write_field_name(hwriter, &field_name->_text));
+    }
+    else {
+        IONCHECK(_ion_writer_write_field_sid_helper(pwriter, sid));
+    }
+
+    iRETURN;
+}
+
+iERR ion_writer_add_annotation_prepared(hWRITER hwriter, ION_PREPARED_SYMBOL *annotation)
+{
+    iENTER;
+    ION_WRITER *pwriter;
+    SID         sid;
+
+    if (!hwriter) FAILWITH(IERR_BAD_HANDLE);
+    pwriter = HANDLE_TO_PTR(hwriter, ION_WRITER);
+    if (!annotation || annotation->_writer != pwriter) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(_ion_writer_prepared_symbol_sid_helper(pwriter, annotation, &sid));
+    if (sid <= UNKNOWN_SID) {
+        IONCHECK(ion_writer_add_annotation(hwriter, &annotation->_text));
+    }
+    else {
+        IONCHECK(_ion_writer_add_annotation_sid_helper(pwriter, sid));
+    }
+
+    iRETURN;
+}
+
 iERR ion_writer_write_annotations(hWRITER hwriter, iSTRING p_annotations, int32_t count)
 {
     iENTER;
@@ -2231,7 +2389,7 @@ iERR _ion_writer_transition_to_symtab_intercept_state(ION_WRITER *pwriter, ION_T
                     ASSERT(pwriter->_completed_symtab_intercept_states == 0);
                     pwriter->_current_symtab_intercept_state = iWSIS_IN_LST_STRUCT;
                     ASSERT(pwriter->_pending_symbol_table == NULL && pwriter->_pending_temp_entity_pool == NULL);
-                    pwriter->_pending_temp_entity_pool = ion_alloc_owner(sizeof(int)); // this is a fake allocation to hold the pool
+                    pwriter->_pending_temp_entity_pool = ion_alloc_owner_with_allocator(sizeof(int), pwriter->options.allocator); // this is a fake allocation to hold the pool
                     if (pwriter->_pending_temp_entity_pool == NULL) {
                         FAILWITH(IERR_NO_MEMORY);
                     }
@@ -2351,6 +2509,7 @@ iERR _ion_writer_symbol_table_append(ION_WRITER *pwriter)
 
     if (pwriter->symbol_table == NULL) {
         IONCHECK(ion_symbol_table_open(&pwriter->symbol_table, pwriter->_temp_entity_pool));
+        pwriter->_symbol_context++;
     }
     ASSERT(pwriter->symbol_table && pwriter->_pending_symbol_table);
     IONCHECK(_ion_symbol_table_get_symbols_helper(pwriter->_pending_symbol_table, &symbols));
@@ -2391,6 +2550,9 @@ iERR _ion_writer_transition_from_symtab_intercept_state(ION_WRITER *pwriter)
                     ASSERT(pwriter->_temp_entity_pool == NULL && pwriter->_pending_temp_entity_pool != NULL);
                     pwriter->_temp_entity_pool = pwriter->_pending_temp_entity_pool;
                     pwriter->symbol_table = pwriter->_pending_symbol_table;
+                    pwriter->_symbol_context++;
+                    pwriter->_local_symbol_count = 0;
+                    pwriter->_local_symbol_bytes = 0;
                 }
                 pwriter->_pending_temp_entity_pool = NULL;
                 pwriter->_pending_symbol_table = NULL;
@@ -2738,6 +2900,17 @@ iERR ion_writer_finish(hWRITER hwriter, SIZE *p_bytes_flushed)
     pwriter = HANDLE_TO_PTR(hwriter, ION_WRITER);
 
     IONCHECK(_ion_writer_flush_helper(pwriter, p_bytes_flushed));
+    IONCHECK(_ion_writer_end_symbol_context_helper(pwriter));
+
+    iRETURN;
+}
+
+iERR _ion_writer_end_symbol_context_helper(ION_WRITER *pwriter)
+{
+    iENTER;
+
+    ASSERT(pwriter);
+
     IONCHECK(_ion_writer_free_local_symbol_table(pwriter));
     IONCHECK(_ion_writer_reset_temp_pool(pwriter));
     switch (pwriter->type) {
@@ -2753,10 +2926,96 @@ iERR ion_writer_finish(hWRITER hwriter, SIZE *p_bytes_flushed)
     // needs to be reinitialized.
     IONCHECK(_ion_writer_initialize_local_symbol_table(pwriter));
     pwriter->_has_local_symbols = FALSE;
+    pwriter->_local_symbol_count = 0;
+    pwriter->_local_symbol_bytes = 0;
     pwriter->_needs_version_marker = TRUE;
     iRETURN;
 }
 
+iERR ion_writer_reset(hWRITER hwriter, ION_STREAM *stream, BOOL keep_symbol_table)
+{
+    iENTER;
+    ION_WRITER *pwriter;
+
+    if (!hwriter) FAILWITH(IERR_BAD_HANDLE);
+    pwriter = HANDLE_TO_PTR(hwriter, ION_WRITER);
+    if (!stream) FAILWITH(IERR_INVALID_ARG);
+
+    IONCHECK(_ion_writer_reset_helper(pwriter, stream, keep_symbol_table));
+
+    iRETURN;
+}
+
+iERR ion_writer_reset_buffer(hWRITER hwriter, BYTE *buffer, SIZE buf_length, BOOL keep_symbol_table)
+{
+    iENTER;
+    ION_WRITER *pwriter;
+    ION_STREAM *stream = NULL;
+
+    if (!hwriter) FAILWITH(IERR_BAD_HANDLE);
+    pwriter = HANDLE_TO_PTR(hwriter, ION_WRITER);
+    if (!buffer)        FAILWITH(IERR_INVALID_ARG);
+    if (buf_length < 0) FAILWITH(IERR_INVALID_ARG);
+
+    // a buffer stream the writer opened itself can simply be pointed at the new buffer
+    if (pwriter->writer_owns_stream && IS_FLAG_ON(pwriter->output->_flags, FLAG_IS_USER_BUFFER)) {
+        IONCHECK(_ion_writer_reset_helper(pwriter, pwriter->output, keep_symbol_table));
+        IONCHECK(_ion_stream_reset_buffer_helper(pwriter->output, buffer, buf_length, buf_length));
+        SUCCEED();
+    }
+
+    IONCHECK(_ion_stream_open_buffer_helper(buffer, buf_length, buf_length, FALSE, pwriter->options.allocator, &stream));
+    err = _ion_writer_reset_helper(pwriter, stream, keep_symbol_table);
+    if (err) {
+        ion_stream_close(stream);
+        FAILWITH(err);
+    }
+    pwriter->writer_owns_stream = TRUE;
+
+    iRETURN;
+}
+
+iERR _ion_writer_reset_helper(ION_WRITER *pwriter, ION_STREAM *stream, BOOL keep_symbol_table)
+{
+    iENTER;
+
+    ASSERT(pwriter);
+    ASSERT(stream);
+
+    // pending annotations would silently attach to the first value of the new output
+    if (pwriter->annotation_curr != 0) {
+        FAILWITHMSG(IERR_INVALID_STATE, "Cannot reset a writer while there are pending annotations.");
+    }
+
+    // everything written so far belongs to the old output; this fails below the top level
+    IONCHECK(_ion_writer_flush_helper(pwriter, NULL));
+
+    // field names can only be pending inside a struct, so any left at the top level (e.g. by the
+    // symbol table struct) are stale and mustn't reach the new output
+    IONCHECK(_ion_writer_clear_field_name_helper(pwriter));
+
+    if (stream != pwriter->output) {
+        if (pwriter->writer_owns_stream) {
+            IONCHECK(ion_stream_close(pwriter->output));
+        }
+        pwriter->output = stream;
+        pwriter->writer_owns_stream = FALSE;
+    }
+
+    if (!keep_symbol_table) {
+        IONCHECK(_ion_writer_end_symbol_context_helper(pwriter));
+        SUCCEED();
+    }
+
+    // The new output continues the old one's symbol table context: no Ion Version
+    // Marker, and the binary writer only appends the symbols added from here on.
+    if (pwriter->type == ion_type_text_writer) {
+        pwriter->_typed_writer.text._no_output = TRUE;
+    }
+
+    iRETURN;
+}
+
 iERR _ion_writer_flush_helper(ION_WRITER *pwriter, SIZE *p_bytes_flushed)
 {
     iENTER;
@@ -2890,6 +3149,43 @@ iERR _ion_writer_free_local_symbol_table( ION_WRITER *pwriter )
 
     // local symbol tables are owned by the _temp_entity_pool, which is freed upon flush and close.
     pwriter->symbol_table = NULL;
+    pwriter->_symbol_context++;
+
+    iRETURN;
+}
+
+iERR _ion_writer_rotate_local_symbol_table_helper(ION_WRITER *pwriter)
+{
+    iENTER;
+
+    ASSERT(pwriter);
+    ASSERT(pwriter->type == ion_type_binary_writer);
+
+    if (pwriter->depth != 0
+     || pwriter->_current_symtab_intercept_state != iWSIS_NONE
+     || pwriter->_pending_symbol_table != NULL
+    ) {
+        SUCCEED();
+    }
+    if (!((pwriter->options.max_local_symbol_count > 0
+           && pwriter->_local_symbol_count > pwriter->options.max_local_symbol_count)
+       || (pwriter->options.max_local_symbol_bytes > 0
+           && pwriter->_local_symbol_bytes > pwriter->options.max_local_symbol_bytes))
+    ) {
+        SUCCEED();
+    }
+
+    // Emit the completed values under the symbol table they were encoded with, then begin a fresh context. The next
+    // flush writes a non-append local symbol table, which replaces the old context without an Ion Version Marker.
+    // The pending annotations live in temp_buffer, not the temp pool, so they survive the reset.
+    IONCHECK(_ion_writer_binary_flush_to_output(pwriter));
+    IONCHECK(_ion_writer_free_local_symbol_table(pwriter));
+    IONCHECK(_ion_writer_reset_temp_pool(pwriter));
+    IONCHECK(_ion_writer_initialize_local_symbol_table(pwriter));
+    pwriter->_has_local_symbols = FALSE;
+    pwriter->_local_symbol_count = 0;
+    pwriter->_local_symbol_bytes = 0;
+    pwriter->_local_symbol_rotations++;
 
     iRETURN;
 }
@@ -2897,7 +3193,7 @@ iERR _ion_writer_free_local_symbol_table( ION_WRITER *pwriter )
 iERR _ion_writer_make_symbol_helper(ION_WRITER *pwriter, ION_STRING *pstr, SID *p_sid)
 {
     iENTER;
-    SID               sid = UNKNOWN_SID, max_id;
+    SID               sid = UNKNOWN_SID, max_id, prev_max_id;
     ION_SYMBOL_TABLE *psymtab, *system;
     BOOL              symtab_is_locked;
 
@@ -2920,7 +3216,13 @@ iERR _ion_writer_make_symbol_helper(ION_WRITER *pwriter, ION_STRING *pstr, SID *
     }
 
     // we'll remember what the top symbol is to see if add_symbol changes it
+    IONCHECK(_ion_symbol_table_get_max_sid_helper(psymtab, &prev_max_id));
     IONCHECK( _ion_symbol_table_add_symbol_helper( psymtab, pstr, &sid));
+    if (sid > prev_max_id) {
+        pwriter->_local_symbol_count++;
+        pwriter->_local_symbol_bytes += pstr->length;
+        pwriter->_local_symbols_added++;
+    }
 
     // see if this symbol ended up changing the symbol list (if it already
     // was present the max_id doesn't change and we don't reuse
@@ -3267,7 +3569,7 @@ iERR _ion_writer_allocate_temp_pool( ION_WRITER *pwriter )
     iENTER;
     void *temp_owner;
 
-    temp_owner = ion_alloc_owner(sizeof(int)); // this is a fake allocation to hold the pool
+    temp_owner = ion_alloc_owner_with_allocator(sizeof(int), pwriter->options.allocator); // this is a fake allocation to hold the pool
     if (temp_owner == NULL) {
         FAILWITH(IERR_NO_MEMORY);
     }
@@ -81,6 +81,7 @@ iERR _ion_writer_binary_initialize(ION_WRITER *pwriter)
     pwriter->_has_local_symbols      = FALSE;
     pwriter->_needs_version_marker   = TRUE;
     bwriter->_lob_in_progress        = tid_none;
+    bwriter->_spill_file             = NULL;
 
     _ion_collection_initialize(pwriter, &bwriter->_patch_stack, sizeof(ION_BINARY_PATCH *));
     _ion_collection_initialize(pwriter, &bwriter->_patch_list,  sizeof(ION_BINARY_PATCH));
@@ -92,7 +93,7 @@ iERR _ion_writer_binary_initialize(ION_WRITER *pwriter)
     //IONCHECK( ion_output_stream_initialize_with_handler( bwriter->_value_stream, 
     //    _ion_writer_binary_output_stream_handler, pwriter ));
 
-    IONCHECK(ion_stream_open_memory_only( &bwriter->_value_stream ));
+    IONCHECK(_ion_stream_open_memory_only_helper( pwriter->options.allocator, &bwriter->_value_stream ));
 
     iRETURN;
 }
@@ -107,23 +108,117 @@ iERR _ion_writer_binary_push_position(ION_WRITER *pwriter, int type_id)
     // first we create a new patch at the end of the patch list
     patch = (ION_BINARY_PATCH *)_ion_collection_append(&bwriter->_patch_list);
     patch->_length = 0;
-    patch->_offset = (int)ion_stream_get_position(bwriter->_value_stream);   // TODO - this needs 64bit care
+    patch->_offset = ion_stream_get_position(bwriter->_value_stream);
     patch->_type   = type_id;
     
     // then we push a pointer to the patch onto our active stack
     ppatch = (ION_BINARY_PATCH **)_ion_collection_push(&bwriter->_patch_stack);
     *ppatch = patch;
+
+    // with reserved lengths the header goes in place now, and the patch only
+    // remembers where it is until the value ends
+    if (pwriter->options.binary_reserved_length_size > 0) {
+        ION_PUT(bwriter->_value_stream, makeTypeDescriptor(type_id, ION_lnIsVarLen));
+        IONCHECK(_ion_writer_binary_write_reserved_length(bwriter->_value_stream, 0, pwriter->options.binary_reserved_length_size));
+    }
     SUCCEED();
 
     iRETURN;
 }
 
+iERR _ion_writer_binary_write_reserved_length(ION_STREAM *ostream, int length, int size)
+{
+    iENTER;
+    BYTE  image[ION_BINARY_MAX_RESERVED_LENGTH_SIZE];
+    SIZE  written;
+    int   ii;
+
+    ASSERT(size > 0 && size <= ION_BINARY_MAX_RESERVED_LENGTH_SIZE);
+    ASSERT(ion_binary_len_var_uint_64(length) <= size);
+
+    // a VarUInt padded with leading zero bits out to size bytes
+    for (ii = size - 1; ii >= 0; ii--) {
+        image[ii] = (BYTE)(length & 0x7F);
+        length >>= 7;
+    }
+    image[size - 1] |= 0x80;
+
+    IONCHECK(ion_stream_write(ostream, image, size, &written));
+    if (written != size) FAILWITH(IERR_WRITE_ERROR);
+
+    iRETURN;
+}
+
+iERR _ion_writer_binary_fill_reserved_length(ION_WRITER *pwriter, ION_BINARY_PATCH *patch)
+{
+    iENTER;
+    ION_STREAM *ostream = pwriter->_typed_writer.binary._value_stream;
+    int         size = pwriter->options.binary_reserved_length_size;
+    POSITION    slot, finish;
+    int64_t     length;
+
+    finish = ion_stream_get_position(ostream);
+    slot   = patch->_offset + ION_BINARY_TYPE_DESC_LENGTH;
+    length = finish - slot - size;
+
+    if (ion_binary_len_var_uint_64(length) > size) {
+        IONCHECK(_ion_writer_binary_widen_reserved_length(pwriter, slot, length));
+        SUCCEED();
+    }
+
+    IONCHECK(ion_stream_seek(ostream, slot));
+    IONCHECK(_ion_writer_binary_write_reserved_length(ostream, (int)length, size));
+    IONCHECK(ion_stream_seek(ostream, finish));
+
+    iRETURN;
+}
+
+iERR _ion_writer_binary_widen_reserved_length(ION_WRITER *pwriter, POSITION slot, int64_t length)
+{
+    iENTER;
+    ION_STREAM *ostream = pwriter->_typed_writer.binary._value_stream;
+    int         size = pwriter->options.binary_reserved_length_size;
+    int         shift = ion_binary_len_var_uint_64(length) - size;
+    BYTE        chunk[VAR_UINT_64_IMAGE_LENGTH + ION_BINARY_WIDEN_CHUNK_SIZE];
+    POSITION    pos = slot + size, end = pos + length;
+    SIZE        len, moved;
+
+    // the contents have to move up shift bytes to make room for the longer
+    // length. They go front to back a chunk at a time, each one written back
+    // behind the shift bytes carried over from the one before, so the memory
+    // needed doesn't depend on the size of the value, and a spill file's
+    // stream only ever moves forward, releasing the pages it has passed
+    IONCHECK(ion_stream_seek(ostream, pos));
+    IONCHECK(ion_stream_read(ostream, chunk, shift, &moved));
+    if (moved != shift) FAILWITH(IERR_READ_ERROR);
+    pos += shift;
+
+    while (pos < end) {
+        len = (end - pos < ION_BINARY_WIDEN_CHUNK_SIZE) ? (SIZE)(end - pos) : ION_BINARY_WIDEN_CHUNK_SIZE;
+        IONCHECK(ion_stream_read(ostream, chunk + shift, len, &moved));
+        if (moved != len) FAILWITH(IERR_READ_ERROR);
+        IONCHECK(ion_stream_seek(ostream, pos));
+        IONCHECK(ion_stream_write(ostream, chunk, len, &moved));
+        if (moved != len) FAILWITH(IERR_WRITE_ERROR);
+        memmove(chunk, chunk + len, shift);
+        pos += len;
+    }
+    IONCHECK(ion_stream_write(ostream, chunk, shift, &moved));
+    if (moved != shift) FAILWITH(IERR_WRITE_ERROR);
+
+    IONCHECK(ion_stream_seek(ostream, slot));
+    IONCHECK(ion_binary_write_var_uint_64(ostream, length));
+    IONCHECK(ion_stream_seek(ostream, end + shift));
+
+    iRETURN;
+}
+
 iERR _ion_writer_binary_pop(ION_WRITER *pwriter) 
 {
     iENTER;
     ION_BINARY_WRITER *bwriter = &pwriter->_typed_writer.binary;
     ION_BINARY_PATCH **ppatch;
-    int patch_down;
+    int64_t patch_down;
 
     // pop the top of the patch stack.  We need to patch the length
     // of the length onto the remainer of the stack.  So we do that
@@ -134,6 +229,16 @@ iERR _ion_writer_binary_pop(ION_WRITER *pwriter)
 
     ppatch = (ION_BINARY_PATCH **)_ion_collection_head( &bwriter->_patch_stack);
 
+    if (pwriter->options.binary_reserved_length_size > 0) {
+        // the header is already in the value stream, it only needs its length,
+        // and the parent will measure its own length from the stream too
+        IONCHECK(_ion_writer_binary_fill_reserved_length(pwriter, *ppatch));
+        ASSERT(*ppatch == _ion_collection_tail(&bwriter->_patch_list));
+        _ion_collection_pop_head(&bwriter->_patch_stack);
+        _ion_collection_pop_tail(&bwriter->_patch_list);
+        SUCCEED();
+    }
+
     patch_down = (*ppatch)->_length;
     if (patch_down >= ION_lnIsVarLen) {
         patch_down += ion_binary_len_var_uint_64( patch_down );
@@ -151,7 +256,7 @@ iERR _ion_writer_binary_pop(ION_WRITER *pwriter)
     iRETURN;
 }
 
-iERR _ion_writer_binary_patch_lengths(ION_WRITER *pwriter, int added_length)
+iERR _ion_writer_binary_patch_lengths(ION_WRITER *pwriter, int64_t added_length)
 {
     iENTER;
     ION_BINARY_WRITER *bwriter = &pwriter->_typed_writer.binary;
@@ -184,7 +289,7 @@ iERR _ion_writer_binary_patch_lengths(ION_WRITER *pwriter, int added_length)
     iRETURN;
 }
 
-iERR _ion_writer_binary_top_length(ION_WRITER *pwriter, int *plength) 
+iERR _ion_writer_binary_top_length(ION_WRITER *pwriter, int64_t *plength) 
 {
     iENTER;
     ION_BINARY_WRITER *bwriter = &pwriter->_typed_writer.binary;
@@ -195,7 +300,7 @@ iERR _ion_writer_binary_top_length(ION_WRITER *pwriter, int *plength)
     iRETURN;
 }
 
-iERR _ion_writer_binary_top_position(ION_WRITER *pwriter, int *poffset) 
+iERR _ion_writer_binary_top_position(ION_WRITER *pwriter, POSITION *poffset) 
 {
     iENTER;
     ION_BINARY_WRITER *bwriter = &pwriter->_typed_writer.binary;
@@ -206,12 +311,35 @@ iERR _ion_writer_binary_top_position(ION_WRITER *pwriter, int *poffset)
     iRETURN;
 }
 
+iERR _ion_writer_binary_rotate_at_top_level(ION_WRITER *pwriter)
+{
+    iENTER;
+
+    // a fresh local symbol table context may only begin between top-level values
+    if (ION_COLLECTION_IS_EMPTY(&pwriter->_typed_writer.binary._patch_stack)) {
+        IONCHECK(_ion_writer_rotate_local_symbol_table_helper(pwriter));
+    }
+
+    iRETURN;
+}
+
 iERR _ion_writer_binary_start_value(ION_WRITER *pwriter, int value_length)
+{
+    iENTER;
+
+    IONCHECK(_ion_writer_binary_rotate_at_top_level(pwriter));
+    IONCHECK(_ion_writer_binary_start_value_helper(pwriter, value_length));
+
+    iRETURN;
+}
+
+iERR _ion_writer_binary_start_value_helper(ION_WRITER *pwriter, int value_length)
 {
     iENTER;
     ION_BINARY_WRITER  *bwriter = &pwriter->_typed_writer.binary;
-    ION_STREAM         *ostream = bwriter->_value_stream;
-    int                 start, finish, patch_len;
+    ION_STREAM         *ostream;
+    POSITION            start, finish;
+    int                 patch_len;
     int                 sid_count, ii, annotations_len = 0;
     int                 annotation_len_o_len, total_ann_value_len;
     SID                 sid;
@@ -223,9 +351,18 @@ iERR _ion_writer_binary_start_value(ION_WRITER *pwriter, int value_length)
         FAILWITH(IERR_INVALID_STATE);
     }
 
+    // every value, symbols included, starts here, so this is where the
+    // buffered values move to the spill file once there are enough of them
+    if (pwriter->options.binary_spill_threshold > 0 && bwriter->_spill_file == NULL
+     && ion_stream_get_position(bwriter->_value_stream) >= pwriter->options.binary_spill_threshold
+    ) {
+        IONCHECK(_ion_writer_binary_spill_values(pwriter));
+    }
+    ostream = bwriter->_value_stream;
+
     // remember where we start (so later we can look at where we
     // ended up in the output stream and calc the bytes written
-    start = (int)ion_stream_get_position(ostream);  // TODO - this needs 64bit care
+    start = ion_stream_get_position(ostream);
         
     // write field name
     if (pwriter->_in_struct) {
@@ -254,8 +391,8 @@ iERR _ion_writer_binary_start_value(ION_WRITER *pwriter, int value_length)
             // if we don't know the value length we push a patch point 
             // onto the backpatch stack - but first we patch our parent 
             // with the fieldid len and the annotation type desc byte
-            finish = (int)ion_stream_get_position(ostream);  // TODO - this needs 64bit care
-            patch_len = finish - start + ION_BINARY_TYPE_DESC_LENGTH;  // for the uta type desc byte we'll write in when we fill this out on outpu
+            finish = ion_stream_get_position(ostream);
+            patch_len = (int)(finish - start) + ION_BINARY_TYPE_DESC_LENGTH;  // for the uta type desc byte we'll write in when we fill this out on outpu
             IONCHECK(_ion_writer_binary_patch_lengths( pwriter, patch_len ));
             start = finish; // we reset the patch lengths as we've accounted for the writting up until this point
             IONCHECK(_ion_writer_binary_push_position( pwriter, TID_UTA ));
@@ -290,8 +427,8 @@ iERR _ion_writer_binary_start_value(ION_WRITER *pwriter, int value_length)
 
     // now see how much was actually written to the output stream and, 
     // if anything was, we need to update the patch amount by that amount
-    finish = (int)ion_stream_get_position(ostream);  // TODO - this needs 64bit care
-    patch_len = finish - start;
+    finish = ion_stream_get_position(ostream);
+    patch_len = (int)(finish - start);
     if (patch_len > 0) {
         IONCHECK(_ion_writer_binary_patch_lengths( pwriter, patch_len ));
     }
@@ -1086,6 +1223,16 @@ iERR _ion_writer_binary_write_string(ION_WRITER *pwriter, ION_STRING *pstr )
 }
 
 iERR _ion_writer_binary_write_symbol_id(ION_WRITER *pwriter, SID sid)
+{
+    iENTER;
+
+    IONCHECK(_ion_writer_binary_rotate_at_top_level(pwriter));
+    IONCHECK(_ion_writer_binary_write_symbol_id_helper(pwriter, sid));
+
+    iRETURN;
+}
+
+iERR _ion_writer_binary_write_symbol_id_helper(ION_WRITER *pwriter, SID sid)
 {
     iENTER;
     ION_SYMBOL_TABLE *system;
@@ -1098,7 +1245,7 @@ iERR _ion_writer_binary_write_symbol_id(ION_WRITER *pwriter, SID sid)
     ASSERT( len < ION_lnIsVarLen );
 
     // Write symbol type descriptor and int value out and patch lens.
-    IONCHECK( _ion_writer_binary_start_value( pwriter, ION_BINARY_TYPE_DESC_LENGTH + len ));
+    IONCHECK( _ion_writer_binary_start_value_helper( pwriter, ION_BINARY_TYPE_DESC_LENGTH + len ));
     ION_PUT( pwriter->_typed_writer.binary._value_stream, makeTypeDescriptor(TID_SYMBOL, len));
     if (sid > 0) {
         IONCHECK(ion_binary_write_uint_64(pwriter->_typed_writer.binary._value_stream, sid));
@@ -1126,10 +1273,12 @@ iERR _ion_writer_binary_write_symbol(ION_WRITER *pwriter, ION_STRING *pstr )
         SUCCEED();
     }
 
+    // any rotation must happen before the symbol is added, or the sid would belong to the discarded table
+    IONCHECK( _ion_writer_binary_rotate_at_top_level(pwriter));
     IONCHECK( _ion_writer_make_symbol_helper(pwriter, pstr, &sid ));
     ASSERT(sid != UNKNOWN_SID);
 
-    IONCHECK( _ion_writer_binary_write_symbol_id(pwriter, sid));
+    IONCHECK( _ion_writer_binary_write_symbol_id_helper(pwriter, sid));
 
     iRETURN;
 }
@@ -1239,7 +1388,12 @@ iERR _ion_writer_binary_close(ION_WRITER *pwriter, BOOL flush)
         UPDATEERROR(ion_stream_flush(pwriter->output));
     }
 
-    UPDATEERROR(ion_stream_close(bwriter->_value_stream));
+    if (bwriter->_spill_file) {
+        UPDATEERROR(_ion_writer_binary_release_spill_file(pwriter));
+    }
+    else {
+        UPDATEERROR(ion_stream_close(bwriter->_value_stream));
+    }
 
     iRETURN;
 }
@@ -1248,14 +1402,14 @@ iERR _ion_writer_binary_flush_to_output(ION_WRITER *pwriter)
 {
     iENTER;
  
-    int                pos, buffer_length;
-    int                patch_pos;
+    POSITION           pos, buffer_length;
+    POSITION           patch_pos;
     int                len;
     SIZE               written;
 
     ION_BINARY_PATCH  *ppatch;
     ION_STREAM        *out = pwriter->output;
-    ION_STREAM        *values_in;
+    ION_STREAM        *values_in, *memory_stream = NULL;
     ION_BINARY_WRITER *bwriter = &pwriter->_typed_writer.binary;
 
     if (pwriter->_needs_version_marker) {
@@ -1282,7 +1436,7 @@ iERR _ion_writer_binary_flush_to_output(ION_WRITER *pwriter)
 
     // 
     values_in = bwriter->_value_stream;
-    buffer_length = (int)ion_stream_get_position( values_in );  // TODO - this needs 64bit care
+    buffer_length = ion_stream_get_position( values_in );
 
     // rewind the value stream we have been writing into
     IONCHECK(ion_stream_seek(values_in, 0));
@@ -1307,10 +1461,8 @@ iERR _ion_writer_binary_flush_to_output(ION_WRITER *pwriter)
         // data values (not a patch). write_stream won't write more than the
         // input stream holds so when patch_pos is past the end it simply writes
         // everything that's left
-        len = patch_pos - pos;
-        IONCHECK( ion_stream_write_stream( out, values_in, len, &written ) );
-        if (written != len) FAILWITH(IERR_WRITE_ERROR);
-        pos += len;
+        IONCHECK( _ion_writer_binary_copy_values( out, values_in, patch_pos - pos ));
+        pos = patch_pos;
     }
 
     while (ppatch) {
@@ -1323,9 +1475,86 @@ iERR _ion_writer_binary_flush_to_output(ION_WRITER *pwriter)
     _ion_collection_reset( &bwriter->_patch_list );
     _ion_collection_reset( &bwriter->_value_list );
 
-    // and finally re-initialize the value stream to reset it
-    IONCHECK( ion_stream_seek( values_in, 0 ));
-    IONCHECK( ion_stream_truncate( values_in ));
+    // and finally re-initialize the value stream to reset it, values that
+    // were spilled go back to memory until the threshold is reached again
+    if (bwriter->_spill_file) {
+        // the memory stream is opened first, so if that fails the writer keeps
+        // the spill file rather than being left without a value stream
+        IONCHECK( _ion_stream_open_memory_only_helper( pwriter->options.allocator, &memory_stream ));
+        err = _ion_writer_binary_release_spill_file( pwriter );
+        bwriter->_value_stream = memory_stream;
+        IONCHECK( err );
+    }
+    else {
+        IONCHECK( ion_stream_seek( values_in, 0 ));
+        IONCHECK( ion_stream_truncate( values_in ));
+    }
+
+    iRETURN;
+}
+
+iERR _ion_writer_binary_spill_values(ION_WRITER *pwriter)
+{
+    iENTER;
+    ION_BINARY_WRITER *bwriter = &pwriter->_typed_writer.binary;
+    ION_STREAM        *spill = NULL;
+    POSITION           length = ion_stream_get_position(bwriter->_value_stream);
+
+    ASSERT(bwriter->_spill_file == NULL);
+
+    bwriter->_spill_file = tmpfile();
+    if (!bwriter->_spill_file) FAILWITHMSG(IERR_WRITE_ERROR, "Unable to create a temporary file for spilled values.");
+    IONCHECK(_ion_stream_open_file_rw_helper(bwriter->_spill_file, pwriter->options.allocator, &spill));
+
+    // the values keep their positions, so the patches are still good
+    IONCHECK(ion_stream_seek(bwriter->_value_stream, 0));
+    IONCHECK(_ion_writer_binary_copy_values(spill, bwriter->_value_stream, length));
+
+    IONCHECK(ion_stream_close(bwriter->_value_stream));
+    bwriter->_value_stream = spill;
+    spill = NULL;
+
+fail:
+    if (spill) {
+        ion_stream_close(spill);
+    }
+    if (err && bwriter->_spill_file) {
+        fclose(bwriter->_spill_file);
+        bwriter->_spill_file = NULL;
+    }
+    return err;
+}
+
+iERR _ion_writer_binary_release_spill_file(ION_WRITER *pwriter)
+{
+    iERR               err = IERR_OK;
+    ION_BINARY_WRITER *bwriter = &pwriter->_typed_writer.binary;
+
+    ASSERT(bwriter->_spill_file != NULL);
+
+    // the stream is closed first, it may still write its dirty bytes to the file
+    UPDATEERROR(ion_stream_close(bwriter->_value_stream));
+    bwriter->_value_stream = NULL;
+    if (fclose(bwriter->_spill_file) && err == IERR_OK) {
+        err = IERR_WRITE_ERROR;
+    }
+    bwriter->_spill_file = NULL;
+
+    return err;
+}
+
+iERR _ion_writer_binary_copy_values(ION_STREAM *out, ION_STREAM *values_in, POSITION length)
+{
+    iENTER;
+    SIZE len, written;
+
+    // a single stream copy is limited to a SIZE, the buffered values aren't
+    while (length > 0) {
+        len = (length < ION_BINARY_COPY_CHUNK_SIZE) ? (SIZE)length : ION_BINARY_COPY_CHUNK_SIZE;
+        IONCHECK(ion_stream_write_stream(out, values_in, len, &written));
+        if (written != len) FAILWITH(IERR_WRITE_ERROR);
+        length -= len;
+    }
 
     iRETURN;
 }
@@ -108,12 +108,16 @@ typedef struct _ion_text_writer
 } ION_TEXT_WRITER;
 
 typedef struct _ion_binary_patch {
-    int     _offset;
-    int     _type;
-    int     _length;
-    BOOL    _in_struct;
+    POSITION _offset;
+    int      _type;
+    int64_t  _length;
+    BOOL     _in_struct;
 } ION_BINARY_PATCH;
 
+#define ION_BINARY_MAX_RESERVED_LENGTH_SIZE 4       // bytes in a padded VarUInt length, see binary_reserved_length_size
+#define ION_BINARY_WIDEN_CHUNK_SIZE         8192    // bytes moved at a time when a reserved length is widened
+#define ION_BINARY_COPY_CHUNK_SIZE          (1 << 30) // bytes copied between streams in one call, which takes a SIZE
+
 typedef struct _ion_binary_writer
 {
     ION_TYPE            _lob_in_progress;
@@ -123,6 +127,7 @@ typedef struct _ion_binary_writer
     ION_COLLECTION      _value_list;   // list of pointers to value buffers of some size (like 8k)
 
     ION_STREAM         *_value_stream; // temporary in memory buffer for holding values to merge with the patch list
+    FILE               *_spill_file;   // temporary file the values moved to past binary_spill_threshold, until flushed
 
 } ION_BINARY_WRITER;
 
@@ -137,6 +142,11 @@ typedef struct _ion_writer
     ION_SYMBOL_TABLE  *symbol_table;        // if there are local symbols defined this will be a seperately allocated table, and should be freed as we close the top level value
     ION_SYMBOL_TABLE  *_pending_symbol_table;// The in-progress manually-written LST, if applicable. Becomes `symbol_table` when the LST struct is finished.
     BOOL               _has_local_symbols;
+    SIZE               _local_symbol_count;     // local symbols added to the current symbol table context
+    SIZE               _local_symbol_bytes;     // bytes of text of those symbols
+    int64_t            _local_symbols_added;    // local symbols added over the writer's lifetime
+    int64_t            _local_symbol_rotations; // fresh symbol table contexts started because a limit was exceeded
+    int64_t            _symbol_context;         // changes whenever symbol_table does, so prepared symbol SIDs can be checked
 
     ION_WRITER_SYMTAB_INTERCEPT_STATE   _current_symtab_intercept_state;
     uint16_t                            _completed_symtab_intercept_states;
@@ -210,6 +220,10 @@ void _ion_writer_initialize_option_defaults(ION_WRITER_OPTIONS *p_options);
 iERR _ion_writer_initialize(ION_WRITER *pwriter, ION_OBJ_TYPE writer_type);
 
 iERR _ion_writer_get_depth_helper(ION_WRITER *pwriter, SIZE *p_depth);
+iERR _ion_writer_get_local_symbol_stats_helper(ION_WRITER *pwriter, int64_t *p_symbols_added, int64_t *p_rotations);
+iERR _ion_writer_get_memory_stats_helper(ION_WRITER *pwriter, ION_MEMORY_STATS *p_stats);
+iERR _ion_writer_end_symbol_context_helper(ION_WRITER *pwriter);
+iERR _ion_writer_reset_helper(ION_WRITER *pwriter, ION_STREAM *stream, BOOL keep_symbol_table);
 iERR _ion_writer_set_temp_size_helper(ION_WRITER *pwriter, SIZE size_of_temp_space);
 iERR _ion_writer_set_max_annotation_count_helper(ION_WRITER *pwriter, SIZE annotation_limit);
 iERR _ion_writer_set_catalog_helper(ION_WRITER *pwriter, ION_CATALOG *pcatalog);
@@ -225,6 +239,7 @@ iERR _ion_writer_clear_field_name_helper(ION_WRITER *pwriter);
 iERR _ion_writer_add_annotation_helper(ION_WRITER *pwriter, ION_STRING *annotation);
 iERR _ion_writer_add_annotation_sid_helper(ION_WRITER *pwriter, SID sid);
 iERR _ion_writer_add_annotation_symbol_helper(ION_WRITER *pwriter, ION_SYMBOL *annotation);
+iERR _ion_writer_prepared_symbol_sid_helper(ION_WRITER *pwriter, ION_PREPARED_SYMBOL *symbol, SID *p_sid);
 iERR _ion_writer_write_annotations_helper(ION_WRITER *pwriter, ION_STRING *p_annotations, int32_t count);
 iERR _ion_writer_write_annotation_symbols_helper(ION_WRITER *pwriter, ION_SYMBOL *annotations, SIZE count);
 iERR _ion_writer_clear_annotations_helper(ION_WRITER *pwriter);
@@ -256,6 +271,7 @@ iERR _ion_writer_flush_helper(ION_WRITER *pwriter, SIZE *p_bytes_flushed);
 iERR _ion_writer_close_helper(ION_WRITER *pwriter);
 iERR _ion_writer_free_local_symbol_table( ION_WRITER *pwriter );
 iERR _ion_writer_make_symbol_helper(ION_WRITER *pwriter, ION_STRING *pstr, SID *p_sid);
+iERR _ion_writer_rotate_local_symbol_table_helper(ION_WRITER *pwriter);
 iERR _ion_writer_clear_field_name_helper(ION_WRITER *pwriter);
 iERR _ion_writer_get_field_name_as_string_helper(ION_WRITER *pwriter, ION_STRING *p_str, BOOL *p_is_symbol_identifier);
 iERR _ion_writer_get_field_name_as_sid_helper(ION_WRITER *pwriter, SID *p_sid);
@@ -340,6 +356,7 @@ iERR _ion_writer_binary_write_decimal_quad(ION_WRITER *pwriter, decQuad *value);
 iERR _ion_writer_binary_write_decimal_number(ION_WRITER *pwriter, decNumber *value);
 iERR _ion_writer_binary_write_timestamp(ION_WRITER *pwriter, iTIMESTAMP value);
 iERR _ion_writer_binary_write_symbol_id(ION_WRITER *pwriter, SID value);
+iERR _ion_writer_binary_write_symbol_id_helper(ION_WRITER *pwriter, SID value);
 iERR _ion_writer_binary_write_symbol(ION_WRITER *pwriter, iSTRING symbol);
 iERR _ion_writer_binary_write_string(ION_WRITER *pwriter, iSTRING str);
 iERR _ion_writer_binary_write_clob(ION_WRITER *pwriter, BYTE *p_buf, SIZE length);
@@ -353,13 +370,21 @@ iERR _ion_writer_binary_close(ION_WRITER *pwriter, BOOL flush);
 
 iERR _ion_writer_binary_output_stream_handler(ION_STREAM *pstream);
 iERR _ion_writer_binary_input_stream_handler(ION_STREAM *pstream);
+iERR _ion_writer_binary_rotate_at_top_level(ION_WRITER *pwriter);
 iERR _ion_writer_binary_start_value(ION_WRITER *pwriter, int value_length);
+iERR _ion_writer_binary_start_value_helper(ION_WRITER *pwriter, int value_length);
 iERR _ion_writer_binary_close_value(ION_WRITER *writer);
 iERR _ion_writer_binary_push_position(ION_WRITER *bwriter, int type_id);
 iERR _ion_writer_binary_pop(ION_WRITER *bwriter);
-iERR _ion_writer_binary_patch_lengths(ION_WRITER *bwriter, int added_length);
-iERR _ion_writer_binary_top_length(ION_WRITER *bwriter, int *plength);
-iERR _ion_writer_binary_top_position(ION_WRITER *bwriter, int *poffset);
+iERR _ion_writer_binary_write_reserved_length(ION_STREAM *ostream, int length, int size);
+iERR _ion_writer_binary_fill_reserved_length(ION_WRITER *pwriter, ION_BINARY_PATCH *patch);
+iERR _ion_writer_binary_widen_reserved_length(ION_WRITER *pwriter, POSITION slot, int64_t length);
+iERR _ion_writer_binary_spill_values(ION_WRITER *pwriter);
+iERR _ion_writer_binary_release_spill_file(ION_WRITER *pwriter);
+iERR _ion_writer_binary_copy_values(ION_STREAM *out, ION_STREAM *values_in, POSITION length);
+iERR _ion_writer_binary_patch_lengths(ION_WRITER *bwriter, int64_t added_length);
+iERR _ion_writer_binary_top_length(ION_WRITER *bwriter, int64_t *plength);
+iERR _ion_writer_binary_top_position(ION_WRITER *bwriter, POSITION *poffset);
 iERR _ion_writer_binary_top_in_struct(ION_WRITER *bwriter, BOOL *p_is_in_struct);
 
 iERR _ion_writer_binary_flush_to_output(ION_WRITER *pwriter);
@@ -19,6 +19,7 @@
 
 #include "ion_internal.h"
 #include "ion_decimal_impl.h"
+#include "ion_float_impl.h"
 #include <float.h>
 #include <math.h>
 #include <stdio.h>
@@ -27,6 +28,17 @@
 #include <stdarg.h>
 #include <decNumber/decNumber.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ION_WRITER_TEXT_SSE2
+#if defined(_MSC_VER)
+#include <intrin.h>
+static __inline int ION_WRITER_TEXT_CTZ(int mask) { unsigned long idx; _BitScanForward(&idx, (unsigned long)mask); return (int)idx; }
+#else
+#define ION_WRITER_TEXT_CTZ(mask) __builtin_ctz((unsigned)(mask))
+#endif
+#endif
+
 #if defined(_MSC_VER)
 #define FLOAT_CLASS(x) _fpclass(x)
 #elif defined(__GNUC__)
@@ -36,6 +48,12 @@
 #endif
 
 #define LOCAL_INT_CHAR_BUFFER_LENGTH   257
+// sign, "0.", up to 3 leading zeros, 17 digits and an "e0" suffix, or the scientific form, which is shorter
+#define ION_WRITER_TEXT_DOUBLE_IMAGE_LENGTH 32
+// blob contents are base64 encoded into a stack buffer of this many 3 byte groups before being copied out
+#define ION_WRITER_TEXT_BASE64_BLOCK_TRIPLES 64
+
+static iERR _ion_writer_text_append_unescaped_bytes(ION_STREAM *poutput, BYTE *cp, BYTE *limit);
 
 // Helper function to format floating point numbers in a locale-independent way
 // Always uses "." as decimal point regardless of system locale
@@ -441,52 +459,16 @@ iERR _ion_writer_text_write_bool(ION_WRITER *pwriter, BOOL value)
 iERR _ion_writer_text_write_int64(ION_WRITER *pwriter, int64_t value)
 {
     iENTER;
-    char int_image[MAX_INT64_LENGTH + 1], *cp;  // +1 for null terminator
-    int  is_negative = FALSE, digit;
-    int64_t next;
+    char int_image[MAX_INT64_LENGTH + 1], *cp = int_image;  // +1 for the sign
 
     IONCHECK(_ion_writer_text_start_value(pwriter));
 
-    // we'll be writting the sign at the beginning, so just
-    // save it off for the moment
     if (value < 0) {
-        is_negative = TRUE;
+        *cp++ = '-';
     }
-
-    // we'll be writing the digits backwards, so we first null
-    // terminate our output buffer
-    cp = int_image + MAX_INT64_LENGTH;
-    *cp = 0;
-    cp--;
-
-    if (!value) {
-        // just dodge the edge case with leading zeros
-        *cp = '0';
-        cp--;
-    }
-    else {
-        // this isn't the most efficient but is should be right
-        while (value) {
-            next = value / 10;
-            digit = value % 10;
-            if (is_negative) {
-                digit = -digit;
-            }
-            *cp = (char)digit + '0';
-            cp--;
-            value = next;
-        }
-
-        // only non-zero values can be negative
-        if (is_negative) {
-            ION_TEXT_WRITER_APPEND_CHAR('-');
-        }
-    }
-
-    cp++;  // we always back up one too far
-
-    // now write the chars out in the right order
-    IONCHECK(_ion_writer_text_append_ascii_cstr(pwriter->output, cp));
+    // negating as unsigned keeps INT64_MIN from overflowing
+    cp += _ion_u64toa_10_unterminated(value < 0 ? 0 - (uint64_t)value : (uint64_t)value, cp);
+    IONCHECK(_ion_writer_text_append_unescaped_bytes(pwriter->output, (BYTE *)int_image, (BYTE *)cp));
 
     IONCHECK(_ion_writer_text_close_value(pwriter));
 
@@ -565,10 +547,109 @@ fail:
     RETURN(__file__, __line__, __count__, err);
 }
 
+// Extracts the 17 significant digits libc produces for value. Used for the rare inputs for which
+// _ion_float_to_shortest_digits cannot prove its result; 17 digits always round-trip.
+static iERR _ion_writer_text_double_digits_fallback(double value, char *digits, int *p_length, int *p_exponent)
+{
+    iENTER;
+    char image[64], *cp;
+    int  length = 0;
+
+    IONCHECK(_ion_writer_vsnprintf_double(image, sizeof(image), "%.16e", value));
+    for (cp = image; *cp && *cp != 'e'; cp++) {
+        if (*cp >= '0' && *cp <= '9') {
+            digits[length++] = *cp;
+        }
+    }
+    if (*cp != 'e') FAILWITH(IERR_INVALID_STATE);
+    while (length > 1 && digits[length - 1] == '0') {
+        length--;
+    }
+    *p_length = length;
+    // image holds d.ddd...e<X>, so value == digits * 10^(X - (length - 1))
+    *p_exponent = atoi(cp + 1) - (length - 1);
+
+    iRETURN;
+}
+
+// Formats a finite, non-zero double as the shortest text that reads back as the same value. Values whose
+// decimal exponent is in [-4, 17) are written in positional notation ("1.5", "0.001", "123"), all others
+// in scientific notation ("1e-7", "1.2345e+300"). Ion output always carries an exponent so that it reads
+// back as a float ("1.5e0"); JSON output does not. On return *p_length holds the number of characters
+// written to image, which must hold at least ION_WRITER_TEXT_DOUBLE_IMAGE_LENGTH bytes.
+static iERR _ion_writer_text_format_double(char *image, double value, BOOL json, SIZE *p_length)
+{
+    iENTER;
+    char  digits[ION_FLOAT64_MAX_DIGITS];
+    char *cp = image;
+    int   length, exponent, point, ii;
+
+    if (value < 0) {
+        *cp++ = '-';
+        value = -value;
+    }
+    if (!_ion_float_to_shortest_digits(value, digits, &length, &exponent)) {
+        IONCHECK(_ion_writer_text_double_digits_fallback(value, digits, &length, &exponent));
+    }
+
+    // value == 0.<digits> * 10^point
+    point = length + exponent;
+    if (point > -4 && point <= ION_FLOAT64_MAX_DIGITS) {
+        if (point <= 0) {
+            *cp++ = '0';
+            *cp++ = '.';
+            for (ii = point; ii < 0; ii++) *cp++ = '0';
+            memcpy(cp, digits, length);
+            cp += length;
+        }
+        else if (point < length) {
+            memcpy(cp, digits, point);
+            cp += point;
+            *cp++ = '.';
+            memcpy(cp, digits + point, length - point);
+            cp += length - point;
+        }
+        else {
+            memcpy(cp, digits, length);
+            cp += length;
+            for (ii = length; ii < point; ii++) *cp++ = '0';
+        }
+        if (!json) {
+            *cp++ = 'e';
+            *cp++ = '0';
+        }
+    }
+    else {
+        *cp++ = digits[0];
+        if (length > 1) {
+            *cp++ = '.';
+            memcpy(cp, digits + 1, length - 1);
+            cp += length - 1;
+        }
+        *cp++ = 'e';
+        exponent = point - 1;
+        if (exponent < 0) {
+            *cp++ = '-';
+            exponent = -exponent;
+        }
+        else if (json) {
+            *cp++ = '+';
+        }
+        if (exponent >= 100) *cp++ = (char)('0' + exponent / 100);
+        if (exponent >= 10)  *cp++ = (char)('0' + (exponent / 10) % 10);
+        *cp++ = (char)('0' + exponent % 10);
+    }
+    ASSERT(cp - image <= ION_WRITER_TEXT_DOUBLE_IMAGE_LENGTH);
+    *p_length = (SIZE)(cp - image);
+
+    iRETURN;
+}
+
 iERR _ion_writer_text_write_double(ION_WRITER *pwriter, double value)
 {
     iENTER;
-    char image[64], *mark;
+    char image[ION_WRITER_TEXT_DOUBLE_IMAGE_LENGTH];
+    SIZE len;
     int  fpc;
 
     IONCHECK(_ion_writer_text_start_value(pwriter));
@@ -614,24 +695,8 @@ iERR _ion_writer_text_write_double(ION_WRITER *pwriter, double value)
     case FP_SUBNORMAL:
 #endif
 
-        // TODO this is a terrible way to convert this!
-        // See: https://github.com/amazon-ion/ion-c/issues/112
-        // For now:
-        // "If an IEEE 754 double-precision number is converted to a decimal string with at least
-        //  17 significant digits, and then converted back to double-precision representation,
-        //  the final result must match the original number."
-        // (https://en.wikipedia.org/wiki/Double-precision_floating-point_format)
-        // Leaving room for '.', '+'/'-', and 'e', we get 17 + 1 + 1 +1 = 20
-        // Use locale-independent formatting to ensure '.' decimal point
-        IONCHECK(_ion_writer_vsnprintf_double(image, sizeof(image), "%.20g", value));
-        assert(strlen(image) < sizeof(image));
-
-        mark = strchr(image, 'e');
-        if (!mark) {
-            strcat(image, "e+0");
-        }
-        for (mark = image; *mark == ' '; mark++) ; // strip leading spaces
-        IONCHECK(_ion_writer_text_append_ascii_cstr(pwriter->output, mark));    
+        IONCHECK(_ion_writer_text_format_double(image, value, FALSE, &len));
+        IONCHECK(_ion_writer_text_append_unescaped_bytes(pwriter->output, (BYTE *)image, (BYTE *)image + len));
         break;
 
     default:
@@ -645,7 +710,8 @@ iERR _ion_writer_text_write_double(ION_WRITER *pwriter, double value)
 
 iERR _ion_writer_text_write_double_json(ION_WRITER *pwriter, double value) {
    iENTER;
-   char image[64], *mark;
+   char image[ION_WRITER_TEXT_DOUBLE_IMAGE_LENGTH];
+   SIZE len;
    int fpc = FLOAT_CLASS(value);
 
    IONCHECK(_ion_writer_text_start_value(pwriter));
@@ -678,19 +744,8 @@ iERR _ion_writer_text_write_double_json(ION_WRITER *pwriter, double value) {
    case FP_NORMAL:
    case FP_SUBNORMAL:
 #  endif
-        // TODO this is a terrible way to convert this!
-        // See: https://github.com/amazon-ion/ion-c/issues/112
-
-        // The '*' in the format string indicates `DBL_DIG - 1` should be used for the precision.
-        // The precision is the number of digits allowed to the *right* of the decimal point.
-        // DBL_DIG contains the number of decimal digits that are guaranteed to be preserved
-        // in a text to double roundtrip without change due to rounding or overflow. We subtract
-        // one, since the precision is digits right of the decimal point, and DBL_DIG is total digits.
-        // Use locale-independent formatting to ensure '.' decimal point
-        IONCHECK(_ion_writer_vsnprintf_double(image, sizeof(image), "%.*g", DBL_DIG - 1, value));
-
-        for (mark = image; *mark == ' '; ) mark++; // strip leading spaces
-        IONCHECK(_ion_writer_text_append_ascii_cstr(pwriter->output, mark));
+        IONCHECK(_ion_writer_text_format_double(image, value, TRUE, &len));
+        IONCHECK(_ion_writer_text_append_unescaped_bytes(pwriter->output, (BYTE *)image, (BYTE *)image + len));
         break;
    default:
       FAILWITH(IERR_UNRECOGNIZED_FLOAT);
@@ -979,7 +1034,9 @@ iERR _ion_writer_text_append_blob_contents(ION_WRITER *pwriter, BYTE *p_buf, SIZ
 {
     iENTER;
     char image[5];
+    char block[ION_WRITER_TEXT_BASE64_BLOCK_TRIPLES * 4];
     int  triple;
+    SIZE triples, block_len;
 
     ASSERT(pwriter);
     ASSERT(p_buf);
@@ -1017,6 +1074,7 @@ iERR _ion_writer_text_append_blob_contents(ION_WRITER *pwriter, BYTE *p_buf, SIZ
             // if we still didn't get up to 3 bytes stored
             // we'll just have to hope the user calls us
             // with some more data in due course
+            TEXTWRITER(pwriter)->_pending_triple = triple;
             SUCCEED();
         }
         // but it managed to fill out the pending triple, let's write it out
@@ -1025,16 +1083,16 @@ iERR _ion_writer_text_append_blob_contents(ION_WRITER *pwriter, BYTE *p_buf, SIZ
         TEXTWRITER(pwriter)->_pending_blob_bytes = 0; // and, for the moment, nothings pending
     }
 
-    // output any whole triplets we can
+    // output any whole triplets we can, a block at a time
     while (length > 2) {
-        triple = *p_buf++;
-        triple <<= 8;
-        triple |= *p_buf++;
-        triple <<= 8;
-        triple |= *p_buf++;
-        _ion_writer_text_write_blob_make_base64_image(triple, image);
-        IONCHECK(_ion_writer_text_append_ascii_cstr(pwriter->output, image));
-        length -= 3;
+        triples = length / 3;
+        if (triples > ION_WRITER_TEXT_BASE64_BLOCK_TRIPLES) {
+            triples = ION_WRITER_TEXT_BASE64_BLOCK_TRIPLES;
+        }
+        block_len = _ion_base64_encode_triples(p_buf, triples, block);
+        IONCHECK(_ion_writer_text_append_unescaped_bytes(pwriter->output, (BYTE *)block, (BYTE *)block + block_len));
+        p_buf += triples * 3;
+        length -= triples * 3;
     }
 
     // remember the tail, whatever that turns out to be - someone
@@ -1386,10 +1444,90 @@ iERR _ion_writer_text_append_escape_sequence_cstr(ION_STREAM *poutput, char *cp,
     iRETURN;
 }
 
+// Returns a pointer to the first byte in [cp, limit) that needs to be escaped: a control
+// character, a backslash, the quote character, and (when escape_non_ascii is set) any byte
+// >= 127. Returns limit if the whole range can be copied to the output as is. The bulk of the
+// scan looks at 16 bytes per step with SSE2 where available, and at 8 bytes per step otherwise.
+static BYTE *_ion_writer_text_find_next_escape(BYTE *cp, BYTE *limit, BYTE quote_char, BOOL escape_non_ascii)
+{
+#if defined(ION_WRITER_TEXT_SSE2)
+    const __m128i v_ctrl  = _mm_set1_epi8(31);
+    const __m128i v_del   = _mm_set1_epi8((char)127);
+    const __m128i v_slash = _mm_set1_epi8('\\');
+    const __m128i v_quote = _mm_set1_epi8((char)quote_char);
+    __m128i v, hits;
+    int     mask;
+
+    while (limit - cp >= 16) {
+        v = _mm_loadu_si128((const __m128i *)cp);
+        // c <= 31, computed as an unsigned compare: min(c, 31) == c
+        hits = _mm_cmpeq_epi8(_mm_min_epu8(v, v_ctrl), v);
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(v, v_slash));
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(v, v_quote));
+        if (escape_non_ascii) {
+            // c >= 127, computed as an unsigned compare: max(c, 127) == c
+            hits = _mm_or_si128(hits, _mm_cmpeq_epi8(_mm_max_epu8(v, v_del), v));
+        }
+        mask = _mm_movemask_epi8(hits);
+        if (mask != 0) {
+            return cp + ION_WRITER_TEXT_CTZ(mask);
+        }
+        cp += 16;
+    }
+#else
+    // SWAR: each test below may flag false positives in bytes that follow a true hit (borrows
+    // propagate upward), but it never misses one, so a flagged word is re-scanned bytewise.
+    const uint64_t ones  = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+    const uint64_t slash = ones * (BYTE)'\\';
+    const uint64_t quote = ones * quote_char;
+    uint64_t w, x, hits;
+
+    while (limit - cp >= 8) {
+        memcpy(&w, cp, sizeof(w));
+        hits  = (w - ones * 32) & ~w;                   // some byte < 32
+        x     = w ^ slash;
+        hits |= (x - ones) & ~x;                        // some byte == '\\'
+        x     = w ^ quote;
+        hits |= (x - ones) & ~x;                        // some byte == quote_char
+        if (escape_non_ascii) {
+            hits |= w;                                  // some byte >= 128
+            x     = w ^ (ones * 127);
+            hits |= (x - ones) & ~x;                    // some byte == 127 (DEL)
+        }
+        if (hits & highs) break;
+        cp += 8;
+    }
+#endif
+
+    for (; cp < limit; cp++) {
+        if (escape_non_ascii ? ION_WRITER_NEEDS_ESCAPE_ASCII(*cp) : ION_WRITER_NEEDS_ESCAPE_UTF8(*cp)) break;
+        if (*cp == quote_char) break;
+    }
+    return cp;
+}
+
+// Copies [cp, limit) to the output without escaping.
+static iERR _ion_writer_text_append_unescaped_bytes(ION_STREAM *poutput, BYTE *cp, BYTE *limit)
+{
+    iENTER;
+    SIZE len = (SIZE)(limit - cp), written;
+
+    if (len == 1) {
+        ION_PUT(poutput, *cp);
+    }
+    else if (len > 0) {
+        IONCHECK(ion_stream_write(poutput, cp, len, &written));
+        if (written != len) FAILWITH(IERR_WRITE_ERROR);
+    }
+
+    iRETURN;
+}
+
 iERR _ion_writer_text_append_escaped_string_utf8(ION_STREAM *poutput, ION_STRING *p_str, char quote_char)
 {
     iENTER;
-    BYTE *cp, *limit;
+    BYTE *cp, *limit, *clean;
 
     if (!poutput) FAILWITH(IERR_BAD_HANDLE);
     if (!p_str) FAILWITH(IERR_INVALID_ARG);
@@ -1404,13 +1542,12 @@ iERR _ion_writer_text_append_escaped_string_utf8(ION_STREAM *poutput, ION_STRING
         // utf8 sequences have the high bit set and will simply be treated
         // as normal characters and pass through - at this point we don't
         // validate that the sequences are valid
-        if (ION_WRITER_NEEDS_ESCAPE_UTF8(*cp) || (*cp == quote_char)) {
+        clean = _ion_writer_text_find_next_escape(cp, limit, (BYTE)quote_char, FALSE);
+        IONCHECK(_ion_writer_text_append_unescaped_bytes(poutput, cp, clean));
+        cp = clean;
+        if (cp < limit) {
             IONCHECK(_ion_writer_text_append_escape_sequence_string(poutput, FALSE, cp, limit, &cp));
         }
-        else {
-            ION_PUT(poutput, *cp);
-            cp++;
-        }
     }
 
     iRETURN;
@@ -1419,7 +1556,7 @@ iERR _ion_writer_text_append_escaped_string_utf8(ION_STREAM *poutput, ION_STRING
 iERR _ion_writer_text_append_escaped_string(ION_STREAM *poutput, ION_STRING *p_str, char quote_char, BOOL down_convert)
 {
     iENTER;
-    BYTE *cp, *limit;
+    BYTE *cp, *limit, *clean;
 
     if (!poutput) FAILWITH(IERR_BAD_HANDLE);
     if (!p_str) FAILWITH(IERR_INVALID_ARG);
@@ -1431,13 +1568,12 @@ iERR _ion_writer_text_append_escaped_string(ION_STREAM *poutput, ION_STRING *p_s
 
     while (cp < limit) {
         // this escapes <32, slash, double quotes AND utf8 sequences
-        if (ION_WRITER_NEEDS_ESCAPE_ASCII(*cp) || *cp == quote_char) {
+        clean = _ion_writer_text_find_next_escape(cp, limit, (BYTE)quote_char, TRUE);
+        IONCHECK(_ion_writer_text_append_unescaped_bytes(poutput, cp, clean));
+        cp = clean;
+        if (cp < limit) {
             IONCHECK(_ion_writer_text_append_escape_sequence_string(poutput, down_convert, cp, limit, &cp));
         }
-        else {
-            ION_PUT(poutput, *cp);
-            cp++;
-        }
     }
 
     iRETURN;
@@ -0,0 +1,312 @@
+/*
+ * Copyright 2009-2019 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ * A copy of the License is located at:
+ *
+ *     http://aws.amazon.com/apache2.0/
+ *
+ * or in the "license" file accompanying this file. This file is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the License for the specific
+ * language governing permissions and limitations under the License.
+ */
+
+#include <string>
+#include <thread>
+#include <gtest/gtest.h>
+#include <ionc/ion.h>
+#include "ion_alloc.h"
+#include "ion_test_util.h"
+
+class BlockPoolTest : public ::testing::Test {
+protected:
+    void SetUp() {
+        ION_ASSERT_OK(ion_block_pool_get_options(&saved_options));
+        ION_ASSERT_OK(ion_block_pool_trim());
+    }
+
+    void TearDown() {
+        ION_ASSERT_OK(ion_block_pool_set_options(&saved_options));
+        ION_ASSERT_OK(ion_block_pool_trim());
+    }
+
+    ION_BLOCK_POOL_OPTIONS saved_options;
+};
+
+TEST(BlockPool, ThreadCachesAreOptIn) {
+    ION_BLOCK_POOL_OPTIONS options;
+    ION_ASSERT_OK(ion_block_pool_get_options(&options));
+    ASSERT_EQ(0, options.thread_cache_max_blocks);
+}
+
+TEST_F(BlockPoolTest, ReusesStandardBlocksOnTheSameThread) {
+    ION_BLOCK_POOL_OPTIONS options;
+    options.thread_cache_max_blocks = 2;
+    options.shared_max_blocks = 0;
+    ION_ASSERT_OK(ion_block_pool_set_options(&options));
+
+    void *first = ion_alloc_owner(sizeof(int));
+    ASSERT_TRUE(first != NULL);
+    ion_free_owner(first);
+    void *second = ion_alloc_owner(sizeof(int));
+    ASSERT_EQ(first, second);
+    ion_free_owner(second);
+}
+
+TEST_F(BlockPoolTest, PassesBlocksBetweenThreadsThroughTheSharedList) {
+    ION_BLOCK_POOL_OPTIONS options;
+    void *released = NULL;
+    options.thread_cache_max_blocks = 0;
+    options.shared_max_blocks = 4;
+    ION_ASSERT_OK(ion_block_pool_set_options(&options));
+
+    std::thread releaser([&released]() {
+        released = ion_alloc_owner(sizeof(int));
+        ion_free_owner(released);
+    });
+    releaser.join();
+    ASSERT_TRUE(released != NULL);
+
+    void *owner = ion_alloc_owner(sizeof(int));
+    ASSERT_EQ(released, owner);
+    ion_free_owner(owner);
+}
+
+TEST_F(BlockPoolTest, FreesOversizedBlocksAndBlocksPastTheHighWaterMark) {
+    ION_BLOCK_POOL_OPTIONS options;
+    void *owners[3];
+    options.thread_cache_max_blocks = 1;
+    options.shared_max_blocks = 1;
+    ION_ASSERT_OK(ion_block_pool_set_options(&options));
+
+    for (int i = 0; i < 3; i++) {
+        owners[i] = ion_alloc_owner(sizeof(int));
+        ASSERT_TRUE(owners[i] != NULL);
+    }
+    for (int i = 0; i < 3; i++) {
+        ion_free_owner(owners[i]);
+    }
+    // One block was cached by this thread and one went to the shared list; the third was freed.
+    ASSERT_EQ(owners[0], ion_alloc_owner(sizeof(int)));
+    ASSERT_EQ(owners[1], ion_alloc_owner(sizeof(int)));
+    ion_free_owner(owners[0]);
+    ion_free_owner(owners[1]);
+
+    // Oversized blocks are never pooled.
+    void *large = ion_alloc_owner(DEFAULT_BLOCK_SIZE * 2);
+    ASSERT_TRUE(large != NULL);
+    ion_free_owner(large);
+
+    options.thread_cache_max_blocks = -1;
+    ASSERT_EQ(IERR_INVALID_ARG, ion_block_pool_set_options(&options));
+}
+
+struct CountingAllocatorContext {
+    int allocs;
+    int frees;
+};
+
+static void *counting_alloc(void *context, size_t size) {
+    ((CountingAllocatorContext *)context)->allocs++;
+    return malloc(size);
+}
+
+static void counting_free(void *context, void *ptr) {
+    ((CountingAllocatorContext *)context)->frees++;
+    free(ptr);
+}
+
+TEST(IonAllocator, ServesAllOfAReaderAndWritersMemory) {
+    CountingAllocatorContext counts = {0, 0};
+    ION_ALLOCATOR allocator = {counting_alloc, counting_free, NULL, &counts};
+    ION_WRITER_OPTIONS writer_options;
+    ION_READER_OPTIONS reader_options;
+    hWRITER writer;
+    hREADER reader;
+    BYTE buffer[256];
+    SIZE written;
+    ION_STRING symbol, read_symbol;
+    ION_TYPE type;
+
+    memset(&writer_options, 0, sizeof(writer_options));
+    writer_options.output_as_binary = TRUE;
+    writer_options.allocator = &allocator;
+    ION_ASSERT_OK(ion_string_from_cstr("abc", &symbol));
+    ION_ASSERT_OK(ion_writer_open_buffer(&writer, buffer, sizeof(buffer), &writer_options));
+    ION_ASSERT_OK(ion_writer_write_symbol(writer, &symbol));
+    ION_ASSERT_OK(ion_writer_finish(writer, &written));
+    ION_ASSERT_OK(ion_writer_close(writer));
+    ASSERT_LT(0, counts.allocs);
+    ASSERT_EQ(counts.allocs, counts.frees);
+
+    counts.allocs = counts.frees = 0;
+    memset(&reader_options, 0, sizeof(reader_options));
+    reader_options.allocator = &allocator;
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, buffer, written, &reader_options));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_SYMBOL, type);
+    ION_ASSERT_OK(ion_reader_read_string(reader, &read_symbol));
+    ASSERT_TRUE(ION_STRING_EQUALS(&symbol, &read_symbol));
+    ION_ASSERT_OK(ion_reader_close(reader));
+    ASSERT_LT(0, counts.allocs);
+    ASSERT_EQ(counts.allocs, counts.frees);
+}
+
+TEST(IonAllocator, DefaultAllocatorServesOwnersAndIntegers) {
+    CountingAllocatorContext counts = {0, 0};
+    ION_ALLOCATOR allocator = {counting_alloc, counting_free, NULL, &counts};
+    ION_ALLOCATOR *previous;
+    ION_INT *iint;
+
+    ION_ASSERT_OK(ion_allocator_get_default(&previous));
+    ION_ASSERT_OK(ion_allocator_set_default(&allocator));
+
+    void *owner = ion_alloc_owner(sizeof(int));
+    ASSERT_TRUE(owner != NULL);
+    ION_ASSERT_OK(ion_int_alloc(NULL, &iint));
+    ION_ASSERT_OK(ion_int_from_long(iint, 1234567890123LL));
+    ion_int_free(iint);
+    ion_free_owner(owner);
+
+    ION_ASSERT_OK(ion_allocator_set_default(previous));
+    ASSERT_LT(2, counts.allocs);
+    ASSERT_EQ(counts.allocs, counts.frees);
+
+    allocator.free = NULL;
+    ASSERT_EQ(IERR_INVALID_ARG, ion_allocator_set_default(&allocator));
+}
+
+TEST(IonMemoryStats, ReportsOwnerReaderAndWriterUsage) {
+    ION_MEMORY_STATS stats;
+    ION_MEMORY_TOTALS before, during, after;
+    ION_WRITER_OPTIONS writer_options;
+    hWRITER writer;
+    hREADER reader;
+    BYTE buffer[256];
+    SIZE written;
+    ION_STRING symbol;
+    ION_TYPE type;
+
+    ION_ASSERT_OK(ion_memory_get_totals(&before));
+    void *owner = ion_alloc_owner(sizeof(int));
+    ASSERT_TRUE(owner != NULL);
+    ASSERT_TRUE(ion_alloc_with_owner(owner, DEFAULT_BLOCK_SIZE * 2) != NULL);
+    ION_ASSERT_OK(ion_owner_get_memory_stats(owner, &stats));
+    ASSERT_EQ(2, stats.block_count);
+    ASSERT_EQ(1, stats.oversized_block_count);
+    ASSERT_LT(DEFAULT_BLOCK_SIZE * 3, stats.bytes_reserved);
+    ASSERT_LT(DEFAULT_BLOCK_SIZE * 2, stats.bytes_used);
+    ASSERT_GE(stats.bytes_reserved, stats.bytes_used);
+    ASSERT_EQ(stats.bytes_reserved, stats.high_water);
+
+    ION_ASSERT_OK(ion_memory_get_totals(&during));
+    ASSERT_EQ(before.block_count + 2, during.block_count);
+    ASSERT_EQ(before.oversized_block_count + 1, during.oversized_block_count);
+    ASSERT_EQ(before.bytes_reserved + stats.bytes_reserved, during.bytes_reserved);
+    ASSERT_LE(during.bytes_reserved, during.high_water);
+    ion_free_owner(owner);
+    ION_ASSERT_OK(ion_memory_get_totals(&after));
+    ASSERT_EQ(before.bytes_reserved, after.bytes_reserved);
+    ASSERT_EQ(before.block_count, after.block_count);
+
+    memset(&writer_options, 0, sizeof(writer_options));
+    writer_options.output_as_binary = TRUE;
+    ION_ASSERT_OK(ion_string_from_cstr("abc", &symbol));
+    ION_ASSERT_OK(ion_writer_open_buffer(&writer, buffer, sizeof(buffer), &writer_options));
+    ION_ASSERT_OK(ion_writer_write_symbol(writer, &symbol));
+    ION_ASSERT_OK(ion_writer_get_memory_stats(writer, &stats));
+    ASSERT_LT(1, stats.block_count);
+    ASSERT_LT(0, stats.bytes_used);
+    ION_ASSERT_OK(ion_writer_finish(writer, &written));
+    ION_ASSERT_OK(ion_writer_close(writer));
+
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, buffer, written, NULL));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_get_memory_stats(reader, &stats));
+    ASSERT_LT(1, stats.block_count);
+    ASSERT_GE(stats.bytes_reserved, stats.bytes_used);
+    ASSERT_LE(stats.bytes_reserved, stats.high_water);
+    ION_ASSERT_OK(ion_reader_close(reader));
+
+    ION_ASSERT_OK(ion_memory_get_totals(&after));
+    ASSERT_EQ(before.bytes_reserved, after.bytes_reserved);
+    ASSERT_EQ(IERR_INVALID_ARG, ion_owner_get_memory_stats(NULL, &stats));
+}
+
+TEST(IonAllocMark, RewindReleasesOnlyWhatWasAllocatedSinceTheMark) {
+    ION_ALLOC_MARK mark, other_mark;
+    ION_MEMORY_STATS marked, stats;
+
+    void *owner = ion_alloc_owner(sizeof(int));
+    ASSERT_TRUE(owner != NULL);
+    char *kept = (char *)ion_alloc_with_owner(owner, 100);
+    ASSERT_TRUE(kept != NULL);
+    memset(kept, 'k', 100);
+    ION_ASSERT_OK(ion_alloc_mark(owner, &mark));
+    ION_ASSERT_OK(ion_owner_get_memory_stats(owner, &marked));
+
+    for (int round = 0; round < 3; round++) {
+        // Fill a few standard blocks and link in oversized ones along the way.
+        for (int i = 0; i < 8; i++) {
+            ASSERT_TRUE(ion_alloc_with_owner(owner, DEFAULT_BLOCK_SIZE / 3) != NULL);
+            if (i % 3 == 0) {
+                ASSERT_TRUE(ion_alloc_with_owner(owner, DEFAULT_BLOCK_SIZE * 2) != NULL);
+            }
+        }
+        ION_ASSERT_OK(ion_owner_get_memory_stats(owner, &stats));
+        ASSERT_LT(marked.block_count, stats.block_count);
+
+        ION_ASSERT_OK(ion_alloc_rewind(owner, &mark));
+        ION_ASSERT_OK(ion_owner_get_memory_stats(owner, &stats));
+        ASSERT_EQ(marked.block_count, stats.block_count);
+        ASSERT_EQ(marked.bytes_reserved, stats.bytes_reserved);
+        ASSERT_EQ(marked.bytes_used, stats.bytes_used);
+        for (int i = 0; i < 100; i++) {
+            ASSERT_EQ('k', kept[i]);
+        }
+    }
+
+    void *other = ion_alloc_owner(sizeof(int));
+    ION_ASSERT_OK(ion_alloc_mark(other, &other_mark));
+    ASSERT_EQ(IERR_INVALID_ARG, ion_alloc_rewind(owner, &other_mark));
+    ion_free_owner(other);
+    ion_free_owner(owner);
+}
+
+TEST(IonAllocMark, ReaderMemoryDoesNotGrowAcrossTopLevelValues) {
+    // The custom allocator bypasses the block pool, so every block the reader obtains or releases is counted. Its
+    // temp pool is rewound at each top-level value rather than being freed and allocated again.
+    CountingAllocatorContext counts = {0, 0};
+    ION_ALLOCATOR allocator = {counting_alloc, counting_free, NULL, &counts};
+    ION_READER_OPTIONS options;
+    std::string text;
+    hREADER reader;
+    ION_TYPE type;
+    ION_STRING value;
+    ION_MEMORY_STATS first, stats;
+    CountingAllocatorContext first_counts;
+
+    for (int i = 0; i < 2000; i++) {
+        text += "\"" + std::string(200, 'a' + (i % 26)) + "\" ";
+    }
+    memset(&options, 0, sizeof(options));
+    options.allocator = &allocator;
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, (BYTE *)text.c_str(), (SIZE)text.length(), &options));
+    for (int i = 0; i < 2000; i++) {
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_STRING, type);
+        ION_ASSERT_OK(ion_reader_read_string(reader, &value));
+        ION_ASSERT_OK(ion_reader_get_memory_stats(reader, &stats));
+        if (i == 0) {
+            first = stats;
+            first_counts = counts;
+        }
+        ASSERT_EQ(first.block_count, stats.block_count);
+        ASSERT_EQ(first.bytes_reserved, stats.bytes_reserved);
+        ASSERT_EQ(first_counts.allocs, counts.allocs);
+        ASSERT_EQ(first_counts.frees, counts.frees);
+    }
+    ION_ASSERT_OK(ion_reader_close(reader));
+    ASSERT_EQ(counts.allocs, counts.frees);
+}
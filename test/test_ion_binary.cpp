@@ -18,6 +18,7 @@
 #include "ion_helpers.h"
 #include "ion_test_util.h"
 #include "ion_event_equivalence.h"
+#include <vector>
 
 TEST(IonBinaryLen, UInt64) {
 
@@ -763,3 +764,239 @@ TEST(IonBinaryFloat, WriterSupportsCompactFloatsOption) {
     //    4    0    8    6    6    6    6    6
     test_ion_binary_writer_supports_compact_floats(TRUE, truncated, "\xE0\x01\x00\xEA\x44\x40\x86\x66\x66", 9);
 }
+
+static void test_ion_binary_rewrite_text(const char *text, ION_WRITER_OPTIONS *options, BYTE **out, SIZE *out_length) {
+    hREADER reader;
+    hWRITER writer;
+    ION_STREAM *stream = NULL;
+
+    options->output_as_binary = TRUE;
+    ION_ASSERT_OK(ion_stream_open_memory_only(&stream));
+    ION_ASSERT_OK(ion_writer_open(&writer, stream, options));
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, (BYTE *)text, (SIZE)strlen(text), NULL));
+    ION_ASSERT_OK(ion_writer_write_all_values(writer, reader));
+    ION_ASSERT_OK(ion_reader_close(reader));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, out, out_length));
+}
+
+static std::string test_ion_binary_nested_text() {
+    std::string text = "a::[1, {b:c::\"d\", e:(f g)}, {{aGVsbG8=}}] {} [] ";
+    std::string big = "[";
+    for (int i = 0; i < 100; i++) {
+        big += "{x:[\"" + std::string(i, 'y') + "\"]},";
+    }
+    return text + big + "] top::{z:" + big + "]} [[]]";
+}
+
+TEST(IonBinaryWriter, ReservedLengthsWriteContainerHeadersInPlace) {
+    BYTE *minimal, *reserved;
+    SIZE minimal_length, reserved_length;
+    ION_WRITER_OPTIONS options;
+    std::string text = test_ion_binary_nested_text();
+
+    // The list's header is written with a two-byte padded length.
+    memset(&options, 0, sizeof(options));
+    options.binary_reserved_length_size = 2;
+    test_ion_binary_rewrite_text("[1]", &options, &reserved, &reserved_length);
+    assertBytesEqual("\xE0\x01\x00\xEA\xBE\x00\x82\x21\x01", 9, reserved, reserved_length);
+    free(reserved);
+
+    // One-byte lengths must be widened for every container over 127 bytes.
+    IonEventStream minimal_stream;
+    memset(&options, 0, sizeof(options));
+    test_ion_binary_rewrite_text(text.c_str(), &options, &minimal, &minimal_length);
+    ION_ASSERT_OK(ion_event_stream_read_all_from_bytes(minimal, minimal_length, NULL, &minimal_stream));
+    for (SIZE size = 1; size <= 4; size++) {
+        IonEventStream reserved_stream;
+        memset(&options, 0, sizeof(options));
+        options.binary_reserved_length_size = size;
+        test_ion_binary_rewrite_text(text.c_str(), &options, &reserved, &reserved_length);
+        ASSERT_LE(minimal_length, reserved_length);
+        ION_ASSERT_OK(ion_event_stream_read_all_from_bytes(reserved, reserved_length, NULL, &reserved_stream));
+        ASSERT_TRUE(ion_compare_streams(&minimal_stream, &reserved_stream));
+        free(reserved);
+    }
+    free(minimal);
+
+    // Empty containers end exactly where their headers do, including at the end of the buffered values.
+    const char *empty_containers[] = {"[]", "{}", "1 []", "ann::{}", "[[], 1]", "[[]]", "{a:{}} ([])"};
+    for (size_t ii = 0; ii < sizeof(empty_containers) / sizeof(empty_containers[0]); ii++) {
+        IonEventStream expected_stream;
+        memset(&options, 0, sizeof(options));
+        test_ion_binary_rewrite_text(empty_containers[ii], &options, &minimal, &minimal_length);
+        ION_ASSERT_OK(ion_event_stream_read_all_from_bytes(minimal, minimal_length, NULL, &expected_stream));
+        for (SIZE size = 1; size <= 4; size++) {
+            IonEventStream reserved_stream;
+            memset(&options, 0, sizeof(options));
+            options.binary_reserved_length_size = size;
+            test_ion_binary_rewrite_text(empty_containers[ii], &options, &reserved, &reserved_length);
+            ION_ASSERT_OK(ion_event_stream_read_all_from_bytes(reserved, reserved_length, NULL, &reserved_stream));
+            ASSERT_TRUE(ion_compare_streams(&expected_stream, &reserved_stream)) << empty_containers[ii];
+            free(reserved);
+        }
+        free(minimal);
+    }
+
+    hWRITER writer;
+    BYTE buffer[16];
+    memset(&options, 0, sizeof(options));
+    options.output_as_binary = TRUE;
+    options.binary_reserved_length_size = 5;
+    ASSERT_EQ(IERR_INVALID_ARG, ion_writer_open_buffer(&writer, buffer, sizeof(buffer), &options));
+}
+
+static void test_ion_binary_write_records(ION_WRITER_OPTIONS *options, int count, ION_TYPE record_type,
+                                          ION_MEMORY_STATS *p_stats, BYTE **out, SIZE *out_length) {
+    hWRITER writer;
+    ION_STREAM *stream = NULL;
+    ION_STRING id, name, value;
+
+    options->output_as_binary = TRUE;
+    ION_ASSERT_OK(ion_stream_open_memory_only(&stream));
+    ION_ASSERT_OK(ion_writer_open(&writer, stream, options));
+    ion_string_from_cstr("id", &id);
+    ion_string_from_cstr("name", &name);
+    ion_string_from_cstr("a record in one very large top-level list", &value);
+    ION_ASSERT_OK(ion_writer_start_container(writer, tid_LIST));
+    for (int i = 0; i < count; i++) {
+        if (record_type == tid_SYMBOL) {
+            ION_ASSERT_OK(ion_writer_write_symbol(writer, &name));
+            continue;
+        }
+        ION_ASSERT_OK(ion_writer_start_container(writer, tid_STRUCT));
+        ION_ASSERT_OK(ion_writer_write_field_name(writer, &id));
+        ION_ASSERT_OK(ion_writer_write_int(writer, i));
+        ION_ASSERT_OK(ion_writer_write_field_name(writer, &name));
+        ION_ASSERT_OK(ion_writer_write_string(writer, &value));
+        ION_ASSERT_OK(ion_writer_finish_container(writer));
+    }
+    ION_ASSERT_OK(ion_writer_get_memory_stats(writer, p_stats));
+    ION_ASSERT_OK(ion_writer_finish_container(writer));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, out, out_length));
+}
+
+TEST(IonBinaryWriter, SpillThresholdBoundsTheMemoryForALargeTopLevelValue) {
+    BYTE *buffered, *spilled;
+    SIZE buffered_length, spilled_length;
+    ION_MEMORY_STATS buffered_stats, spilled_stats;
+    ION_WRITER_OPTIONS options;
+
+    memset(&options, 0, sizeof(options));
+    options.binary_reserved_length_size = 4;
+    test_ion_binary_write_records(&options, 20000, tid_STRUCT, &buffered_stats, &buffered, &buffered_length);
+    memset(&options, 0, sizeof(options));
+    options.binary_reserved_length_size = 4;
+    options.binary_spill_threshold = 16 * 1024;
+    test_ion_binary_write_records(&options, 20000, tid_STRUCT, &spilled_stats, &spilled, &spilled_length);
+
+    assertBytesEqual((const char *)buffered, buffered_length, spilled, spilled_length);
+    ASSERT_LT(buffered_length, buffered_stats.bytes_reserved);
+    ASSERT_GT(buffered_length / 2, spilled_stats.bytes_reserved);
+    free(buffered);
+    free(spilled);
+
+    // Without reserved lengths the patches stay in memory, but the values are still spilled.
+    memset(&options, 0, sizeof(options));
+    test_ion_binary_write_records(&options, 2000, tid_STRUCT, &buffered_stats, &buffered, &buffered_length);
+    memset(&options, 0, sizeof(options));
+    options.binary_spill_threshold = 1;
+    test_ion_binary_write_records(&options, 2000, tid_STRUCT, &spilled_stats, &spilled, &spilled_length);
+    assertBytesEqual((const char *)buffered, buffered_length, spilled, spilled_length);
+    free(buffered);
+    free(spilled);
+
+    // Symbol values are spilled too.
+    memset(&options, 0, sizeof(options));
+    options.binary_reserved_length_size = 4;
+    test_ion_binary_write_records(&options, 200000, tid_SYMBOL, &buffered_stats, &buffered, &buffered_length);
+    memset(&options, 0, sizeof(options));
+    options.binary_reserved_length_size = 4;
+    options.binary_spill_threshold = 16 * 1024;
+    test_ion_binary_write_records(&options, 200000, tid_SYMBOL, &spilled_stats, &spilled, &spilled_length);
+    assertBytesEqual((const char *)buffered, buffered_length, spilled, spilled_length);
+    ASSERT_GT(buffered_length / 2, spilled_stats.bytes_reserved);
+    free(buffered);
+    free(spilled);
+}
+
+struct PeakAllocatorContext {
+    size_t live;
+    size_t peak;
+};
+
+static const size_t PEAK_ALLOC_HEADER = 16; // keeps the returned memory as aligned as malloc's
+
+static void *peak_alloc(void *context, size_t size) {
+    PeakAllocatorContext *counts = (PeakAllocatorContext *)context;
+    BYTE *block = (BYTE *)malloc(size + PEAK_ALLOC_HEADER);
+    if (!block) return NULL;
+    *(size_t *)block = size;
+    counts->live += size;
+    if (counts->live > counts->peak) counts->peak = counts->live;
+    return block + PEAK_ALLOC_HEADER;
+}
+
+static void peak_free(void *context, void *ptr) {
+    if (!ptr) return;
+    BYTE *block = (BYTE *)ptr - PEAK_ALLOC_HEADER;
+    ((PeakAllocatorContext *)context)->live -= *(size_t *)block;
+    free(block);
+}
+
+TEST(IonBinaryWriter, SpilledValueTooLongForItsReservedLengthIsWidenedInBoundedMemory) {
+    // 260 one-megabyte blobs make a list longer than 2^28 - 1 bytes, the most a 4-byte reserved length can hold.
+    const int blob_count = 260;
+    const SIZE blob_size = 1 << 20;
+    PeakAllocatorContext counts = {0, 0};
+    ION_ALLOCATOR allocator = {peak_alloc, peak_free, NULL, &counts};
+    ION_WRITER_OPTIONS options;
+    hWRITER writer;
+    hREADER reader;
+    ION_STREAM *stream = NULL;
+    ION_TYPE type;
+    BYTE first;
+    SIZE length;
+    FILE *out = tmpfile();
+    ASSERT_TRUE(out != NULL);
+    std::vector<BYTE> blob(blob_size, 0x5A);
+
+    memset(&options, 0, sizeof(options));
+    options.output_as_binary = TRUE;
+    options.binary_reserved_length_size = 4;
+    options.binary_spill_threshold = 1 << 20;
+    options.allocator = &allocator;
+    ION_ASSERT_OK(ion_stream_open_file_rw(out, FALSE, &stream));
+    ION_ASSERT_OK(ion_writer_open(&writer, stream, &options));
+    ION_ASSERT_OK(ion_writer_start_container(writer, tid_LIST));
+    for (int i = 0; i < blob_count; i++) {
+        blob[0] = (BYTE)i;
+        ION_ASSERT_OK(ion_writer_write_blob(writer, blob.data(), blob_size));
+    }
+    ION_ASSERT_OK(ion_writer_finish_container(writer));
+    ION_ASSERT_OK(ion_writer_close(writer));
+    ION_ASSERT_OK(ion_stream_close(stream));
+    ASSERT_GT((size_t)16 << 20, counts.peak);
+
+    ASSERT_EQ(0, fseek(out, 0, SEEK_SET));
+    ION_ASSERT_OK(ion_stream_open_file_in(out, &stream));
+    ION_ASSERT_OK(ion_reader_open(&reader, stream, NULL));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_LIST, type);
+    ION_ASSERT_OK(ion_reader_step_in(reader));
+    for (int i = 0; i < blob_count; i++) {
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_BLOB, type);
+        ION_ASSERT_OK(ion_reader_get_lob_size(reader, &length));
+        ASSERT_EQ(blob_size, length);
+        ION_ASSERT_OK(ion_reader_read_lob_partial_bytes(reader, &first, 1, &length));
+        ASSERT_EQ((BYTE)i, first);
+    }
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_step_out(reader));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_close(reader));
+    ION_ASSERT_OK(ion_stream_close(stream));
+    fclose(out);
+}
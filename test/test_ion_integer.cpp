@@ -126,3 +126,64 @@ TEST(IonInteger, IIntToInt64Overflow) {
         ASSERT_EQ(error_value, IERR_NUMERIC_OVERFLOW);
     }
 }
+
+TEST(IonInteger, TextInt64RoundTrip) {
+    // Exercises both the text writer's int64 formatting and the reader's 8-digits-at-a-time parsing,
+    // across every digit count and at the int64_t limits.
+    int64_t values[] = {
+            MIN_INT64, MAX_INT64, MIN_INT64 + 1, MAX_INT64 - 1,
+            -1000000000000000000, 999999999999999999, 12345678, -87654321, 100000000,
+            -9, 9, 10, -10, 99, 100, 0
+    };
+    const size_t number_of_values = sizeof(values) / sizeof(values[0]);
+    hWRITER writer = NULL;
+    ION_STREAM *ion_stream = NULL;
+    hREADER reader = NULL;
+    BYTE *result;
+    SIZE result_len;
+    ION_TYPE type;
+    int64_t value_out;
+
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &ion_stream, FALSE));
+    for (size_t m = 0; m < number_of_values; m++) {
+        ION_ASSERT_OK(ion_writer_write_int64(writer, values[m]));
+    }
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, ion_stream, &result, &result_len));
+
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, result, result_len, NULL));
+    for (size_t m = 0; m < number_of_values; m++) {
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_INT, type);
+        ION_ASSERT_OK(ion_reader_read_int64(reader, &value_out));
+        ASSERT_EQ(values[m], value_out);
+    }
+    ION_ASSERT_OK(ion_reader_close(reader));
+    free(result);
+}
+
+TEST(IonInteger, TextInt64ReadOverflow) {
+    const char *ion_text = "0 9223372036854775807 9223372036854775808 -9223372036854775809 18446744073709551616";
+    hREADER reader = NULL;
+    ION_TYPE type;
+    int64_t value_out;
+    ION_INT *iint = NULL;
+
+    ION_ASSERT_OK(ion_test_new_text_reader(ion_text, &reader));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_read_int64(reader, &value_out));
+    ASSERT_EQ(0, value_out);
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_read_int64(reader, &value_out));
+    ASSERT_EQ(MAX_INT64, value_out);
+
+    // Values that don't fit in an int64_t are rejected, but can still be read as an ION_INT.
+    ION_ASSERT_OK(ion_int_alloc(NULL, &iint));
+    for (int m = 0; m < 3; m++) {
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(IERR_NUMERIC_OVERFLOW, ion_reader_read_int64(reader, &value_out));
+        ION_ASSERT_OK(ion_reader_read_ion_int(reader, iint));
+        ASSERT_EQ(IERR_NUMERIC_OVERFLOW, ion_int_to_int64(iint, &value_out));
+    }
+    ion_int_free(iint);
+    ION_ASSERT_OK(ion_reader_close(reader));
+}
@@ -768,3 +768,108 @@ TEST_P(TextAndBinary, ReaderPopulatesStructFieldsOnSeek) {
     free(cread_val1);
     free(cread_val2);
 }
+
+TEST_P(TextAndBinary, ResetBufferReusesTheReader) {
+    hWRITER writer = NULL;
+    hREADER reader = NULL;
+    ION_TYPE type;
+    ION_STREAM *ion_stream = NULL;
+    ION_STRING field_written, value_written, field_read, value_read;
+    ION_MEMORY_STATS settled, stats;
+    BYTE *data;
+    SIZE data_length;
+    BYTE other_kind[] = "other::{x:1}";
+    BYTE other_kind_binary[] = {0xE0, 0x01, 0x00, 0xEA, 0x20};
+
+    ion_string_from_cstr("field", &field_written);
+    ion_string_from_cstr("value", &value_written);
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &ion_stream, is_binary));
+    ION_ASSERT_OK(ion_writer_start_container(writer, tid_STRUCT));
+    ION_ASSERT_OK(ion_writer_write_field_name(writer, &field_written));
+    ION_ASSERT_OK(ion_writer_write_symbol(writer, &value_written));
+    ION_ASSERT_OK(ion_writer_finish_container(writer));
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, ion_stream, &data, &data_length));
+
+    ION_ASSERT_OK(ion_test_new_reader(data, data_length, &reader));
+    for (int i = 0; i < 100; i++) {
+        if (i > 0) {
+            ION_ASSERT_OK(ion_reader_reset_buffer(reader, data, data_length));
+        }
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_STRUCT, type);
+        ION_ASSERT_OK(ion_reader_step_in(reader));
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_SYMBOL, type);
+        ION_ASSERT_OK(ion_reader_get_field_name(reader, &field_read));
+        ION_ASSERT_OK(ion_reader_read_string(reader, &value_read));
+        ASSERT_TRUE(ION_STRING_EQUALS(&field_written, &field_read));
+        ASSERT_TRUE(ION_STRING_EQUALS(&value_written, &value_read));
+        ION_ASSERT_OK(ion_reader_step_out(reader));
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_EOF, type);
+
+        // After the first few messages have warmed it up, the reader allocates nothing more.
+        ION_ASSERT_OK(ion_reader_get_memory_stats(reader, &stats));
+        if (i == 2) {
+            settled = stats;
+        }
+        else if (i > 2) {
+            ASSERT_EQ(settled.block_count, stats.block_count);
+            ASSERT_EQ(settled.bytes_used, stats.bytes_used);
+        }
+    }
+
+    // A shared table added to the reader's catalog survives the change of kind below, and more can be added after.
+    hCATALOG catalog;
+    hSYMTAB shared, found;
+    ION_STRING shared_name, symbol_text;
+    SID symbol_sid;
+    ion_string_from_cstr("shared", &shared_name);
+    ion_string_from_cstr("sym", &symbol_text);
+    ION_ASSERT_OK(ion_reader_get_catalog(reader, &catalog));
+    ION_ASSERT_OK(ion_symbol_table_open_with_type(&shared, NULL, ist_SHARED));
+    ION_ASSERT_OK(ion_symbol_table_set_name(shared, &shared_name));
+    ION_ASSERT_OK(ion_symbol_table_set_version(shared, 1));
+    ION_ASSERT_OK(ion_symbol_table_add_symbol(shared, &symbol_text, &symbol_sid));
+    ION_ASSERT_OK(ion_catalog_add_symbol_table(catalog, shared));
+    ION_ASSERT_OK(ion_symbol_table_close(shared));
+
+    // The next input may be of the other kind.
+    if (is_binary) {
+        ION_ASSERT_OK(ion_reader_reset_buffer(reader, other_kind, (SIZE)strlen((char *)other_kind)));
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_STRUCT, type);
+    }
+    else {
+        ION_ASSERT_OK(ion_reader_reset_buffer(reader, other_kind_binary, sizeof(other_kind_binary)));
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_INT, type);
+    }
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+
+    // The second table is large enough to overwrite any of the reader's memory that the reset released.
+    ION_ASSERT_OK(ion_symbol_table_open_with_type(&shared, NULL, ist_SHARED));
+    ION_ASSERT_OK(ion_symbol_table_set_name(shared, &shared_name));
+    ION_ASSERT_OK(ion_symbol_table_set_version(shared, 2));
+    for (int i = 0; i < 2000; i++) {
+        char text[16];
+        snprintf(text, sizeof(text), "sym%d", i);
+        ion_string_from_cstr(text, &symbol_text);
+        ION_ASSERT_OK(ion_symbol_table_add_symbol(shared, &symbol_text, &symbol_sid));
+    }
+    ION_ASSERT_OK(ion_catalog_add_symbol_table(catalog, shared));
+    ION_ASSERT_OK(ion_symbol_table_close(shared));
+    int32_t count, found_version;
+    ION_ASSERT_OK(ion_catalog_get_symbol_table_count(catalog, &count));
+    ASSERT_EQ(2, count);
+    for (int version = 1; version <= 2; version++) {
+        ION_ASSERT_OK(ion_catalog_find_symbol_table(catalog, &shared_name, version, &found));
+        ASSERT_TRUE(found != NULL);
+        ION_ASSERT_OK(ion_symbol_table_get_version(found, &found_version));
+        ASSERT_EQ(version, found_version);
+    }
+    ION_ASSERT_OK(ion_reader_close(reader));
+
+    free(data);
+}
@@ -57,7 +57,7 @@ iERR ion_test_new_paged_input_stream(ION_STREAM **p_stream, _test_in_memory_page
 
     if (!p_stream) FAILWITH(IERR_INVALID_ARG);
 
-    IONCHECK(_ion_stream_open_helper(flags, context->page_size, &stream));
+    IONCHECK(_ion_stream_open_helper(flags, context->page_size, NULL, &stream));
 
     user_stream = &(((ION_STREAM_USER_PAGED *)stream)->_user_stream);
 
@@ -332,3 +332,63 @@ TEST(IonStream, SeekOnUserStreamReadsAllData) {
 
     ion_reader_close(reader);
 }
+
+static int_fast8_t _test_index_compare_ints(void *key1, void *key2, void *context) {
+    int32_t lhs = *(int32_t *)key1, rhs = *(int32_t *)key2;
+    return (lhs == rhs) ? 0 : ((lhs > rhs) ? 1 : -1);
+}
+
+static int_fast32_t _test_index_hash_ints_poorly(void *key, void *context) {
+    // Only 64 distinct hashes (one of them 0), forcing long, overlapping probe sequences.
+    return *(int32_t *)key % 64;
+}
+
+TEST(IonStream, IndexFindsKeysAcrossGrowthAndDeletes) {
+    const int32_t key_count = 2000;
+    int32_t keys[key_count];
+    void *data;
+    ION_INDEX index;
+    ION_INDEX_OPTIONS options;
+    void *owner = ion_alloc_owner(sizeof(int));
+
+    memset(&options, 0, sizeof(options));
+    options._memory_owner = owner;
+    options._compare_fn = _test_index_compare_ints;
+    options._hash_fn = _test_index_hash_ints_poorly;
+    ION_ASSERT_OK(_ion_index_initialize(&index, &options));
+
+    for (int32_t i = 0; i < key_count; i++) {
+        keys[i] = i;
+        ION_ASSERT_OK(_ion_index_insert(&index, &keys[i], &keys[i]));
+    }
+    ASSERT_EQ(IERR_KEY_ALREADY_EXISTS, _ion_index_insert(&index, &keys[7], &keys[8]));
+    ASSERT_EQ(key_count, ION_INDEX_SIZE(&index));
+
+    // Remove every third key, then make sure the others are still reachable past the holes.
+    for (int32_t i = 0; i < key_count; i += 3) {
+        _ion_index_delete(&index, &keys[i], &data);
+        ASSERT_EQ(&keys[i], data);
+    }
+    for (int32_t i = 0; i < key_count; i++) {
+        int32_t probe = i;
+        if (i % 3 == 0) {
+            ASSERT_FALSE(_ion_index_exists(&index, &probe));
+        }
+        else {
+            ASSERT_EQ(&keys[i], _ion_index_find(&index, &probe));
+        }
+    }
+
+    int32_t missing = key_count;
+    _ion_index_delete(&index, &missing, &data);
+    ASSERT_TRUE(data == NULL);
+
+    ION_ASSERT_OK(_ion_index_upsert(&index, &keys[1], &keys[2]));
+    ASSERT_EQ(&keys[2], _ion_index_find(&index, &keys[1]));
+
+    _ion_index_reset(&index);
+    ASSERT_TRUE(ION_INDEX_IS_EMPTY(&index));
+    ASSERT_TRUE(_ion_index_find(&index, &keys[1]) == NULL);
+
+    ion_free_owner(owner);
+}
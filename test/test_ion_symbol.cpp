@@ -14,9 +14,13 @@
 
 #include "ion_assert.h"
 #include "ion_helpers.h"
+#include "ion_catalog_impl.h"
 #include "ion_test_util.h"
 #include "ion_event_util.h"
 #include "ion_event_equivalence.h"
+#include <string>
+#include <thread>
+#include <vector>
 
 // Creates a BinaryAndTextTest fixture instantiation for IonSymbolTable tests. This allows tests to be declared with
 // the BinaryAndTextTest fixture and receive the is_binary flag with both the TRUE and FALSE values.
@@ -205,6 +209,72 @@ TEST(IonSymbolTable, AppendingAfterIVMDoesNothing) {
     ));
 }
 
+// Reads every top-level symbol, recording its text and the reader's symbol table at the time.
+static void read_symbols_with_tables(BYTE *data, SIZE data_size, SIZE cache_size, std::vector<std::string> *texts, std::vector<hSYMTAB> *tables) {
+    ION_READER_OPTIONS reader_options;
+    hREADER reader;
+    ION_TYPE type;
+    ION_STRING value;
+    hSYMTAB symtab;
+
+    ion_event_initialize_reader_options(&reader_options);
+    reader_options.symbol_table_cache_size = cache_size;
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, data, data_size, &reader_options));
+    for (;;) {
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        if (type == tid_EOF) break;
+        ION_ASSERT_OK(ion_reader_read_string(reader, &value));
+        ION_ASSERT_OK(ion_reader_get_symbol_table(reader, &symtab));
+        texts->push_back(std::string((char *)value.value, (size_t)value.length));
+        tables->push_back(symtab);
+    }
+    ION_ASSERT_OK(ion_reader_close(reader));
+}
+
+TEST(IonSymbolTable, ReaderReusesRepeatedLocalSymbolTables) {
+    // Each chunk: IVM $ion_symbol_table::{symbols:["a","b"]} $10 $11 $ion_symbol_table::{imports:$ion_symbol_table, symbols:["c"]} $12 $10
+    const char binary_chunk[] = "\xE0\x01\x00\xEA"
+                               "\xE9\x81\x83\xD6\x87\xB4\x81" "a" "\x81" "b"
+                               "\x71\x0A\x71\x0B"
+                               "\xEA\x81\x83\xD7\x86\x71\x03\x87\xB2\x81" "c"
+                               "\x71\x0C\x71\x0A";
+    const SIZE binary_chunk_size = sizeof(binary_chunk) - 1;
+    const char *text_chunk = "$ion_symbol_table::{symbols:[\"a\", \"b\"]} $10 $11 "
+                             "$ion_symbol_table::{imports:$ion_symbol_table, symbols:[\"c\"]} $12 $10 ";
+    const char *expected[] = {"a", "b", "c", "a"};
+    const size_t per_chunk = sizeof(expected) / sizeof(expected[0]);
+    const int chunk_count = 3;
+
+    for (int is_binary = 0; is_binary < 2; is_binary++) {
+        std::string data;
+        for (int i = 0; i < chunk_count; i++) {
+            data += is_binary ? std::string(binary_chunk, binary_chunk_size) : std::string(text_chunk);
+        }
+        for (SIZE cache_size = -1; cache_size <= 1; cache_size += 2) {
+            std::vector<std::string> texts;
+            std::vector<hSYMTAB> tables;
+            read_symbols_with_tables((BYTE *)data.c_str(), (SIZE)data.length(), cache_size, &texts, &tables);
+            ASSERT_EQ(per_chunk * chunk_count, texts.size());
+            for (size_t i = 0; i < texts.size(); i++) {
+                ASSERT_EQ(expected[i % per_chunk], texts[i]) << "binary " << is_binary << " cache " << cache_size << " value " << i;
+            }
+            if (cache_size > 0) {
+                // The second table can't be cached along with the first in a cache of one, so each chunk rebuilds it.
+                // The first one is still current when the second is read, so it survives to be reused.
+                ASSERT_EQ(tables[0], tables[per_chunk]);
+                ASSERT_EQ(tables[0], tables[2 * per_chunk + 1]);
+            }
+        }
+        std::vector<std::string> texts;
+        std::vector<hSYMTAB> tables;
+        read_symbols_with_tables((BYTE *)data.c_str(), (SIZE)data.length(), 0, &texts, &tables);
+        for (int i = 1; i < chunk_count; i++) {
+            ASSERT_EQ(tables[0], tables[i * per_chunk]) << "binary " << is_binary;
+            ASSERT_EQ(tables[2], tables[i * per_chunk + 2]) << "binary " << is_binary;
+        }
+    }
+}
+
 TEST(IonSymbolTable, AppendingNoSymbolsDoesNotWriteSymbolTable) {
     // If, after flush, there are no additional local symbols, there is no need to write another LST.
     hWRITER writer;
@@ -240,6 +310,59 @@ TEST(IonSymbolTable, AppendingNoSymbolsDoesNotWriteSymbolTable) {
     ));
 }
 
+TEST(IonSymbolTable, WriterRotatesLocalSymbolTableWhenLimitExceeded) {
+    hWRITER writer;
+    ION_STREAM *stream;
+    ION_WRITER_OPTIONS writer_options;
+    ION_STRING a, b, c, d, e, f, g;
+    int64_t symbols_added, rotations;
+
+    BYTE *written_bytes = NULL;
+    SIZE written_len = 0;
+
+    ION_ASSERT_OK(ion_string_from_cstr("a", &a));
+    ION_ASSERT_OK(ion_string_from_cstr("b", &b));
+    ION_ASSERT_OK(ion_string_from_cstr("c", &c));
+    ION_ASSERT_OK(ion_string_from_cstr("d", &d));
+    ION_ASSERT_OK(ion_string_from_cstr("e", &e));
+    ION_ASSERT_OK(ion_string_from_cstr("f", &f));
+    ION_ASSERT_OK(ion_string_from_cstr("g", &g));
+
+    memset(&writer_options, 0, sizeof(ION_WRITER_OPTIONS));
+    writer_options.output_as_binary = TRUE;
+    writer_options.max_local_symbol_count = 2;
+    ION_ASSERT_OK(ion_stream_open_memory_only(&stream));
+    ION_ASSERT_OK(ion_writer_open(&writer, stream, &writer_options));
+
+    ION_ASSERT_OK(ion_writer_write_symbol(writer, &a));
+    ION_ASSERT_OK(ion_writer_write_symbol(writer, &b));
+    ION_ASSERT_OK(ion_writer_write_symbol(writer, &c));
+    ION_ASSERT_OK(ion_writer_get_local_symbol_stats(writer, &symbols_added, &rotations));
+    ASSERT_EQ(3, symbols_added);
+    ASSERT_EQ(0, rotations); // Rotation waits for the next top-level value.
+
+    // The limit was exceeded, so the struct begins a fresh context, and its symbols stay within it.
+    ION_ASSERT_OK(ion_writer_start_container(writer, tid_STRUCT));
+    ION_ASSERT_OK(ion_writer_write_field_name(writer, &d));
+    ION_ASSERT_OK(ion_writer_write_symbol(writer, &e));
+    ION_ASSERT_OK(ion_writer_finish_container(writer));
+    ION_ASSERT_OK(ion_writer_add_annotation(writer, &f));
+    ION_ASSERT_OK(ion_writer_write_symbol(writer, &g));
+    ION_ASSERT_OK(ion_writer_write_symbol(writer, &a));
+    ION_ASSERT_OK(ion_writer_get_local_symbol_stats(writer, &symbols_added, &rotations));
+    ASSERT_EQ(8, symbols_added);
+    ASSERT_EQ(2, rotations);
+
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, &written_bytes, &written_len));
+
+    ASSERT_NO_FATAL_FAILURE(rewrite_and_assert_text_eq(
+             written_bytes,
+             written_len,
+             "a b c {d:e} f::g a"
+    ));
+    free(written_bytes);
+}
+
 TEST(IonSymbolTable, SharedSymbolTableCanBelongToMultipleCatalogs) {
     const char *ion_text_1 = "$ion_symbol_table::{imports:[{name:'''foo''', version: 1, max_id: 2}]} $10 $11";
     const char *ion_text_2 = "$ion_symbol_table::{imports:[{name:'''bar''', version: 1, max_id: 10}, {name:'''foo''', version: 1, max_id: 2}]} $20 $21";
@@ -1202,6 +1325,207 @@ TEST(IonSymbolTable, SettingSharedSymbolTableMaxIdLargerThanLengthOfSymbolsExten
     ION_ASSERT_OK(ion_catalog_close(catalog));
 }
 
+TEST(IonSymbolTable, LockedLocalTableResolvesImportedSidsDirectly) {
+    // import1 (declared max_id 3, one known symbol) occupies SIDs 10-12, an import missing from the catalog occupies
+    // 13-14, import2 occupies 15-16, and the local symbol gets SID 17.
+    hCATALOG catalog = NULL;
+    ION_SYMBOL_TABLE *imports[2] = {NULL, NULL};
+    ION_SYMBOL_TABLE_IMPORT_DESCRIPTOR import1, missing, import2;
+    hSYMTAB symtab;
+    ION_STRING local_name;
+    ION_SYMBOL *sym, *again;
+    SID sid, max_id;
+    BOOL is_locked;
+    ASSERT_NO_FATAL_FAILURE(populate_catalog(&catalog, imports));
+
+    ION_ASSERT_OK(ion_string_from_cstr("import1", &import1.name));
+    import1.version = 1;
+    import1.max_id = 3;
+    ION_ASSERT_OK(ion_string_from_cstr("missing", &missing.name));
+    missing.version = 1;
+    missing.max_id = 2;
+    ION_ASSERT_OK(ion_string_from_cstr("import2", &import2.name));
+    import2.version = 1;
+    import2.max_id = 2;
+
+    ION_ASSERT_OK(ion_symbol_table_open(&symtab, NULL));
+    ION_ASSERT_OK(ion_symbol_table_add_import(symtab, &import1, catalog));
+    ION_ASSERT_OK(ion_symbol_table_add_import(symtab, &missing, catalog));
+    ION_ASSERT_OK(ion_symbol_table_add_import(symtab, &import2, catalog));
+    ION_ASSERT_OK(ion_string_from_cstr("local", &local_name));
+    ION_ASSERT_OK(ion_symbol_table_add_symbol(symtab, &local_name, &sid));
+    ASSERT_EQ(17, sid);
+    ION_ASSERT_OK(ion_symbol_table_lock(symtab));
+    ION_ASSERT_OK(ion_symbol_table_is_locked(symtab, &is_locked));
+    ASSERT_TRUE(is_locked);
+    ION_ASSERT_OK(ion_symbol_table_get_max_sid(symtab, &max_id));
+    ASSERT_EQ(17, max_id);
+
+    ION_ASSERT_OK(ion_symbol_table_get_symbol(symtab, ION_SYS_SID_SYMBOL_TABLE, &sym));
+    assertStringsEqual("$ion_symbol_table", (char *)sym->value.value, sym->value.length);
+
+    ION_ASSERT_OK(ion_symbol_table_get_symbol(symtab, 10, &sym));
+    assertStringsEqual("sym1", (char *)sym->value.value, sym->value.length);
+    assertStringsEqual("import1", (char *)sym->import_location.name.value, sym->import_location.name.length);
+    ASSERT_EQ(1, sym->import_location.location);
+
+    // Unknown text beyond the end of import1, and throughout the missing import.
+    ION_ASSERT_OK(ion_symbol_table_get_symbol(symtab, 12, &sym));
+    ASSERT_TRUE(ION_STRING_IS_NULL(&sym->value));
+    assertStringsEqual("import1", (char *)sym->import_location.name.value, sym->import_location.name.length);
+    ASSERT_EQ(3, sym->import_location.location);
+    ION_ASSERT_OK(ion_symbol_table_get_symbol(symtab, 14, &sym));
+    ASSERT_TRUE(ION_STRING_IS_NULL(&sym->value));
+    assertStringsEqual("missing", (char *)sym->import_location.name.value, sym->import_location.name.length);
+    ASSERT_EQ(2, sym->import_location.location);
+    // The unknown-text symbol is materialized once, not on every lookup.
+    ION_ASSERT_OK(ion_symbol_table_get_symbol(symtab, 14, &again));
+    ASSERT_EQ(sym, again);
+
+    ION_ASSERT_OK(ion_symbol_table_get_symbol(symtab, 16, &sym));
+    assertStringsEqual("sym3", (char *)sym->value.value, sym->value.length);
+    assertStringsEqual("import2", (char *)sym->import_location.name.value, sym->import_location.name.length);
+    ASSERT_EQ(2, sym->import_location.location);
+
+    ION_ASSERT_OK(ion_symbol_table_get_symbol(symtab, 17, &sym));
+    assertStringsEqual("local", (char *)sym->value.value, sym->value.length);
+    ASSERT_TRUE(ION_STRING_IS_NULL(&sym->import_location.name));
+
+    ION_ASSERT_OK(ion_symbol_table_close(symtab));
+    ION_ASSERT_OK(ion_catalog_close(catalog));
+}
+
+TEST(IonSymbolTable, LockedLocalTableResolvesSparselyDeclaredImports) {
+    // A missing import declaring a large max_id is mostly unknown text, so it is resolved without a flattened view.
+    hCATALOG catalog = NULL;
+    ION_SYMBOL_TABLE *imports[2] = {NULL, NULL};
+    ION_SYMBOL_TABLE_IMPORT_DESCRIPTOR import1, missing;
+    hSYMTAB symtab, clone;
+    ION_STRING local_name;
+    ION_SYMBOL *sym;
+    SID sid;
+    ASSERT_NO_FATAL_FAILURE(populate_catalog(&catalog, imports));
+
+    ION_ASSERT_OK(ion_string_from_cstr("import1", &import1.name));
+    import1.version = 1;
+    import1.max_id = 1;
+    ION_ASSERT_OK(ion_string_from_cstr("missing", &missing.name));
+    missing.version = 1;
+    missing.max_id = 500000;
+
+    ION_ASSERT_OK(ion_symbol_table_open(&symtab, NULL));
+    ION_ASSERT_OK(ion_symbol_table_add_import(symtab, &import1, catalog));
+    ION_ASSERT_OK(ion_symbol_table_add_import(symtab, &missing, catalog));
+    ION_ASSERT_OK(ion_string_from_cstr("local", &local_name));
+    ION_ASSERT_OK(ion_symbol_table_add_symbol(symtab, &local_name, &sid));
+    ASSERT_EQ(500011, sid);
+    ION_ASSERT_OK(ion_symbol_table_lock(symtab));
+    ION_ASSERT_OK(ion_symbol_table_clone_with_owner(symtab, &clone, symtab));
+
+    ION_ASSERT_OK(ion_symbol_table_get_symbol(clone, 10, &sym));
+    assertStringsEqual("sym1", (char *)sym->value.value, sym->value.length);
+    ION_ASSERT_OK(ion_symbol_table_get_symbol(clone, 250000, &sym));
+    ASSERT_TRUE(ION_STRING_IS_NULL(&sym->value));
+    assertStringsEqual("missing", (char *)sym->import_location.name.value, sym->import_location.name.length);
+    ASSERT_EQ(249990, sym->import_location.location);
+    ION_ASSERT_OK(ion_symbol_table_get_symbol(symtab, 500011, &sym));
+    assertStringsEqual("local", (char *)sym->value.value, sym->value.length);
+
+    ION_ASSERT_OK(ion_symbol_table_close(symtab));
+    ION_ASSERT_OK(ion_catalog_close(catalog));
+}
+
+TEST(IonSymbolTable, AddingAnImportReconsidersADeclinedFlattening) {
+    // SIDs 10-39 belong to an import missing from the catalog: too sparse to flatten, so each lookup of one of them
+    // takes the import walk. Importing a 100-symbol table afterwards makes the range dense enough to flatten.
+    hCATALOG catalog = NULL;
+    ION_SYMBOL_TABLE *imports[2] = {NULL, NULL};
+    ION_SYMBOL_TABLE_IMPORT_DESCRIPTOR missing, large;
+    hSYMTAB symtab, large_table;
+    ION_STRING large_name, text;
+    ION_SYMBOL *sym, *again;
+    SID sid;
+    char buf[16];
+    ASSERT_NO_FATAL_FAILURE(populate_catalog(&catalog, imports));
+
+    ION_ASSERT_OK(ion_string_from_cstr("large", &large_name));
+    ION_ASSERT_OK(ion_symbol_table_open_with_type(&large_table, catalog, ist_SHARED));
+    ION_ASSERT_OK(ion_symbol_table_set_name(large_table, &large_name));
+    ION_ASSERT_OK(ion_symbol_table_set_version(large_table, 1));
+    for (int i = 0; i < 100; i++) {
+        snprintf(buf, sizeof(buf), "large%d", i);
+        ION_ASSERT_OK(ion_string_from_cstr(buf, &text));
+        ION_ASSERT_OK(ion_symbol_table_add_symbol(large_table, &text, &sid));
+    }
+    ION_ASSERT_OK(ion_catalog_add_symbol_table(catalog, large_table));
+
+    ION_ASSERT_OK(ion_string_from_cstr("missing", &missing.name));
+    missing.version = 1;
+    missing.max_id = 30;
+    ION_ASSERT_OK(ion_string_from_cstr("large", &large.name));
+    large.version = 1;
+    large.max_id = 100;
+
+    ION_ASSERT_OK(ion_symbol_table_open(&symtab, NULL));
+    ION_ASSERT_OK(ion_symbol_table_add_import(symtab, &missing, catalog));
+    ION_ASSERT_OK(ion_symbol_table_get_symbol(symtab, 20, &sym));
+    ION_ASSERT_OK(ion_symbol_table_get_symbol(symtab, 20, &again));
+    ASSERT_TRUE(ION_STRING_IS_NULL(&sym->value));
+    ASSERT_NE(sym, again);  // materialized by the import walk on every lookup
+
+    ION_ASSERT_OK(ion_symbol_table_add_import(symtab, &large, catalog));
+    ION_ASSERT_OK(ion_symbol_table_get_symbol(symtab, 20, &sym));
+    ION_ASSERT_OK(ion_symbol_table_get_symbol(symtab, 20, &again));
+    ASSERT_TRUE(ION_STRING_IS_NULL(&sym->value));
+    ASSERT_EQ(sym, again);  // materialized once, in the flattened view
+    ION_ASSERT_OK(ion_symbol_table_get_symbol(symtab, 139, &sym));
+    assertStringsEqual("large99", (char *)sym->value.value, sym->value.length);
+
+    ION_ASSERT_OK(ion_symbol_table_close(symtab));
+    ION_ASSERT_OK(ion_catalog_close(catalog));
+}
+
+TEST(IonSymbolTable, LargeTableFindsSymbolsOfAllLengthsByName) {
+    // Names from 0 to 40 bytes long sharing long common prefixes, so they differ only in their final bytes.
+    const int symbol_count = 5000;
+    const char *prefix = "a_fairly_long_common_symbol_prefix_";
+    char buffer[64];
+    ION_STRING name;
+    hSYMTAB symtab, clone;
+    SID sid, found;
+
+    ION_ASSERT_OK(ion_symbol_table_open(&symtab, NULL));
+    for (int i = 0; i < symbol_count; i++) {
+        int prefix_length = i % 36;
+        memcpy(buffer, prefix, prefix_length);
+        snprintf(buffer + prefix_length, sizeof(buffer) - prefix_length, "%d", i);
+        ION_ASSERT_OK(ion_string_from_cstr(buffer, &name));
+        ION_ASSERT_OK(ion_symbol_table_add_symbol(symtab, &name, &sid));
+        ASSERT_EQ(10 + i, sid);
+    }
+    ION_ASSERT_OK(ion_symbol_table_clone(symtab, &clone));
+
+    for (int i = 0; i < symbol_count; i++) {
+        int prefix_length = i % 36;
+        memcpy(buffer, prefix, prefix_length);
+        snprintf(buffer + prefix_length, sizeof(buffer) - prefix_length, "%d", i);
+        ION_ASSERT_OK(ion_string_from_cstr(buffer, &name));
+        ION_ASSERT_OK(ion_symbol_table_find_by_name(symtab, &name, &found));
+        ASSERT_EQ(10 + i, found);
+        ION_ASSERT_OK(ion_symbol_table_find_by_name(clone, &name, &found));
+        ASSERT_EQ(10 + i, found);
+        // Re-adding returns the existing SID.
+        ION_ASSERT_OK(ion_symbol_table_add_symbol(symtab, &name, &sid));
+        ASSERT_EQ(found, sid);
+    }
+    ION_ASSERT_OK(ion_string_from_cstr("a_fairly_long_common_symbol_prefix_", &name));
+    ION_ASSERT_OK(ion_symbol_table_find_by_name(symtab, &name, &found));
+    ASSERT_EQ(UNKNOWN_SID, found);
+
+    ION_ASSERT_OK(ion_symbol_table_close(clone));
+    ION_ASSERT_OK(ion_symbol_table_close(symtab));
+}
+
 TEST_P(BinaryAndTextTest, WriterWithImportsListIncludesThoseImportsWithEveryNewLSTContext) {
     // A writer that was constructed with a list of shared imports to use must include those imports in each new local
     // symbol table context.
@@ -2006,6 +2330,315 @@ TEST_P(BinaryAndTextTest, ReaderSkipsOverIVMBoundary) {
     free(data);
 }
 
+TEST(IonSymbolTable, CatalogResolvesExactAndBestMatchVersions) {
+    // Versions are added out of order; a second name shares the catalog to make sure names don't bleed together.
+    const int32_t added_versions[] = {4, 1, 9, 6};
+    hCATALOG catalog = NULL;
+    hSYMTAB symtab, other, found;
+    ION_STRING name, other_name, result_name;
+    int32_t version;
+
+    ION_ASSERT_OK(ion_catalog_open(&catalog));
+    ION_ASSERT_OK(ion_string_from_cstr("versioned", &name));
+    ION_ASSERT_OK(ion_string_from_cstr("versioned_too", &other_name));
+    for (size_t i = 0; i < sizeof(added_versions) / sizeof(added_versions[0]); i++) {
+        ION_ASSERT_OK(ion_symbol_table_open_with_type(&symtab, catalog, ist_SHARED));
+        ION_ASSERT_OK(ion_symbol_table_set_name(symtab, &name));
+        ION_ASSERT_OK(ion_symbol_table_set_version(symtab, added_versions[i]));
+        ION_ASSERT_OK(ion_catalog_add_symbol_table(catalog, symtab));
+    }
+    ION_ASSERT_OK(ion_symbol_table_open_with_type(&other, catalog, ist_SHARED));
+    ION_ASSERT_OK(ion_symbol_table_set_name(other, &other_name));
+    ION_ASSERT_OK(ion_symbol_table_set_version(other, 5));
+    ION_ASSERT_OK(ion_catalog_add_symbol_table(catalog, other));
+
+    ION_ASSERT_OK(ion_catalog_find_symbol_table(catalog, &name, 6, &found));
+    ASSERT_TRUE(found != NULL);
+    ION_ASSERT_OK(ion_symbol_table_get_version(found, &version));
+    ASSERT_EQ(6, version);
+    ION_ASSERT_OK(ion_catalog_find_symbol_table(catalog, &name, 5, &found));
+    ASSERT_TRUE(found == NULL);
+    ION_ASSERT_OK(ion_catalog_find_symbol_table(catalog, &other_name, 5, &found));
+    ASSERT_EQ(other, found);
+
+    // exact, then the lowest version above the one requested, then the highest available. Inexact matches are only
+    // allowed for imports that declare a max_id.
+    const int32_t requested[] = {9, 5, 2, 7, 10, 0};
+    const int32_t expected[] = {9, 6, 4, 9, 9, 9};
+    for (size_t i = 0; i < sizeof(requested) / sizeof(requested[0]); i++) {
+        ION_ASSERT_OK(_ion_catalog_find_best_match_helper(catalog, &name, requested[i], 10, &found));
+        ASSERT_TRUE(found != NULL);
+        ION_ASSERT_OK(ion_symbol_table_get_version(found, &version));
+        ASSERT_EQ(expected[i], version) << "requested version " << requested[i];
+        ION_ASSERT_OK(ion_symbol_table_get_name(found, &result_name));
+        ASSERT_TRUE(ION_STRING_EQUALS(&name, &result_name));
+    }
+
+    ION_ASSERT_OK(ion_catalog_find_symbol_table(catalog, &name, 9, &found));
+    ION_ASSERT_OK(ion_catalog_release_symbol_table(catalog, found));
+    ION_ASSERT_OK(ion_catalog_find_symbol_table(catalog, &name, 9, &found));
+    ASSERT_TRUE(found == NULL);
+    ION_ASSERT_OK(ion_catalog_find_best_match(catalog, &name, 0, &found));
+    ION_ASSERT_OK(ion_symbol_table_get_version(found, &version));
+    ASSERT_EQ(6, version);
+    ASSERT_EQ(IERR_INVALID_SYMBOL_TABLE, ion_catalog_find_best_match(catalog, &name, 5, &found));
+
+    ION_ASSERT_OK(ion_catalog_close(catalog));
+}
+
+// Reads three symbols declared by the imports in populate_catalog; returns the number that didn't resolve as expected.
+static int read_symbols_imported_from(hCATALOG catalog, int iterations) {
+    const char *ion_text = "$ion_symbol_table::{imports:[{name:\"import1\", version:1, max_id:1},"
+                                                        "{name:\"import2\", version:1, max_id:2}]} $10 $11 $12";
+    const char *expected[] = {"sym1", "sym2", "sym3"};
+    int mismatches = 0;
+    ION_READER_OPTIONS reader_options;
+    hREADER reader;
+    ION_TYPE type;
+    ION_STRING value;
+
+    for (int i = 0; i < iterations; i++) {
+        ion_event_initialize_reader_options(&reader_options);
+        reader_options.pcatalog = catalog;
+        if (ion_reader_open_buffer(&reader, (BYTE *)ion_text, (SIZE)strlen(ion_text), &reader_options)) return -1;
+        for (int j = 0; j < 3; j++) {
+            if (ion_reader_next(reader, &type) || type != tid_SYMBOL
+                || ion_reader_read_string(reader, &value)
+                || value.length != (int32_t)strlen(expected[j])
+                || memcmp(value.value, expected[j], value.length)) {
+                mismatches++;
+            }
+        }
+        if (ion_reader_close(reader)) return -1;
+    }
+    return mismatches;
+}
+
+TEST(IonSymbolTable, FrozenCatalogIsSharedAcrossThreads) {
+    hCATALOG catalog = NULL, successor = NULL;
+    ION_SYMBOL_TABLE *imports[2];
+    hSYMTAB extra, found;
+    ION_STRING name, import_name;
+    BOOL is_frozen;
+    const int thread_count = 4;
+    std::thread threads[thread_count];
+    int results[thread_count];
+
+    populate_catalog(&catalog, imports);
+    ION_ASSERT_OK(ion_catalog_freeze(catalog));
+    ION_ASSERT_OK(ion_catalog_is_frozen(catalog, &is_frozen));
+    ASSERT_TRUE(is_frozen);
+
+    ION_ASSERT_OK(ion_string_from_cstr("extra", &name));
+    ION_ASSERT_OK(ion_symbol_table_open_with_type(&extra, NULL, ist_SHARED));
+    ION_ASSERT_OK(ion_symbol_table_set_name(extra, &name));
+    ION_ASSERT_OK(ion_symbol_table_set_version(extra, 1));
+    ASSERT_EQ(IERR_IS_IMMUTABLE, ion_catalog_add_symbol_table(catalog, extra));
+    ASSERT_EQ(IERR_IS_IMMUTABLE, ion_catalog_release_symbol_table(catalog, imports[0]));
+
+    for (int i = 0; i < thread_count; i++) {
+        threads[i] = std::thread([&results, i, catalog]() { results[i] = read_symbols_imported_from(catalog, 50); });
+    }
+    for (int i = 0; i < thread_count; i++) {
+        threads[i].join();
+        ASSERT_EQ(0, results[i]) << "thread " << i;
+    }
+
+    // The successor shares the frozen tables and takes additions; the frozen catalog is unchanged.
+    ION_ASSERT_OK(ion_catalog_open_from_frozen(&successor, catalog));
+    ION_ASSERT_OK(ion_catalog_is_frozen(successor, &is_frozen));
+    ASSERT_FALSE(is_frozen);
+    ION_ASSERT_OK(ion_symbol_table_get_name(imports[1], &import_name));
+    ION_ASSERT_OK(ion_catalog_find_symbol_table(successor, &import_name, 1, &found));
+    ASSERT_EQ((hSYMTAB)imports[1], found);
+    ION_ASSERT_OK(ion_catalog_add_symbol_table(successor, extra));
+    ION_ASSERT_OK(ion_catalog_find_symbol_table(successor, &name, 1, &found));
+    ASSERT_TRUE(found != NULL);
+    ION_ASSERT_OK(ion_catalog_find_symbol_table(catalog, &name, 1, &found));
+    ASSERT_TRUE(found == NULL);
+    ASSERT_EQ(0, read_symbols_imported_from(successor, 1));
+
+    ION_ASSERT_OK(ion_catalog_close(successor));
+    ION_ASSERT_OK(ion_symbol_table_close(extra));
+    ION_ASSERT_OK(ion_catalog_close(catalog));
+}
+
+TEST(IonSymbolTable, PrecompiledImageRoundTripsSharedTable) {
+    const char *texts[] = {"alpha", "beta", "a symbol long enough to span several words of the hash", "alpha"};
+    const size_t text_count = sizeof(texts) / sizeof(texts[0]);
+    hSYMTAB shared, image_table, hcatalog_table;
+    hCATALOG catalog;
+    ION_STRING name, text, *found_text, *expected_text;
+    SID sid, found_sid, max_id;
+    int32_t version;
+    SIZE image_length, written_length;
+    BOOL is_locked;
+
+    ION_ASSERT_OK(ion_symbol_table_open_with_type(&shared, NULL, ist_SHARED));
+    ION_ASSERT_OK(ion_string_from_cstr("imaged", &name));
+    ION_ASSERT_OK(ion_symbol_table_set_name(shared, &name));
+    ION_ASSERT_OK(ion_symbol_table_set_version(shared, 3));
+    for (size_t i = 0; i < text_count; i++) {
+        ION_ASSERT_OK(ion_string_from_cstr(texts[i], &text));
+        ION_ASSERT_OK(ion_symbol_table_add_symbol(shared, &text, &sid));
+    }
+    ASSERT_EQ(IERR_INVALID_STATE, ion_symbol_table_write_image(shared, NULL, 0, &image_length));
+    ION_ASSERT_OK(ion_symbol_table_lock(shared));
+
+    ION_ASSERT_OK(ion_symbol_table_write_image(shared, NULL, 0, &image_length));
+    std::vector<uint32_t> image((image_length + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+    ASSERT_EQ(IERR_BUFFER_TOO_SMALL, ion_symbol_table_write_image(shared, (BYTE *)&image[0], image_length - 1, &written_length));
+    ION_ASSERT_OK(ion_symbol_table_write_image(shared, (BYTE *)&image[0], image_length, &written_length));
+    ASSERT_EQ(image_length, written_length);
+
+    ION_ASSERT_OK(ion_symbol_table_open_image((BYTE *)&image[0], image_length, NULL, &image_table));
+    ION_ASSERT_OK(ion_symbol_table_is_locked(image_table, &is_locked));
+    ASSERT_TRUE(is_locked);
+    ION_ASSERT_OK(ion_symbol_table_get_name(image_table, &text));
+    ASSERT_TRUE(ION_STRING_EQUALS(&name, &text));
+    ION_ASSERT_OK(ion_symbol_table_get_version(image_table, &version));
+    ASSERT_EQ(3, version);
+    ION_ASSERT_OK(ion_symbol_table_get_max_sid(image_table, &max_id));
+    ION_ASSERT_OK(ion_symbol_table_get_max_sid(shared, &sid));
+    ASSERT_EQ(sid, max_id);
+    for (size_t i = 0; i < text_count; i++) {
+        ION_ASSERT_OK(ion_string_from_cstr(texts[i], &text));
+        ION_ASSERT_OK(ion_symbol_table_find_by_name(shared, &text, &sid));
+        ION_ASSERT_OK(ion_symbol_table_find_by_name(image_table, &text, &found_sid));
+        ASSERT_EQ(sid, found_sid) << texts[i];
+    }
+    for (sid = 1; sid <= max_id; sid++) {
+        ION_ASSERT_OK(ion_symbol_table_find_by_sid(image_table, sid, &found_text));
+        ION_ASSERT_OK(ion_symbol_table_find_by_sid(shared, sid, &expected_text));
+        ASSERT_TRUE(ION_STRING_EQUALS(expected_text, found_text)) << "sid " << sid;
+    }
+    ION_ASSERT_OK(ion_string_from_cstr("gamma", &text));
+    ASSERT_EQ(IERR_IS_IMMUTABLE, ion_symbol_table_add_symbol(image_table, &text, &sid));
+
+    // Frozen, so a catalog takes the table itself rather than a copy.
+    ION_ASSERT_OK(ion_catalog_open(&catalog));
+    ION_ASSERT_OK(ion_catalog_add_symbol_table(catalog, image_table));
+    ION_ASSERT_OK(ion_catalog_find_symbol_table(catalog, &name, 3, &hcatalog_table));
+    ASSERT_EQ(image_table, hcatalog_table);
+    ION_ASSERT_OK(ion_catalog_close(catalog));
+
+    // Damaged images are rejected rather than read out of bounds.
+    ASSERT_EQ(IERR_INVALID_SYMBOL_TABLE, ion_symbol_table_open_image((BYTE *)&image[0], image_length - 1, NULL, &image_table));
+    image[0] ^= 1;
+    ASSERT_EQ(IERR_INVALID_SYMBOL_TABLE, ion_symbol_table_open_image((BYTE *)&image[0], image_length, NULL, &image_table));
+
+    ION_ASSERT_OK(ion_symbol_table_close(hcatalog_table));
+    ION_ASSERT_OK(ion_symbol_table_close(shared));
+}
+
+TEST(IonSymbolTable, CloneOfLockedTableCopiesOnlyWhenModified) {
+    const int symbol_count = 2000;
+    hSYMTAB parent, clone;
+    ION_STRING text, *found_text;
+    SID sid, found_sid, parent_max_id, clone_max_id;
+    std::string symbol;
+
+    ION_ASSERT_OK(ion_symbol_table_open(&parent, NULL));
+    for (int i = 0; i < symbol_count; i++) {
+        symbol = "sym" + std::to_string(i);
+        ION_ASSERT_OK(ion_string_from_cstr(symbol.c_str(), &text));
+        ION_ASSERT_OK(ion_symbol_table_add_symbol(parent, &text, &sid));
+    }
+    ION_ASSERT_OK(ion_symbol_table_lock(parent));
+    ION_ASSERT_OK(ion_symbol_table_get_max_sid(parent, &parent_max_id));
+
+    // The clone starts out reading the parent's storage.
+    ION_ASSERT_OK(ion_symbol_table_clone(parent, &clone));
+    ION_ASSERT_OK(ion_symbol_table_get_max_sid(clone, &clone_max_id));
+    ASSERT_EQ(parent_max_id, clone_max_id);
+    for (int i = 0; i < symbol_count; i += 97) {
+        symbol = "sym" + std::to_string(i);
+        ION_ASSERT_OK(ion_string_from_cstr(symbol.c_str(), &text));
+        ION_ASSERT_OK(ion_symbol_table_find_by_name(parent, &text, &sid));
+        ION_ASSERT_OK(ion_symbol_table_find_by_name(clone, &text, &found_sid));
+        ASSERT_EQ(sid, found_sid) << symbol;
+        ION_ASSERT_OK(ion_symbol_table_find_by_sid(clone, sid, &found_text));
+        ASSERT_TRUE(ION_STRING_EQUALS(&text, found_text)) << symbol;
+    }
+
+    // Appending to the clone leaves the parent untouched.
+    ION_ASSERT_OK(ion_string_from_cstr("appended", &text));
+    ION_ASSERT_OK(ion_symbol_table_add_symbol(clone, &text, &sid));
+    ASSERT_EQ(parent_max_id + 1, sid);
+    ION_ASSERT_OK(ion_symbol_table_find_by_name(parent, &text, &found_sid));
+    ASSERT_EQ(UNKNOWN_SID, found_sid);
+    ION_ASSERT_OK(ion_symbol_table_get_max_sid(parent, &found_sid));
+    ASSERT_EQ(parent_max_id, found_sid);
+    for (int i = 0; i < symbol_count; i += 97) {
+        symbol = "sym" + std::to_string(i);
+        ION_ASSERT_OK(ion_string_from_cstr(symbol.c_str(), &text));
+        ION_ASSERT_OK(ion_symbol_table_find_by_name(parent, &text, &sid));
+        ION_ASSERT_OK(ion_symbol_table_find_by_name(clone, &text, &found_sid));
+        ASSERT_EQ(sid, found_sid) << symbol;
+    }
+
+    ION_ASSERT_OK(ion_symbol_table_close(parent)); // The clone shares the parent's owner.
+}
+
+TEST(IonSymbolTable, SystemSymbolTableIsConstantAndShared) {
+    const char *texts[] = {"$ion", "$ion_1_0", "$ion_symbol_table", "name", "version", "imports", "symbols", "max_id",
+                           "$ion_shared_symbol_table"};
+    const char *non_system[] = {"$io", "$ion_", "names", "symbol", "max_ie", "$ion_symbol_tablf"};
+    hSYMTAB system, other_thread_system = NULL;
+    ION_STRING text, *found_text;
+    SID sid;
+
+    ION_ASSERT_OK(ion_symbol_table_get_system_table(&system, 1));
+    std::thread([&other_thread_system]() {
+        ion_symbol_table_get_system_table(&other_thread_system, 1);
+    }).join();
+    ASSERT_EQ(system, other_thread_system);
+
+    for (SID expected = 1; expected <= ION_SYS_SID_SHARED_SYMBOL_TABLE; expected++) {
+        ION_ASSERT_OK(ion_string_from_cstr(texts[expected - 1], &text));
+        ION_ASSERT_OK(ion_symbol_table_find_by_name(system, &text, &sid));
+        ASSERT_EQ(expected, sid) << texts[expected - 1];
+        ION_ASSERT_OK(ion_symbol_table_find_by_sid(system, expected, &found_text));
+        ASSERT_TRUE(ION_STRING_EQUALS(&text, found_text)) << texts[expected - 1];
+    }
+    for (size_t i = 0; i < sizeof(non_system) / sizeof(non_system[0]); i++) {
+        ION_ASSERT_OK(ion_string_from_cstr(non_system[i], &text));
+        ION_ASSERT_OK(ion_symbol_table_find_by_name(system, &text, &sid));
+        ASSERT_EQ(UNKNOWN_SID, sid) << non_system[i];
+    }
+    ION_ASSERT_OK(ion_string_from_cstr("gamma", &text));
+    ASSERT_EQ(IERR_IS_IMMUTABLE, ion_symbol_table_add_symbol(system, &text, &sid));
+}
+
+TEST(IonSymbolTable, ReadersSystemSymbolTableCanBeCloned) {
+    hREADER reader;
+    ION_TYPE type;
+    hSYMTAB system, clone;
+    ION_SYMBOL_TABLE_TYPE clone_type;
+    ION_STRING text, *found_text;
+    SID sid;
+    const char *ion_text = "1";
+
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, (BYTE *)ion_text, (SIZE)strlen(ion_text), NULL));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_get_symbol_table(reader, &system));
+    ION_ASSERT_OK(ion_symbol_table_clone(system, &clone));
+    ASSERT_NE(system, clone);
+    ION_ASSERT_OK(ion_symbol_table_get_type(clone, &clone_type));
+    ASSERT_EQ(ist_SYSTEM, clone_type);
+    ION_ASSERT_OK(ion_string_from_cstr("max_id", &text));
+    ION_ASSERT_OK(ion_symbol_table_find_by_name(clone, &text, &sid));
+    ASSERT_EQ(ION_SYS_SID_MAX_ID, sid);
+    ION_ASSERT_OK(ion_symbol_table_find_by_sid(clone, ION_SYS_SID_SYMBOLS, &found_text));
+    ION_ASSERT_OK(ion_string_from_cstr("symbols", &text));
+    ASSERT_TRUE(ION_STRING_EQUALS(&text, found_text));
+
+    // the clone owns itself and can be closed; the system table can't
+    ION_ASSERT_OK(ion_symbol_table_close(clone));
+    ASSERT_EQ(IERR_INVALID_ARG, ion_symbol_table_close(system));
+    ION_ASSERT_OK(ion_reader_close(reader));
+}
+
 TEST(IonSymbolTable, CanBeRemovedFromCatalog) {
     hCATALOG catalog = NULL;
     ION_SYMBOL_TABLE *imports[2];
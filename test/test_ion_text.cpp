@@ -749,6 +749,53 @@ TEST(IonTextBlob, CanFullyReadBlobUsingPartialReads) {
                        tid_BLOB, 23, "This is a BLOB of text.");
 }
 
+TEST(IonTextBlob, CanReadBlobWithInterleavedWhitespace) {
+    test_full_lob_read("{{ VGhp cyBp\ncyBhIEJMT0Ig\tb2Yg dGV4 dC4 = }}",
+                       tid_BLOB, 23, "This is a BLOB of text.");
+}
+
+TEST(IonTextBlob, RoundTripsBlobsAppendedInUnevenChunks) {
+    // Every length up to a few encoding blocks, appended in chunks that leave 0, 1, or 2 bytes pending.
+    const SIZE max_length = 600;
+    const SIZE chunk_sizes[] = { 1, 2, 7, 200, max_length };
+    BYTE data[max_length], *read_back = (BYTE *)malloc(max_length + 1);
+
+    for (SIZE i = 0; i < max_length; i++) {
+        data[i] = (BYTE)((i * 151 + 7) & 0xFF);
+    }
+    for (size_t c = 0; c < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); c++) {
+        for (SIZE length = 0; length <= max_length; length += (length < 16) ? 1 : 37) {
+            hWRITER writer = NULL;
+            ION_STREAM *ion_stream = NULL;
+            hREADER reader = NULL;
+            BYTE *result;
+            SIZE result_len, lob_size, bytes_read;
+            ION_TYPE type;
+
+            ION_ASSERT_OK(ion_test_new_writer(&writer, &ion_stream, FALSE));
+            ION_ASSERT_OK(ion_writer_start_lob(writer, tid_BLOB));
+            for (SIZE offset = 0; offset < length; offset += chunk_sizes[c]) {
+                SIZE chunk = (length - offset < chunk_sizes[c]) ? length - offset : chunk_sizes[c];
+                ION_ASSERT_OK(ion_writer_append_lob(writer, data + offset, chunk));
+            }
+            ION_ASSERT_OK(ion_writer_finish_lob(writer));
+            ION_ASSERT_OK(ion_test_writer_get_bytes(writer, ion_stream, &result, &result_len));
+
+            ION_ASSERT_OK(ion_reader_open_buffer(&reader, result, result_len, NULL));
+            ION_ASSERT_OK(ion_reader_next(reader, &type));
+            ASSERT_EQ(tid_BLOB, type);
+            ION_ASSERT_OK(ion_reader_get_lob_size(reader, &lob_size));
+            ASSERT_EQ(length, lob_size);
+            ION_ASSERT_OK(ion_reader_read_lob_bytes(reader, read_back, max_length + 1, &bytes_read));
+            ASSERT_EQ(length, bytes_read);
+            ASSERT_EQ(0, memcmp(data, read_back, length)) << "length " << length << ", chunk " << chunk_sizes[c];
+            ION_ASSERT_OK(ion_reader_close(reader));
+            free(result);
+        }
+    }
+    free(read_back);
+}
+
 TEST(IonTextStruct, AcceptsFieldNameWithKeywordPrefix) {
     const char *ion_text = "{falsehood: 123}";
     hREADER  reader;
@@ -1416,6 +1463,89 @@ TEST(IonTextDownconvert, Strings) {
     IONJSON_CMP("\" μ \"", "\" \\u03BC \"");
 }
 
+TEST(IonTextDownconvert, LongStringsEscapedAtAnyOffset) {
+    // Escapable characters at positions inside and across the bulk-scanned blocks.
+    IONJSON_CMP("\"abcdefghijklmnopqrstuvwxyz0123456789\"", "\"abcdefghijklmnopqrstuvwxyz0123456789\"");
+    IONJSON_CMP("\"abcdefghijklmno\\\"pqrstuvwxyz0123456789\"", "\"abcdefghijklmno\\\"pqrstuvwxyz0123456789\"");
+    IONJSON_CMP("\"abcdefghijklmnop\\x01qrstuvwxyz0123456789\"", "\"abcdefghijklmnop\\u0001qrstuvwxyz0123456789\"");
+    IONJSON_CMP("\"abcdefghijklmnopqrstuvwxyz012345678\\t\"", "\"abcdefghijklmnopqrstuvwxyz012345678\\t\"");
+    IONJSON_CMP("\"abcdefghijμklmnopqrstuvwxyz0123456789μ\"", "\"abcdefghij\\u03BCklmnopqrstuvwxyz0123456789\\u03BC\"");
+}
+
+TEST(IonTextString, WriterEscapesLongStringsAtAnyOffset) {
+    hWRITER writer = NULL;
+    ION_STREAM *ion_stream = NULL;
+    BYTE *result;
+    SIZE result_len;
+    ION_STRING str;
+
+    const char *values[] = {
+        "abcdefghijklmnopqrstuvwxyz0123456789",
+        "abcdefghijklmnopqrstuvwxyz\"0123456789",
+        "abcdefghijklmno\npqrstuvwxyz01234567\\",
+        "abcdefghijμklmnopqrstuvwxyz'0123456789\x7f",
+    };
+
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &ion_stream, FALSE));
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        ion_string_from_cstr(values[i], &str);
+        ION_ASSERT_OK(ion_writer_write_string(writer, &str));
+    }
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, ion_stream, &result, &result_len));
+
+    assertStringsEqual(
+        "\"abcdefghijklmnopqrstuvwxyz0123456789\" "
+        "\"abcdefghijklmnopqrstuvwxyz\\\"0123456789\" "
+        "\"abcdefghijklmno\\npqrstuvwxyz01234567\\\\\" "
+        "\"abcdefghijμklmnopqrstuvwxyz'0123456789\x7f\"",
+        (char *)result, result_len);
+
+    free(result);
+}
+
+TEST(IonTextFloat, WriterWritesShortestRoundTripDoubles) {
+    hWRITER writer = NULL;
+    ION_STREAM *ion_stream = NULL;
+    BYTE *result;
+    SIZE result_len;
+    double values[] = { 1.5, 0.1, 0.1 + 0.2, -123.0, 1e-7, 1e100, 5e-324, 1.7976931348623157e308, 2.2250738585072014e-308 };
+
+    ION_ASSERT_OK(ion_test_new_writer(&writer, &ion_stream, FALSE));
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        ION_ASSERT_OK(ion_writer_write_double(writer, values[i]));
+    }
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, ion_stream, &result, &result_len));
+
+    assertStringsEqual(
+        "1.5e0 0.1e0 0.30000000000000004e0 -123e0 1e-7 1e100 5e-324 1.7976931348623157e308 2.2250738585072014e-308",
+        (char *)result, result_len);
+
+    free(result);
+}
+
+TEST(IonTextFloat, ReaderReadsCorrectlyRoundedDoubles) {
+    // Exact, halfway, subnormal, saturating, and too-many-digits inputs.
+    const char *ion_text =
+        "1.5e0 -0e0 0.1e0 1_000.25e-3 9007199254740993e0 2.2250738585072011e-308 4.9406564584124654e-324 "
+        "1.7976931348623157e308 1e400 1e-400 123456789012345678901234567890e-10";
+    double expected[] = {
+        1.5, -0.0, 0.1, 1.00025, 9007199254740992.0, 2.2250738585072011e-308, 4.9406564584124654e-324,
+        1.7976931348623157e308, INFINITY, 0.0, 12345678901234567890.1234567890
+    };
+    hREADER reader;
+    ION_TYPE type;
+    double value;
+
+    ION_ASSERT_OK(ion_test_new_text_reader(ion_text, &reader));
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        ION_ASSERT_OK(ion_reader_next(reader, &type));
+        ASSERT_EQ(tid_FLOAT, type);
+        ION_ASSERT_OK(ion_reader_read_double(reader, &value));
+        ASSERT_EQ(0, memcmp(&expected[i], &value, sizeof(double))) << "value " << i << ": " << value;
+    }
+    ION_ASSERT_OK(ion_reader_close(reader));
+}
+
 TEST(IonTextDownconvert, IntsFloatsAndDecimals) {
     // Integers
     IONJSON_CMP("123456789012345678901", "123456789012345678901");
@@ -1426,8 +1556,14 @@ TEST(IonTextDownconvert, IntsFloatsAndDecimals) {
     IONJSON_CMP("-inf", "null");
     IONJSON_CMP("1.0e0", "1");
     IONJSON_CMP("1.5e0", "1.5");
-    IONJSON_CMP("1e-5", "1e-05");
+    IONJSON_CMP("1e-5", "1e-5");
     IONJSON_CMP("0.1",  "0.1");
+    IONJSON_CMP("0.1e0", "0.1");
+    IONJSON_CMP("0.30000000000000004e0", "0.30000000000000004");
+    IONJSON_CMP("-123456.789e0", "-123456.789");
+    IONJSON_CMP("1e21", "1e+21");
+    IONJSON_CMP("5e-324", "5e-324");
+    IONJSON_CMP("1.7976931348623157e308", "1.7976931348623157e+308");
     IONJSON_CMP("[1.0e0, 1.0e0]", "[1,1]");
 
     // Decimals
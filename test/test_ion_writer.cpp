@@ -18,6 +18,7 @@
 #include "ion_event_stream.h"
 #include "ion_helpers.h"
 #include "ion_test_util.h"
+#include "ion_event_equivalence.h"
 #include <locale.h>
 
 class WriterTest : public ::testing::Test {
@@ -195,3 +196,181 @@ fail:
     }
     ASSERT_EQ(IERR_OK, err);
 }
+
+TEST(WriterReset, ResetBufferContinuesOrRestartsTheSymbolTableContext) {
+    hWRITER writer = NULL;
+    hREADER reader = NULL;
+    ION_WRITER_OPTIONS options;
+    ION_MEMORY_STATS settled, stats;
+    ION_STRING alpha, beta, read;
+    ION_TYPE type;
+    BYTE first[64], second[64], combined[128];
+    SIZE first_length, second_length;
+
+    ion_event_initialize_writer_options(&options);
+    options.output_as_binary = TRUE;
+    ion_string_from_cstr("alpha", &alpha);
+    ion_string_from_cstr("beta", &beta);
+
+    ION_ASSERT_OK(ion_writer_open_buffer(&writer, first, sizeof(first), &options));
+    ION_ASSERT_OK(ion_writer_write_symbol(writer, &alpha));
+    ION_ASSERT_OK(ion_writer_finish(writer, &first_length));
+
+    // Keeping the context, the second message only appends 'beta' to the symbol table.
+    ION_ASSERT_OK(ion_writer_reset_buffer(writer, second, sizeof(second), TRUE));
+    ION_ASSERT_OK(ion_writer_write_symbol(writer, &alpha));
+    ION_ASSERT_OK(ion_writer_write_symbol(writer, &beta));
+    ION_ASSERT_OK(ion_writer_flush(writer, &second_length));
+    ASSERT_NE(0, memcmp(second, ION_VERSION_MARKER, ION_VERSION_MARKER_LENGTH));
+
+    memcpy(combined, first, first_length);
+    memcpy(combined + first_length, second, second_length);
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, combined, first_length + second_length, NULL));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_read_string(reader, &read));
+    ASSERT_TRUE(ION_STRING_EQUALS(&alpha, &read));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_read_string(reader, &read));
+    ASSERT_TRUE(ION_STRING_EQUALS(&alpha, &read));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_read_string(reader, &read));
+    ASSERT_TRUE(ION_STRING_EQUALS(&beta, &read));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ASSERT_EQ(tid_EOF, type);
+    ION_ASSERT_OK(ion_reader_close(reader));
+
+    // Otherwise each message stands alone, and the writer stops allocating once it has warmed up.
+    for (int i = 0; i < 20; i++) {
+        ION_ASSERT_OK(ion_writer_reset_buffer(writer, second, sizeof(second), FALSE));
+        ION_ASSERT_OK(ion_writer_write_symbol(writer, &beta));
+        ION_ASSERT_OK(ion_writer_flush(writer, &second_length));
+        ASSERT_EQ(0, memcmp(second, ION_VERSION_MARKER, ION_VERSION_MARKER_LENGTH));
+
+        ION_ASSERT_OK(ion_writer_get_memory_stats(writer, &stats));
+        if (i == 2) {
+            settled = stats;
+        }
+        else if (i > 2) {
+            ASSERT_EQ(settled.block_count, stats.block_count);
+            ASSERT_EQ(settled.bytes_reserved, stats.bytes_reserved);
+        }
+    }
+    ION_ASSERT_OK(ion_reader_open_buffer(&reader, second, second_length, NULL));
+    ION_ASSERT_OK(ion_reader_next(reader, &type));
+    ION_ASSERT_OK(ion_reader_read_string(reader, &read));
+    ASSERT_TRUE(ION_STRING_EQUALS(&beta, &read));
+    ION_ASSERT_OK(ion_reader_close(reader));
+
+    ION_ASSERT_OK(ion_writer_close(writer));
+}
+
+TEST(WriterReset, ResetWithPendingAnnotationsOrFieldNameFails) {
+    hWRITER writer = NULL;
+    ION_WRITER_OPTIONS options;
+    ION_STRING name;
+    BYTE first[64], second[64];
+    SIZE length;
+
+    ion_event_initialize_writer_options(&options);
+    options.output_as_binary = TRUE;
+    ion_string_from_cstr("name", &name);
+
+    ION_ASSERT_OK(ion_writer_open_buffer(&writer, first, sizeof(first), &options));
+    ION_ASSERT_OK(ion_writer_add_annotation(writer, &name));
+    ASSERT_EQ(IERR_INVALID_STATE, ion_writer_reset_buffer(writer, second, sizeof(second), FALSE));
+    ION_ASSERT_OK(ion_writer_write_int(writer, 1));
+    ION_ASSERT_OK(ion_writer_start_container(writer, tid_STRUCT));
+    ION_ASSERT_OK(ion_writer_write_field_name(writer, &name));
+    ASSERT_NE(IERR_OK, ion_writer_reset_buffer(writer, second, sizeof(second), TRUE));
+    ION_ASSERT_OK(ion_writer_write_int(writer, 2));
+    ION_ASSERT_OK(ion_writer_finish_container(writer));
+
+    // Both values went to the first output, and the writer can still be reset.
+    ION_ASSERT_OK(ion_writer_reset_buffer(writer, second, sizeof(second), FALSE));
+    ION_ASSERT_OK(ion_writer_write_int(writer, 3));
+    ION_ASSERT_OK(ion_writer_flush(writer, &length));
+    ASSERT_EQ(ION_VERSION_MARKER_LENGTH + 2, length);
+    ION_ASSERT_OK(ion_writer_close(writer));
+}
+
+static void test_writer_write_records(ION_WRITER_OPTIONS *options, BOOL prepared, BYTE **out, SIZE *out_length) {
+    hWRITER writer = NULL;
+    ION_STREAM *stream = NULL;
+    const char *names[] = {"id", "name", "record", "extra"};
+    ION_STRING text[4], value;
+    ION_PREPARED_SYMBOL symbols[4];
+    char unique[16];
+
+    ION_ASSERT_OK(ion_stream_open_memory_only(&stream));
+    ION_ASSERT_OK(ion_writer_open(&writer, stream, options));
+    for (int i = 0; i < 4; i++) {
+        ion_string_from_cstr(names[i], &text[i]);
+        ION_ASSERT_OK(ion_writer_prepare_symbol(writer, &text[i], &symbols[i]));
+    }
+    // Each round ends the symbol table context, and the unique symbols exceed max_local_symbol_count if it is set.
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 5; i++) {
+            if (prepared) {
+                ION_ASSERT_OK(ion_writer_add_annotation_prepared(writer, &symbols[2]));
+            }
+            else {
+                ION_ASSERT_OK(ion_writer_add_annotation(writer, &text[2]));
+            }
+            ION_ASSERT_OK(ion_writer_start_container(writer, tid_STRUCT));
+            for (int f = 0; f < 4; f += (i % 2) ? 1 : 3) {
+                if (prepared) {
+                    ION_ASSERT_OK(ion_writer_write_field_name_prepared(writer, &symbols[f]));
+                    ION_ASSERT_OK(ion_writer_add_annotation_prepared(writer, &symbols[3]));
+                }
+                else {
+                    ION_ASSERT_OK(ion_writer_write_field_name(writer, &text[f]));
+                    ION_ASSERT_OK(ion_writer_add_annotation(writer, &text[3]));
+                }
+                snprintf(unique, sizeof(unique), "v%d_%d", round, i);
+                ion_string_from_cstr(unique, &value);
+                ION_ASSERT_OK(ion_writer_write_symbol(writer, &value));
+            }
+            ION_ASSERT_OK(ion_writer_finish_container(writer));
+        }
+        ION_ASSERT_OK(ion_writer_finish(writer, NULL));
+    }
+    ION_ASSERT_OK(ion_test_writer_get_bytes(writer, stream, out, out_length));
+}
+
+TEST(WriterPreparedSymbols, WriteTheSameValuesAsTheirText) {
+    ION_WRITER_OPTIONS options;
+    BYTE *expected, *actual;
+    SIZE expected_length, actual_length;
+
+    for (int variant = 0; variant < 3; variant++) {
+        ion_event_initialize_writer_options(&options);
+        options.output_as_binary = (variant != 2);
+        options.max_local_symbol_count = (variant == 1) ? 2 : 0;
+        test_writer_write_records(&options, FALSE, &expected, &expected_length);
+        test_writer_write_records(&options, TRUE, &actual, &actual_length);
+        // Prepared symbols are added to the table when written, so local SIDs may be numbered differently.
+        IonEventStream expected_stream, actual_stream;
+        ION_ASSERT_OK(ion_event_stream_read_all_from_bytes(expected, expected_length, NULL, &expected_stream));
+        ION_ASSERT_OK(ion_event_stream_read_all_from_bytes(actual, actual_length, NULL, &actual_stream));
+        ASSERT_TRUE(ion_compare_streams(&expected_stream, &actual_stream));
+        free(expected);
+        free(actual);
+    }
+
+    // A prepared symbol belongs to the writer that prepared it.
+    hWRITER first, second;
+    BYTE buffer[64];
+    ION_STRING name;
+    ION_PREPARED_SYMBOL symbol;
+    ion_event_initialize_writer_options(&options);
+    options.output_as_binary = TRUE;
+    ION_ASSERT_OK(ion_writer_open_buffer(&first, buffer, sizeof(buffer), &options));
+    ION_ASSERT_OK(ion_writer_open_buffer(&second, buffer, sizeof(buffer), &options));
+    ion_string_from_cstr("name", &name);
+    ION_ASSERT_OK(ion_writer_prepare_symbol(first, &name, &symbol));
+    ION_ASSERT_OK(ion_writer_start_container(second, tid_STRUCT));
+    ASSERT_EQ(IERR_INVALID_ARG, ion_writer_write_field_name_prepared(second, &symbol));
+    ION_ASSERT_OK(ion_writer_finish_container(second));
+    ION_ASSERT_OK(ion_writer_close(first));
+    ION_ASSERT_OK(ion_writer_close(second));
+}